@@ -2,14 +2,54 @@
 #define CONSOLE_APP_H
 
 #include "logger.h"
-#include "thread_queue.h"
+#include "lane_queue.h"
+#include "flight_recorder.h"
+#include "tsc_clock.h"
 #include <thread>
+#include <future>
+#include <map>
+#include <set>
 
 // Структура для хранения сообщения и его уровня
 struct Log
 {
     std::string msg;
     LogLevel level;
+    uint64_t ticks = 0; // Время постановки в очередь в тактах TscClock (переводится фоновым потоком)
+    uint64_t seq = 0;   // Порядковый номер постановки в очередь, с 1 (история, подтверждения; в записи - set_seq_field)
+    ContextSnapshot context{}; // Контекст потока-источника (выводится потоком записи)
+};
+
+// Действие после записи сообщения полосы
+enum class FlushPolicy
+{
+    NONE,  // Без принудительного сброса
+    FLUSH, // Logger::flush - данные передаются ОС сразу
+    SYNC   // Logger::sync - данные на диске до следующего сообщения
+};
+
+// Параметры полосы очереди (по одной на уровень логирования)
+struct LaneOptions
+{
+    size_t capacity = 0;   // Максимум ожидающих сообщений (0 - без ограничения), лишние отбрасываются
+    unsigned weight = 1;   // Сколько сообщений полосы извлекается за круг
+    FlushPolicy policy = FlushPolicy::NONE;
+};
+
+// Результат подтверждения записи
+enum class TicketResult
+{
+    WRITTEN,  // Пачка с записью передана логгеру и сброшена (при запросе sync - и записана на диск)
+    FILTERED, // Уровень записи ниже уровня логгера: выводить нечего (выдается сразу)
+    DROPPED,  // Запись отброшена переполненной полосой
+    FAILED    // Сброс логгера не удался
+};
+
+// Подтверждение записи (durability ticket): номер записи в очереди и результат
+struct LogTicket
+{
+    uint64_t seq = 0;
+    std::future<TicketResult> done;
 };
 
 // Основной класс консольного приложения
@@ -24,15 +64,51 @@ public:
 
     bool init(); // Инициализация приложения
     void run();  // Основной цикл выполнения
+    size_t run_stream(int fd = 0); // Неинтерактивный режим: чтение сообщений из потока (по умолчанию stdin)
     void close(); // Завершение работы
 
-    // Методы для тестирования
-    void add_test_msg(const std::string& msg, LogLevel level);
+    // Подключение самописца: сообщения попадают в него при постановке в очередь,
+    // поэтому при сбое сохраняются и еще не записанные логгером сообщения
+    void attach_recorder(FlightRecorder* recorder) { flight_recorder = recorder; }
+
+    // Номер постановки в очередь в каждой записи (поле контекста seq: " seq=N" в тексте,
+    // "seq" в JSON). Полосы меняют порядок вывода, а по номеру исходный порядок восстанавливается
+    void set_seq_field(bool value) { seq_field = value; }
+
+    // Настройка полосы уровня (до init). По умолчанию ERROR имеет наибольший вес
+    // и сбрасывается сразу, поэтому не ждет за потоком DEBUG
+    void configure_lane(LogLevel level, const LaneOptions& options);
+    size_t get_dropped(LogLevel level) const { return log_queue.dropped(lane_of(level)); } // Отброшено полосой
+
+    // Запись с подтверждением. Сброс выполняется один раз на пачку записей, поэтому
+    // подтверждения многих записей (например, ERROR для аудита) стоят одного flush/sync
+    LogTicket log_with_ticket(const std::string& msg, LogLevel level, bool sync = false);
+
+    // Барьер: ожидание, пока все записи с номером <= seq переданы логгеру и сброшены.
+    // Ожидающие одновременно потоки разделяют один сброс. false по таймауту или при ошибке
+    bool flush_until(uint64_t seq, std::chrono::milliseconds timeout, bool sync = false);
+
+    uint64_t get_last_seq() const { return next_seq.load() - 1; } // Номер последней поставленной записи
+    uint64_t get_durable_seq();  // Все записи с номером <= результата сброшены
+
+    // Методы для тестирования (возвращает номер записи, 0 - отброшена полосой)
+    uint64_t add_test_msg(const std::string& msg, LogLevel level);
     size_t get_history() const {return log_history.size();} // Получение размера истории
     size_t get_queue_size() const {return log_queue.size();} // Получение размера очереди
 
 private:
     void log_tasks(); // Фоновая задача для обработки логов
+    void write_log(const Log& task, size_t lane); // Запись сообщения и действие полосы
+    uint64_t enqueue(Log task);                 // Номер, самописец и постановка в полосу (0 - отброшено)
+    void capture_context(Log& task) const;      // Контекст потока и номер (для записей, которые будут выведены)
+
+    // Подтверждения записи
+    void mark_written(uint64_t seq);            // Учет записанной (или отброшенной) записи (поток записи)
+    void commit();                              // Публикация записанного и сброс для подтверждений (поток записи)
+    bool flush_to(std::unique_lock<std::mutex>& lock, uint64_t target, bool sync); // Групповой сброс
+    void reject_seq(uint64_t seq);              // Запись отброшена полосой
+    static size_t lane_of(LogLevel level) { return static_cast<size_t>(level); }
+    static bool terminating() { return FlightRecorder::termination_signal() != 0; } // Получен SIGTERM
 
     // Методы пользовательского интерфейса
     void show_menu(); // Отображение меню
@@ -50,11 +126,37 @@ private:
 
     // Члены класса
     std::unique_ptr<Logger> logger; // Указатель на логгер
-    ThreadQueue<Log> log_queue;     // Потокобезопасная очередь сообщений
+    static constexpr size_t LANES = 3; // По одной полосе на LogLevel
+    LaneQueue<Log, LANES> log_queue;   // Потокобезопасная очередь сообщений с полосами
+    FlushPolicy lane_policy[LANES] = {FlushPolicy::NONE, FlushPolicy::NONE, FlushPolicy::FLUSH};
+    std::atomic<uint64_t> next_seq = 1; // Следующий порядковый номер
+
+    // Подтверждения записи (под durable_mutex)
+    struct PendingTicket
+    {
+        std::promise<TicketResult> promise;
+        bool sync;
+    };
+    std::mutex durable_mutex;
+    std::condition_variable durable_condition;
+    uint64_t written_seq = 0;  // Все записи с номером <= written_seq переданы логгеру
+    uint64_t flushed_seq = 0;  // ... и сброшены (flush)
+    uint64_t synced_seq = 0;   // ... и записаны на диск (sync)
+    bool flushing = false;     // Сброс выполняется (остальные ждут его и не повторяют)
+    std::map<uint64_t, PendingTicket> tickets; // Ожидающие подтверждения по номеру записи
+    std::vector<uint64_t> rejected_seqs;       // Отброшенные полосами (считаются записанными)
+
+    // Только поток записи: записи выходят из полос не по порядку номеров
+    uint64_t written_local = 0;      // Непрерывный префикс записанных номеров
+    std::set<uint64_t> written_ahead; // Записанные номера после разрыва
+    size_t uncommitted = 0;           // Записей с последней публикации
     std::vector<std::string> log_history; // История сообщений
     std::atomic<bool> run_flag = false; // Флаг работы приложения (атомарный для потокобезопасности)
+    std::atomic<bool> history_flag = true; // Сохранять ли историю (отключается в потоковом режиме)
+    bool seq_field = false;         // Выводить ли номер записи (задается до init)
     std::thread log_thread;        // Поток для обработки сообщений
     std::string logger_type;        // Тип логгера (для отображения)
+    FlightRecorder* flight_recorder = nullptr; // Самописец (может отсутствовать)
 };
 
 #endif // CONSOLE_APP_H
\ No newline at end of file
@@ -0,0 +1,193 @@
+#ifndef LANE_QUEUE_H
+#define LANE_QUEUE_H
+
+#include <array>
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include "lock_profiler.h"
+
+// Очередь с несколькими полосами (по одной на уровень логирования).
+// У каждой полосы своя емкость (0 - без ограничения) и свой вес: за один круг
+// извлекается до weight элементов полосы, начиная с полосы с наибольшим номером.
+// Поэтому сообщение важной полосы не ждет, пока разберется поток менее важных
+template<typename T, size_t Lanes>
+class LaneQueue
+{
+public:
+    LaneQueue()
+    {
+        for (auto& lane : lanes)
+            lane.credit = lane.weight;
+    }
+    ~LaneQueue() = default;
+
+    LaneQueue(const LaneQueue&) = delete;
+    LaneQueue& operator=(const LaneQueue&) = delete;
+
+    // Емкость и вес полосы (вес не меньше 1)
+    void configure(size_t lane, size_t capacity, unsigned weight)
+    {
+        std::lock_guard<LogMutex> lock(curr_mutex);
+        lanes[lane].capacity = capacity;
+        lanes[lane].weight = weight > 0 ? weight : 1;
+        lanes[lane].credit = lanes[lane].weight;
+    }
+
+    // Добавление; false, если полоса заполнена и элемент отброшен
+    bool push(size_t lane, T value)
+    {
+        std::lock_guard<LogMutex> lock(curr_mutex);
+        if (!push_locked(lanes[lane], std::move(value)))
+            return false;
+        curr_condition.notify_one();
+        return true;
+    }
+
+    // Добавление пачки за один захват мьютекса; полоса элемента - lane_of(value).
+    // Возвращает число отброшенных элементов
+    template<typename LaneOf>
+    size_t push_batch(std::vector<T>& values, LaneOf lane_of)
+    {
+        return push_batch(values, lane_of, [](const T&) {});
+    }
+
+    // То же с обработчиком отброшенных элементов (вызывается под мьютексом очереди)
+    template<typename LaneOf, typename Rejected>
+    size_t push_batch(std::vector<T>& values, LaneOf lane_of, Rejected on_rejected)
+    {
+        if (values.empty())
+            return 0;
+
+        size_t rejected = 0;
+        {
+            std::lock_guard<LogMutex> lock(curr_mutex);
+            for (auto& value : values)
+            {
+                size_t lane = lane_of(value);
+                if (!push_locked(lanes[lane], std::move(value)))
+                {
+                    on_rejected(value);
+                    ++rejected;
+                }
+            }
+        }
+        values.clear();
+        curr_condition.notify_one();
+        return rejected;
+    }
+
+    // Извлечение без ожидания; lane - полоса, из которой взят элемент
+    bool pop(T& value, size_t& lane)
+    {
+        std::lock_guard<LogMutex> lock(curr_mutex);
+        return pop_locked(value, lane);
+    }
+
+    bool pop_with_wait(T& value, size_t& lane)
+    {
+        LogUniqueLock lock(curr_mutex);
+        curr_condition.wait(lock, [this] \
+            {return total > 0 || is_stop;});
+
+        return pop_locked(value, lane);
+    }
+
+    void stop()
+    {
+        std::lock_guard<LogMutex> lock(curr_mutex);
+        is_stop = true;
+        curr_condition.notify_all();
+    }
+
+    bool empty() const
+    {
+        std::lock_guard<LogMutex> lock(curr_mutex);
+        return total == 0;
+    }
+
+    size_t size() const
+    {
+        std::lock_guard<LogMutex> lock(curr_mutex);
+        return total;
+    }
+
+    size_t size(size_t lane) const
+    {
+        std::lock_guard<LogMutex> lock(curr_mutex);
+        return lanes[lane].items.size();
+    }
+
+    // Число элементов, отброшенных из-за заполненной полосы
+    size_t dropped(size_t lane) const
+    {
+        std::lock_guard<LogMutex> lock(curr_mutex);
+        return lanes[lane].dropped;
+    }
+
+    bool is_stopped() const
+    {
+        return is_stop;
+    }
+
+private:
+    struct Lane
+    {
+        std::deque<T> items;
+        size_t capacity = 0;  // 0 - без ограничения
+        unsigned weight = 1;
+        unsigned credit = 1;  // Сколько еще можно извлечь в текущем круге
+        size_t dropped = 0;
+    };
+
+    bool push_locked(Lane& lane, T&& value) // Отброшенный элемент остается в value
+    {
+        if (lane.capacity > 0 && lane.items.size() >= lane.capacity)
+        {
+            ++lane.dropped;
+            return false;
+        }
+        lane.items.push_back(std::move(value));
+        ++total;
+        return true;
+    }
+
+    // Взвешенный обход: непустая полоса с остатком кредита и наибольшим номером.
+    // Когда кредит исчерпан у всех непустых полос, начинается новый круг
+    bool pop_locked(T& value, size_t& lane)
+    {
+        if (total == 0)
+            return false;
+
+        for (int round = 0; round < 2; ++round)
+        {
+            for (size_t i = Lanes; i-- > 0;)
+            {
+                Lane& curr = lanes[i];
+                if (curr.items.empty() || curr.credit == 0)
+                    continue;
+
+                --curr.credit;
+                value = std::move(curr.items.front());
+                curr.items.pop_front();
+                --total;
+                lane = i;
+                return true;
+            }
+
+            for (auto& curr : lanes)
+                curr.credit = curr.weight;
+        }
+        return false;
+    }
+
+    mutable LogMutex curr_mutex{"LaneQueue::curr_mutex"};
+    LogCondition curr_condition;
+    std::array<Lane, Lanes> lanes;
+    size_t total = 0;
+    std::atomic<bool> is_stop = false;
+};
+
+#endif // LANE_QUEUE_H
@@ -0,0 +1,66 @@
+#ifndef LOAD_GENERATOR_H
+#define LOAD_GENERATOR_H
+
+#include "logger.h"
+#include <vector>
+#include <cstdint>
+
+// Параметры воспроизведения журнала
+struct ReplayOptions
+{
+    double speed = 1.0; // Множитель скорости относительно исходной (0 - максимально быстро)
+    int threads = 1;    // Число потоков (записи распределяются по кругу; при speed > 0 каждая ждет своего времени)
+};
+
+// Параметры синтетической нагрузки
+struct GeneratorOptions
+{
+    size_t count = 100000;                 // Общее число сообщений
+    size_t min_size = 32;                  // Минимальная длина сообщения
+    size_t max_size = 128;                 // Максимальная длина сообщения
+    std::vector<unsigned> weights{1, 8, 1}; // Доли уровней DEBUG:INFO:ERROR
+    int threads = 1;                       // Число потоков
+};
+
+// Результат прогона нагрузки
+struct LoadReport
+{
+    size_t sent = 0;     // Отправлено сообщений
+    size_t errors = 0;   // Ошибок логгера
+    double seconds = 0;  // Общее время
+    uint64_t p50 = 0, p90 = 0, p99 = 0, p999 = 0, max = 0; // Задержки вызова log() в нс
+};
+
+// Воспроизведение существующего журнала и генерация синтетической нагрузки
+class LoadGenerator
+{
+public:
+    explicit LoadGenerator(Logger& logger);
+
+    bool load_file(const std::string& file_name); // Загрузка записей журнала FileLogger
+    size_t get_loaded() const { return records.size(); }
+
+    LoadReport replay(const ReplayOptions& options);       // Повторная отправка загруженных записей
+    LoadReport generate(const GeneratorOptions& options);  // Синтетическая нагрузка
+
+    static void print_report(const LoadReport& report);
+
+private:
+    struct Record
+    {
+        int64_t offset_ns; // Смещение от первой записи
+        LogLevel level;
+        std::string msg;
+    };
+
+    // Запуск count отправок на threads потоках; make(i) возвращает i-ю запись
+    template<typename Make>
+    LoadReport run_parallel(size_t count, int threads, Make make);
+
+    static void fill_percentiles(std::vector<uint64_t>& latencies, LoadReport& report);
+
+    Logger& logger;
+    std::vector<Record> records;
+};
+
+#endif // LOAD_GENERATOR_H
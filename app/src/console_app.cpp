@@ -1,11 +1,65 @@
 #include "console_app.h"
 #include <algorithm>
 #include <limits>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <poll.h>
+
+namespace
+{
+    // Разбор необязательного префикса уровня: "[ERROR] msg", "ERROR: msg", "error msg"
+    // Возвращает длину префикса (0, если префикса нет)
+    size_t parse_level_prefix(const char* str, size_t len, LogLevel& level)
+    {
+        static const struct { const char* name; size_t len; LogLevel level; } names[] =
+        {
+            {"DEBUG", 5, LogLevel::DEBUG}, {"debug", 5, LogLevel::DEBUG},
+            {"INFO", 4, LogLevel::INFO},   {"info", 4, LogLevel::INFO},
+            {"ERROR", 5, LogLevel::ERROR}, {"error", 5, LogLevel::ERROR}
+        };
+
+        size_t pos = (len > 0 && str[0] == '[') ? 1 : 0;
+        for (const auto& name : names)
+        {
+            if (len < pos + name.len || std::memcmp(str + pos, name.name, name.len) != 0)
+                continue;
+
+            size_t end = pos + name.len;
+            if (pos == 1)
+            {
+                if (end >= len || str[end] != ']') continue;
+                ++end;
+            }
+            else if (end < len && str[end] == ':')
+                ++end;
+
+            // После префикса должен идти пробел или конец строки
+            if (end < len && str[end] != ' ') continue;
+            while (end < len && str[end] == ' ') ++end;
+
+            level = name.level;
+            return end;
+        }
+        return 0;
+    }
+}
 
 // Конструктор: перемещаем логгер и сохраняем его тип
 ConsoleApp::ConsoleApp(std::unique_ptr<Logger> logger)
     : logger(std::move(logger)), logger_type(this->logger->get_type())
-{}
+{
+    // Веса по умолчанию: на одно DEBUG приходится до 4 INFO и до 16 ERROR
+    log_queue.configure(lane_of(LogLevel::DEBUG), 0, 1);
+    log_queue.configure(lane_of(LogLevel::INFO), 0, 4);
+    log_queue.configure(lane_of(LogLevel::ERROR), 0, 16);
+}
+
+void ConsoleApp::configure_lane(LogLevel level, const LaneOptions& options)
+{
+    log_queue.configure(lane_of(level), options.capacity, options.weight);
+    lane_policy[lane_of(level)] = options.policy;
+}
 
 // Деструктор: закрываем приложение
 ConsoleApp::~ConsoleApp() 
@@ -30,32 +84,223 @@ bool ConsoleApp::init()
 // Фоновая задача для обработки логов из очереди
 void ConsoleApp::log_tasks()
 {
+    const size_t commit_batch = 256; // Публикация записанного не реже, чем раз в столько записей
+
     Log task;
+    size_t lane;
     while(run_flag || !log_queue.empty()) // Работаем пока приложение запущено или есть сообщения
     {
-        if (log_queue.pop_with_wait(task)) // Блокирующее извлечение
+        // Очередь опустела: пачка записана, подтверждения ожидающих выдаются одним сбросом
+        bool ready = log_queue.pop(task, lane);
+        if (!ready)
         {
-            // Отправляем сообщение через логгер
-            LoggerError error = logger->log(task.msg, task.level);
+            commit();
+            ready = log_queue.pop_with_wait(task, lane); // Блокирующее извлечение (с учетом весов полос)
+        }
 
-            // Формируем запись для истории
-            std::stringstream input;
-            input << "[" << level_to_str(task.level) << "] " << task.msg;
-            log_history.push_back(input.str());
+        if (ready)
+        {
+            write_log(task, lane);
+            mark_written(task.seq);
+            if (++uncommitted >= commit_batch)
+                commit();
 
-            if (error != LoggerError::NONE)
-                std::cerr << "Ошибка: " << static_cast<int>(error) << std::endl;
+            // Формируем запись для истории (номер показывает исходный порядок)
+            if (history_flag)
+            {
+                std::stringstream input;
+                input << "#" << task.seq << " [" << level_to_str(task.level) << "] " << task.msg;
+                log_history.push_back(input.str());
+            }
         }
     }
 
     // Обрабатываем оставшиеся сообщения после остановки
-    while(log_queue.pop(task))
+    while(log_queue.pop(task, lane))
+    {
+        write_log(task, lane);
+        mark_written(task.seq);
+    }
+    commit();
+}
+
+// Записи выходят из полос не по порядку номеров: номер после разрыва ждет в written_ahead,
+// пока не будут записаны все предыдущие
+void ConsoleApp::mark_written(uint64_t seq)
+{
+    if (seq != written_local + 1)
+    {
+        written_ahead.insert(seq);
+        return;
+    }
+
+    written_local = seq;
+    while (!written_ahead.empty() && *written_ahead.begin() == written_local + 1)
+    {
+        written_local++;
+        written_ahead.erase(written_ahead.begin());
+    }
+}
+
+// Публикация записанного префикса. Сброс логгера выполняется, только если есть
+// подтверждения для уже записанных записей, поэтому без них поток записи не замедляется
+void ConsoleApp::commit()
+{
+    uncommitted = 0;
+    std::unique_lock<std::mutex> lock(durable_mutex);
+    for (uint64_t seq : rejected_seqs)
+        mark_written(seq);
+    rejected_seqs.clear();
+
+    if (written_local != written_seq)
+    {
+        written_seq = written_local;
+        durable_condition.notify_all(); // Ожидающие flush_until сбрасывают сами
+    }
+
+    bool need = false, sync = false;
+    for (auto it = tickets.begin(); it != tickets.end() && it->first <= written_seq; ++it)
+    {
+        need = true;
+        sync = sync || it->second.sync;
+    }
+    if (need)
+        flush_to(lock, written_seq, sync);
+}
+
+// Сброс логгера до target (под durable_mutex, освобождается на время сброса).
+// Если сброс уже выполняет другой поток, его результат используется повторно
+bool ConsoleApp::flush_to(std::unique_lock<std::mutex>& lock, uint64_t target, bool sync)
+{
+    durable_condition.wait(lock, [this] { return !flushing; });
+    if ((sync ? synced_seq : flushed_seq) >= target)
+        return true;
+
+    flushing = true;
+    lock.unlock();
+    LoggerError error = sync ? logger->sync() : logger->flush();
+    lock.lock();
+    flushing = false;
+
+    if (error == LoggerError::NONE)
+    {
+        flushed_seq = std::max(flushed_seq, target);
+        if (sync)
+            synced_seq = std::max(synced_seq, target);
+    }
+
+    // Выдача подтверждений: при ошибке все записи до target получают false
+    for (auto it = tickets.begin(); it != tickets.end() && it->first <= target;)
+    {
+        bool done = it->second.sync ? synced_seq >= it->first : flushed_seq >= it->first;
+        if (error != LoggerError::NONE || done)
+        {
+            it->second.promise.set_value(error == LoggerError::NONE ? TicketResult::WRITTEN : TicketResult::FAILED);
+            it = tickets.erase(it);
+        }
+        else
+            ++it;
+    }
+
+    durable_condition.notify_all();
+    return error == LoggerError::NONE;
+}
+
+bool ConsoleApp::flush_until(uint64_t seq, std::chrono::milliseconds timeout, bool sync)
+{
+    std::unique_lock<std::mutex> lock(durable_mutex);
+    if (!durable_condition.wait_for(lock, timeout, [&] { return written_seq >= seq; }))
+        return false;
+    return flush_to(lock, written_seq, sync);
+}
+
+uint64_t ConsoleApp::get_durable_seq()
+{
+    std::lock_guard<std::mutex> lock(durable_mutex);
+    return flushed_seq;
+}
+
+// Отброшенная запись не будет записана, но не должна задерживать барьер
+void ConsoleApp::reject_seq(uint64_t seq)
+{
+    std::lock_guard<std::mutex> lock(durable_mutex);
+    rejected_seqs.push_back(seq);
+
+    auto it = tickets.find(seq);
+    if (it != tickets.end())
+    {
+        it->second.promise.set_value(TicketResult::DROPPED);
+        tickets.erase(it);
+    }
+}
+
+LogTicket ConsoleApp::log_with_ticket(const std::string& msg, LogLevel level, bool sync)
+{
+    // Подтверждение регистрируется до постановки в очередь, чтобы поток записи его не пропустил
+    // Запись ниже уровня логгера он не выведет: подтверждение выдается сразу, а сама запись
+    // проходит очередь как обычно (номер не создает разрыва для flush_until)
+    LogTicket ticket;
+    Log task{msg, level, TscClock::now(), next_seq.fetch_add(1, std::memory_order_relaxed)};
+    ticket.seq = task.seq;
+    if (level < logger->get_log_level())
     {
-        LoggerError error = logger->log(task.msg, task.level);
-        if (error != LoggerError::NONE)
-            std::cerr << "Ошибка: " << static_cast<int>(error) << std::endl;
+        std::promise<TicketResult> filtered;
+        ticket.done = filtered.get_future();
+        filtered.set_value(TicketResult::FILTERED);
     }
-}                        
+    else
+    {
+        std::lock_guard<std::mutex> lock(durable_mutex);
+        PendingTicket& pending = tickets[task.seq];
+        pending.sync = sync;
+        ticket.done = pending.promise.get_future();
+    }
+    enqueue(std::move(task));
+    return ticket;
+}
+
+// Отправка сообщения через логгер. Время записи - время постановки в очередь,
+// поэтому исходный порядок восстанавливается сортировкой по времени
+void ConsoleApp::write_log(const Log& task, size_t lane)
+{
+    ContextRestore context(task.context); // Поля контекста потока, поставившего запись
+    LoggerError error = logger->log_at(task.msg, task.level, TscClock::to_time_point(task.ticks));
+    if (error == LoggerError::NONE && task.level >= logger->get_log_level())
+    {
+        if (lane_policy[lane] == FlushPolicy::FLUSH)
+            error = logger->flush();
+        else if (lane_policy[lane] == FlushPolicy::SYNC)
+            error = logger->sync();
+    }
+
+    if (error != LoggerError::NONE)
+        std::cerr << "Ошибка: " << static_cast<int>(error) << std::endl;
+}
+
+// Постановка сообщения в полосу его уровня
+uint64_t ConsoleApp::enqueue(Log task)
+{
+    if (task.seq == 0)
+        task.seq = next_seq.fetch_add(1, std::memory_order_relaxed);
+    if (task.level >= logger->get_log_level())
+        capture_context(task); // Только для записей, которые будут выведены
+    if (flight_recorder)
+        flight_recorder->record(task.msg.data(), task.msg.size(), task.level);
+    uint64_t seq = task.seq;
+    if (!log_queue.push(lane_of(task.level), std::move(task)))
+    {
+        reject_seq(seq);
+        return 0;
+    }
+    return seq;
+}
+
+void ConsoleApp::capture_context(Log& task) const
+{
+    task.context.capture();
+    if (seq_field)
+        task.context.append("seq", std::to_string(task.seq));
+}
 
 // Корректное закрытие приложения
 void ConsoleApp::close()
@@ -64,7 +309,11 @@ void ConsoleApp::close()
     log_queue.stop(); // Останавливаем очередь
     
     if (log_thread.joinable()) 
+    {
         log_thread.join(); // Ждем завершения потока
+        if (logger)
+            logger->flush(); // Записанное доходит до файла и перед завершением по SIGTERM
+    }
 }
 
 // Основной цикл выполнения приложения
@@ -72,12 +321,14 @@ void ConsoleApp::run()
 {
     std::cout << "=== Приложение ===" << std::endl;
 
-    while (run_flag) 
+    while (run_flag && !terminating()) 
     {
         std::cout << "\nТекущий уровень догирования: " << \
         level_to_str(logger->get_log_level()) << std::endl;
         show_menu();
         int choice = get_validated_input(1, 5, "Введите пункт меню: ");
+        if (terminating())
+            break; // SIGTERM: очередь дописывается в close, затем завершение по сигналу
         switch(choice)
         {
             case 1: add_log(); break;
@@ -90,6 +341,108 @@ void ConsoleApp::run()
     }
 }
 
+// Потоковый режим: чтение строк из fd крупными блоками и передача их в очередь пачками
+size_t ConsoleApp::run_stream(int fd)
+{
+    const size_t block_size = 1 << 20; // Размер блока чтения (1 МБ)
+    const size_t batch_size = 4096;    // Размер пачки для очереди
+
+    history_flag = false; // История в потоковом режиме не нужна и только растет
+    std::vector<char> buffer(block_size);
+    std::vector<Log> batch;
+    batch.reserve(batch_size);
+
+    size_t lines = 0, bytes = 0, tail = 0; // tail - длина незавершенной строки в начале буфера
+    auto start = std::chrono::steady_clock::now();
+
+    // Передача пачки в очередь; номера отброшенных полосами записей не задерживают барьер
+    std::vector<uint64_t> rejected;
+    auto push_batch = [&](std::vector<Log>& values)
+    {
+        log_queue.push_batch(values, [](const Log& log) { return lane_of(log.level); },
+                             [&rejected](const Log& log) { rejected.push_back(log.seq); });
+        for (uint64_t seq : rejected)
+            reject_seq(seq);
+        rejected.clear();
+    };
+
+    // Разбор одной строки и добавление ее в пачку
+    auto add_line = [&](const char* str, size_t len)
+    {
+        if (len > 0 && str[len - 1] == '\r') --len;
+
+        LogLevel level = LogLevel::INFO;
+        size_t prefix = parse_level_prefix(str, len, level);
+        if (prefix == len) return; // Пустая строка
+
+        if (flight_recorder)
+            flight_recorder->record(str + prefix, len - prefix, level);
+        batch.push_back(Log{std::string(str + prefix, len - prefix), level, TscClock::now(),
+                            next_seq.fetch_add(1, std::memory_order_relaxed)});
+        if (level >= logger->get_log_level())
+            capture_context(batch.back());
+        ++lines;
+        if (batch.size() >= batch_size)
+            push_batch(batch);
+    };
+
+    // Ожидание данных вместе с self-pipe самописца: SIGTERM прерывает чтение, прочитанное дописывается
+    pollfd fds[2] = {{fd, POLLIN, 0}, {FlightRecorder::termination_fd(), POLLIN, 0}};
+    while (!terminating())
+    {
+        if (poll(fds, 2, -1) < 0 && errno != EINTR)
+        {
+            std::cerr << "Ошибка ожидания ввода: " << std::strerror(errno) << std::endl;
+            break;
+        }
+        if (terminating())
+            break;
+        if (fds[0].revents == 0)
+            continue;
+
+        ssize_t count = read(fd, buffer.data() + tail, buffer.size() - tail);
+        if (count < 0)
+        {
+            if (errno == EINTR) continue;
+            std::cerr << "Ошибка чтения: " << std::strerror(errno) << std::endl;
+            break;
+        }
+        if (count == 0) break; // EOF
+
+        bytes += count;
+        const char* curr = buffer.data();
+        const char* end = buffer.data() + tail + count;
+
+        // Поиск разделителей строк через memchr (векторизован в libc)
+        while (const char* nl = static_cast<const char*>(std::memchr(curr, '\n', end - curr)))
+        {
+            add_line(curr, nl - curr);
+            curr = nl + 1;
+        }
+
+        // Перенос хвоста в начало буфера, расширение буфера для очень длинных строк
+        tail = end - curr;
+        if (tail > 0)
+            std::memmove(buffer.data(), curr, tail);
+        if (tail == buffer.size())
+            buffer.resize(buffer.size() * 2);
+    }
+
+    if (tail > 0)
+        add_line(buffer.data(), tail); // Последняя строка без перевода строки
+    push_batch(batch);
+
+    close(); // Дожидаемся записи всех сообщений
+
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (sec <= 0) sec = 1e-9;
+    std::cout << "Обработано строк: " << lines << ", байт: " << bytes << std::endl;
+    std::cout << "Время: " << std::fixed << std::setprecision(3) << sec << " с, "
+              << static_cast<size_t>(lines / sec) << " строк/с, "
+              << std::setprecision(2) << (bytes / sec / (1024 * 1024)) << " МБ/с" << std::defaultfloat << std::endl;
+    return lines;
+}
+
 // Отображение меню пользователя
 void ConsoleApp::show_menu()
 {
@@ -105,17 +458,22 @@ void ConsoleApp::show_menu()
 void ConsoleApp::add_log() 
 {
     LogLevel level = select_log_level();
+    if (terminating())
+        return;
     
     std::string input;
     std::cout << "Введите сообщение: ";
     getline(std::cin, input);
+    if (terminating())
+        return;
 
     if (validate_msg(input))
     {
         Log curr_log;
         curr_log.msg = input;
         curr_log.level = level;
-        log_queue.push(curr_log); // Добавляем в очередь
+        curr_log.ticks = TscClock::now();
+        enqueue(std::move(curr_log)); // Добавляем в очередь
         std::cout << "Сообщение добавлено в очередь" << std::endl;
     }
     else
@@ -149,6 +507,9 @@ void ConsoleApp::show_status()
     std::cout << "Тип логгера: " << logger_type << std::endl;
     std::cout << "Текущий уровень: " << level_to_str(logger->get_log_level()) << std::endl;
     std::cout << "Ожидают отправки: " << log_queue.size() << std::endl;
+    for (LogLevel level : {LogLevel::DEBUG, LogLevel::INFO, LogLevel::ERROR})
+        std::cout << "  " << level_to_str(level) << ": " << log_queue.size(lane_of(level))
+                  << " (отброшено: " << log_queue.dropped(lane_of(level)) << ")" << std::endl;
     std::cout << "Всего сообщений: " << log_history.size() << std::endl;
 }
 
@@ -187,6 +548,8 @@ int ConsoleApp::get_validated_input(int min, int max, const std::string& str)
             }
         }
 
+        if (terminating())
+            return min - 1; // Чтение прервано SIGTERM
         std::cout << "Некорректный ввод" << std::endl;
         std::cin.clear();
         std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
@@ -212,8 +575,7 @@ std::string ConsoleApp::level_to_str(LogLevel level)
 }
 
 // Добавление тестового сообщения
-void ConsoleApp::add_test_msg(const std::string& msg, LogLevel level)
+uint64_t ConsoleApp::add_test_msg(const std::string& msg, LogLevel level)
 {
-    Log test_log{msg, level};
-    log_queue.push(test_log);
+    return enqueue(Log{msg, level, TscClock::now()});
 }
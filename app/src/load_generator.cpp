@@ -0,0 +1,158 @@
+#include "load_generator.h"
+#include "log_parser.h"
+#include <algorithm>
+#include <random>
+#include <thread>
+
+LoadGenerator::LoadGenerator(Logger& logger)
+    : logger(logger)
+{}
+
+// Загрузка журнала: строки без корректного префикса пропускаются
+bool LoadGenerator::load_file(const std::string& file_name)
+{
+    std::ifstream file(file_name);
+    if (!file.is_open())
+        return false;
+
+    records.clear();
+    std::string line;
+    int64_t first_ns = -1;
+    LogRecord record;
+    while (std::getline(file, line))
+    {
+        if (!parse_log_line(line, record))
+            continue;
+
+        int64_t ns = static_cast<int64_t>(record.time) * 1000000000 + record.nsec;
+        if (first_ns < 0)
+            first_ns = ns;
+        records.push_back(Record{ns - first_ns, record.level, std::string(record.msg)});
+    }
+    return true;
+}
+
+// Общий цикл отправки с замером задержки каждого вызова
+template<typename Make>
+LoadReport LoadGenerator::run_parallel(size_t count, int threads, Make make)
+{
+    if (threads < 1) threads = 1;
+    std::vector<std::vector<uint64_t>> latencies(threads);
+    std::vector<size_t> errors(threads, 0);
+    std::vector<std::thread> workers;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&, t]()
+        {
+            auto& local = latencies[t];
+            local.reserve(count / threads + 1);
+            for (size_t i = t; i < count; i += threads)
+            {
+                const auto& [level, msg] = make(i);
+                auto begin = std::chrono::steady_clock::now();
+                LoggerError error = logger.log(msg, level);
+                auto end = std::chrono::steady_clock::now();
+
+                local.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count());
+                if (error != LoggerError::NONE)
+                    errors[t]++;
+            }
+        });
+    }
+
+    for (auto& worker : workers)
+        worker.join();
+
+    LoadReport report;
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::vector<uint64_t> all;
+    for (int t = 0; t < threads; ++t)
+    {
+        all.insert(all.end(), latencies[t].begin(), latencies[t].end());
+        report.errors += errors[t];
+    }
+    report.sent = all.size();
+    fill_percentiles(all, report);
+    return report;
+}
+
+// Воспроизведение: с исходными интервалами (с учетом множителя) или максимально быстро
+LoadReport LoadGenerator::replay(const ReplayOptions& options)
+{
+    if (options.speed <= 0)
+    {
+        return run_parallel(records.size(), options.threads, [this](size_t i)
+        {
+            return std::pair<LogLevel, const std::string&>(records[i].level, records[i].msg);
+        });
+    }
+
+    // Хронометрированное воспроизведение: каждый поток ждет момента своей записи, поэтому
+    // порядок задается временем; записи с одинаковым временем из разных потоков могут поменяться местами
+    auto start = std::chrono::steady_clock::now();
+    return run_parallel(records.size(), options.threads, [this, start, &options](size_t i)
+    {
+        auto delay = std::chrono::nanoseconds(static_cast<int64_t>(records[i].offset_ns / options.speed));
+        std::this_thread::sleep_until(start + delay);
+        return std::pair<LogLevel, const std::string&>(records[i].level, records[i].msg);
+    });
+}
+
+// Синтетическая нагрузка: случайные длины и уровни по заданным долям
+LoadReport LoadGenerator::generate(const GeneratorOptions& options)
+{
+    // Заранее готовим набор сообщений, чтобы не мерить генерацию строк
+    const size_t pool_size = std::min<size_t>(options.count, 4096);
+    std::vector<std::pair<LogLevel, std::string>> pool;
+    pool.reserve(pool_size);
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<size_t> size_dist(options.min_size, std::max(options.min_size, options.max_size));
+    std::discrete_distribution<int> level_dist(options.weights.begin(), options.weights.end());
+    static const char alphabet[] = "abcdefghijklmnopqrstuvwxyz0123456789 ";
+
+    for (size_t i = 0; i < pool_size; ++i)
+    {
+        std::string msg = "load " + std::to_string(i) + " ";
+        size_t len = size_dist(rng);
+        while (msg.size() < len)
+            msg.push_back(alphabet[rng() % (sizeof(alphabet) - 1)]);
+        msg.resize(std::max<size_t>(len, 1));
+        pool.emplace_back(static_cast<LogLevel>(level_dist(rng)), std::move(msg));
+    }
+
+    return run_parallel(options.count, options.threads, [&pool](size_t i)
+    {
+        const auto& item = pool[i % pool.size()];
+        return std::pair<LogLevel, const std::string&>(item.first, item.second);
+    });
+}
+
+void LoadGenerator::fill_percentiles(std::vector<uint64_t>& latencies, LoadReport& report)
+{
+    if (latencies.empty())
+        return;
+
+    std::sort(latencies.begin(), latencies.end());
+    auto at = [&latencies](double q)
+    {
+        return latencies[std::min(latencies.size() - 1, static_cast<size_t>(q * latencies.size()))];
+    };
+    report.p50 = at(0.50);
+    report.p90 = at(0.90);
+    report.p99 = at(0.99);
+    report.p999 = at(0.999);
+    report.max = latencies.back();
+}
+
+void LoadGenerator::print_report(const LoadReport& report)
+{
+    double sec = report.seconds > 0 ? report.seconds : 1e-9;
+    std::cout << "Отправлено: " << report.sent << ", ошибок: " << report.errors << std::endl;
+    std::cout << "Время: " << std::fixed << std::setprecision(3) << sec << " с, "
+              << static_cast<size_t>(report.sent / sec) << " сообщений/с" << std::defaultfloat << std::endl;
+    std::cout << "Задержка log() (нс): p50=" << report.p50 << " p90=" << report.p90
+              << " p99=" << report.p99 << " p99.9=" << report.p999 << " max=" << report.max << std::endl;
+}
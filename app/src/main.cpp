@@ -1,10 +1,17 @@
 #include "console_app.h"
+#include "load_generator.h"
 #include "logger.h"
-#include "file_logger.h" 
-#include "socket_logger.h" 
+#include "file_logger.h"
+#include "binary_file_logger.h"
+#include "uring_file_logger.h"
+#include "socket_logger.h"
+#include "multi_socket_logger.h"
+#include "log_config.h"
+#include "shm_ring.h"
+#include <csignal>
 
 // Парсинг строки в уровень логирования
-LogLevel parse_log_level(const std::string& level_str) 
+LogLevel parse_log_level(const std::string& level_str)
 {
     if (level_str == "DEBUG" || level_str == "debug") return LogLevel::DEBUG;
     if (level_str == "INFO" || level_str == "info") return LogLevel::INFO;
@@ -19,104 +26,439 @@ void print_rules()
     std::cout << "Формы ввода: " << std::endl;
     std::cout << "  file <filename> [level]      - File logger" << std::endl;
     std::cout << "  socket <host> <port> [level] - Socket logger" << std::endl;
+    std::cout << "  socket <host> <port> [level] --async - подключение в фоне, сообщения ждут в буфере" << std::endl;
+    std::cout << "  sockets <host:port,...> [level] - несколько получателей с переключением при сбое" << std::endl;
+    std::cout << "  binary <filename> [level]    - двоичный файловый логгер (.bin)" << std::endl;
+    std::cout << "  uring <filename> [level]     - асинхронная запись через io_uring (.txt)" << std::endl;
+    std::cout << "  shm </ring> [level]          - кольцо в разделяемой памяти (пишет демон logd)" << std::endl;
+    std::cout << "  config <file.conf>           - приемники и уровни из файла (перечитывается при изменении)" << std::endl;
+    std::cout << "  ... --stdin                  - чтение сообщений из stdin (без меню)" << std::endl;
+    std::cout << "  ... --json                   - вывод file/socket в формате JSON Lines" << std::endl;
+    std::cout << "  ... --tid                    - номер потока-источника в каждой записи" << std::endl;
+    std::cout << "  ... --seq                    - номер постановки в очередь в каждой записи" << std::endl;
+    std::cout << "  ... --staging                - file: буферы потоков и слияние в фоне вместо общего мьютекса" << std::endl;
+    std::cout << "  ... --layout=<pattern>       - шаблон строк file/socket, например \"%d{ISO8601} %t %l %m%X\"" << std::endl;
+    std::cout << "  ... --sync-errors            - fsync после каждого сообщения ERROR" << std::endl;
+    std::cout << "  ... --flight=<file>          - самописец: последние сообщения переживают сбой" << std::endl;
+    std::cout << "  replay <log.txt> [--speed=K|--fast] [--threads=N] <file|socket ...>" << std::endl;
+    std::cout << "                               - воспроизведение журнала через логгер" << std::endl;
+    std::cout << "  generate [--count=N] [--size=MIN:MAX] [--levels=D:I:E] [--threads=N] <file|socket ...>" << std::endl;
+    std::cout << "                               - синтетическая нагрузка" << std::endl;
     std::cout << "Уровни: DEBUG, INFO, ERROR (по умолчанию: INFO)" << std::endl;
 }
 
-int main(int argc, char* argv[])
+// Создание логгера по аргументам, начиная с argv[first] (тип логгера)
+std::unique_ptr<Logger> make_logger(int argc, char* argv[], int first)
 {
-    if (argc < 2)
+    if (first >= argc)
     {
+        std::cerr << "Ошибка: не указан тип логгера" << std::endl;
         print_rules();
-        return 1;
+        return nullptr;
     }
 
-    std::string type = argv[1];
-    std::unique_ptr<Logger> logger;
+    std::string type = argv[first];
+    int params = argc - first; // Число аргументов, включая тип
     LogLevel level = LogLevel::INFO;
 
     // Обработка file logger
     if (type == "file")
     {
-        if (argc < 3)
+        if (params < 2)
         {
             std::cerr << "Ошибка: указаны не все параметры" << std::endl;
             print_rules();
-            return 1;
+            return nullptr;
         }
-        
-        std::string filename = argv[2];
 
-        if (filename.size() < 4 || filename.substr(filename.size() - 4) != ".txt") 
+        std::string filename = argv[first + 1];
+
+        if (filename.size() < 4 || filename.substr(filename.size() - 4) != ".txt")
         {
             std::cerr << "Ошибка: имя файла должно иметь расширение .txt" << std::endl;
-            return 1;
+            return nullptr;
         }
-        
-        if (argc >= 4) 
-            level = parse_log_level(argv[3]);
-        
-        logger = create_file_logger(filename, level);
+
+        if (params >= 3)
+            level = parse_log_level(argv[first + 2]);
+
+        auto logger = create_file_logger(filename, level);
         if (!logger)
-        {
             std::cerr << "Ошибка: не удалось создать логгер " << filename << std::endl;
-            return 1;
+        return logger;
+    }
+    // Обработка двоичного file logger
+    else if (type == "binary")
+    {
+        if (params < 2)
+        {
+            std::cerr << "Ошибка: указаны не все параметры" << std::endl;
+            print_rules();
+            return nullptr;
+        }
+
+        std::string filename = argv[first + 1];
+        if (filename.size() < 4 || filename.substr(filename.size() - 4) != ".bin")
+        {
+            std::cerr << "Ошибка: имя файла должно иметь расширение .bin" << std::endl;
+            return nullptr;
         }
+
+        if (params >= 3)
+            level = parse_log_level(argv[first + 2]);
+
+        return create_binary_file_logger(filename, level);
+    }
+    // Асинхронная запись через io_uring (без поддержки ядра - pwrite из фонового потока)
+    else if (type == "uring")
+    {
+        if (params < 2)
+        {
+            std::cerr << "Ошибка: указаны не все параметры" << std::endl;
+            print_rules();
+            return nullptr;
+        }
+
+        std::string filename = argv[first + 1];
+        if (filename.size() < 4 || filename.substr(filename.size() - 4) != ".txt")
+        {
+            std::cerr << "Ошибка: имя файла должно иметь расширение .txt" << std::endl;
+            return nullptr;
+        }
+
+        if (params >= 3)
+            level = parse_log_level(argv[first + 2]);
+
+        auto logger = create_uring_file_logger(filename, level);
+        if (!logger)
+            std::cerr << "Ошибка: не удалось создать логгер " << filename << std::endl;
+        return logger;
     }
     // Обработка socket logger
     else if (type == "socket")
     {
-        if (argc < 4)
+        // --async: запуск без ожидания сервера, подключение в фоне
+        bool async = params >= 4 && std::string(argv[first + params - 1]) == "--async";
+        if (async)
+            --params;
+
+        if (params < 3)
         {
             std::cerr << "Ошибка: указаны не все параметры" << std::endl;
             print_rules();
-            return 1;
+            return nullptr;
         }
-        
-        std::string host = argv[2];
-        int port = std::atoi(argv[3]);
-        if (port <= 0 || port > 65535) 
+
+        std::string host = argv[first + 1];
+        int port = std::atoi(argv[first + 2]);
+        if (port <= 0 || port > 65535)
         {
             std::cerr << "Ошибка: некорректный порт" << std::endl;
-            return 1;
+            return nullptr;
         }
-        
-        if (argc >= 5) 
-            level = parse_log_level(argv[4]);
-        
+
+        if (params >= 4)
+            level = parse_log_level(argv[first + 3]);
+
         auto socket_logger = std::make_unique<SocketLogger>(host, port, level);
-        LoggerError init_result = socket_logger->init();
-        
-        if (init_result != LoggerError::NONE) 
+        LoggerError init_result = async ? socket_logger->start_async() : socket_logger->init();
+
+        if (init_result != LoggerError::NONE)
         {
-            std::cerr << "Ошибка: не удалось создать логгер (" 
+            std::cerr << "Ошибка: не удалось создать логгер ("
                       << static_cast<int>(init_result) << ")" << std::endl;
+            return nullptr;
+        }
+
+        return socket_logger;
+    }
+    // Несколько получателей: пул соединений с переключением при сбое
+    else if (type == "sockets")
+    {
+        if (params < 2)
+        {
+            std::cerr << "Ошибка: указаны не все параметры" << std::endl;
+            print_rules();
+            return nullptr;
+        }
+
+        auto endpoints = parse_endpoints(argv[first + 1]);
+        if (endpoints.empty())
+        {
+            std::cerr << "Ошибка: некорректный список получателей" << std::endl;
+            return nullptr;
+        }
+
+        if (params >= 3)
+            level = parse_log_level(argv[first + 2]);
+
+        auto multi_logger = create_multi_socket_logger(endpoints, level);
+        if (!multi_logger)
+            std::cerr << "Ошибка: нет доступных получателей" << std::endl;
+        return multi_logger;
+    }
+
+    // Кольцо в разделяемой памяти, которое читает демон logd
+    else if (type == "shm")
+    {
+        if (params < 2)
+        {
+            std::cerr << "Ошибка: указаны не все параметры" << std::endl;
+            print_rules();
+            return nullptr;
+        }
+
+        if (params >= 3)
+            level = parse_log_level(argv[first + 2]);
+
+        auto logger = create_shm_logger(argv[first + 1], level);
+        if (!logger)
+            std::cerr << "Ошибка: не удалось открыть кольцо " << argv[first + 1] << std::endl;
+        return logger;
+    }
+    // Логгер по файлу конфигурации
+    else if (type == "config")
+    {
+        if (params < 2)
+        {
+            std::cerr << "Ошибка: указаны не все параметры" << std::endl;
+            print_rules();
+            return nullptr;
+        }
+
+        auto logger = create_config_logger(argv[first + 1]);
+        if (!logger)
+            std::cerr << "Ошибка: не удалось применить конфигурацию " << argv[first + 1] << std::endl;
+        return logger;
+    }
+
+    std::cerr << "Ошибка: неизвестный тип логгера" << std::endl;
+    print_rules();
+    return nullptr;
+}
+
+// Разбор опции вида --name=value; возвращает false, если аргумент не эта опция
+bool parse_option(const std::string& arg, const std::string& name, std::string& value)
+{
+    std::string prefix = "--" + name + "=";
+    if (arg.compare(0, prefix.size(), prefix) != 0)
+        return false;
+
+    value = arg.substr(prefix.size());
+    return true;
+}
+
+// Подкоманды replay и generate: опции, затем описание логгера
+int run_load(int argc, char* argv[])
+{
+    std::string command = argv[1];
+    ReplayOptions replay_options;
+    GeneratorOptions generator_options;
+    std::string source;
+    int pos = 2;
+
+    if (command == "replay")
+    {
+        if (argc < 3)
+        {
+            print_rules();
             return 1;
         }
-        
-        logger = std::move(socket_logger);
+        source = argv[pos++];
+    }
+
+    // Разбор опций до описания логгера
+    for (; pos < argc && std::string(argv[pos]).compare(0, 2, "--") == 0; ++pos)
+    {
+        std::string arg = argv[pos], value;
+        if (arg == "--fast")
+            replay_options.speed = 0;
+        else if (parse_option(arg, "speed", value))
+            replay_options.speed = std::atof(value.c_str());
+        else if (parse_option(arg, "threads", value))
+            replay_options.threads = generator_options.threads = std::max(1, std::atoi(value.c_str()));
+        else if (parse_option(arg, "count", value))
+            generator_options.count = std::strtoull(value.c_str(), nullptr, 10);
+        else if (parse_option(arg, "size", value))
+        {
+            generator_options.min_size = std::strtoull(value.c_str(), nullptr, 10);
+            size_t sep = value.find(':');
+            generator_options.max_size = sep == std::string::npos ? generator_options.min_size
+                : std::strtoull(value.c_str() + sep + 1, nullptr, 10);
+        }
+        else if (parse_option(arg, "levels", value))
+        {
+            std::vector<unsigned> weights;
+            std::stringstream ss(value);
+            std::string part;
+            while (std::getline(ss, part, ':'))
+                weights.push_back(std::atoi(part.c_str()));
+            if (weights.size() != 3)
+            {
+                std::cerr << "Ошибка: доли уровней задаются как D:I:E" << std::endl;
+                return 1;
+            }
+            generator_options.weights = weights;
+        }
+        else
+        {
+            std::cerr << "Ошибка: неизвестная опция " << arg << std::endl;
+            print_rules();
+            return 1;
+        }
+    }
+
+    auto logger = make_logger(argc, argv, pos);
+    if (!logger)
+        return 1;
+
+    LoadGenerator generator(*logger);
+    LoadReport report;
+    if (command == "replay")
+    {
+        if (!generator.load_file(source))
+        {
+            std::cerr << "Ошибка: не удалось открыть " << source << std::endl;
+            return 1;
+        }
+        std::cout << "Загружено записей: " << generator.get_loaded() << std::endl;
+        report = generator.replay(replay_options);
     }
     else
+        report = generator.generate(generator_options);
+
+    LoadGenerator::print_report(report);
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
     {
-        std::cerr << "Ошибка: неизвестный тип логгера" << std::endl;
         print_rules();
         return 1;
     }
 
-    if (!logger)
+    std::string command = argv[1];
+    if (command == "replay" || command == "generate")
+        return run_load(argc, argv);
+
+    // Флаги в конце командной строки: --stdin (потоковый режим), --json, --tid, --seq, --sync-errors,
+    // --staging, --flight=<file> (самописец) и --layout=<pattern> (шаблон текстовых строк)
+    bool stdin_mode = false, sync_errors = false, json = false, staging = false, seq_field = false;
+    std::string flight_file, layout_pattern;
+    while (argc > 2)
     {
-        std::cerr << "Ошибка: не удалось создать логгер" << std::endl;
+        std::string arg = argv[argc - 1];
+        if (arg == "--stdin")
+            stdin_mode = true;
+        else if (arg == "--sync-errors")
+            sync_errors = true;
+        else if (arg == "--json")
+            json = true;
+        else if (arg == "--tid")
+            LogContext::set_thread_ids(true);
+        else if (arg == "--staging")
+            staging = true;
+        else if (arg == "--seq")
+            seq_field = true;
+        else if (!parse_option(arg, "flight", flight_file) && !parse_option(arg, "layout", layout_pattern))
+            break;
+        --argc;
+    }
+
+    // SIGTERM блокируется на время создания потоков логгера и приложения: они наследуют маску,
+    // и сигнал получает основной поток, чье чтение ввода он прерывает
+    sigset_t term_set;
+    sigemptyset(&term_set);
+    sigaddset(&term_set, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &term_set, nullptr);
+
+    std::unique_ptr<Logger> logger = make_logger(argc, argv, 1);
+    if (!logger)
         return 1;
+
+    if (json)
+    {
+        if (auto* file_logger = dynamic_cast<FileLogger*>(logger.get()))
+            file_logger->set_format(LogFormat::JSON);
+        else if (auto* socket_logger = dynamic_cast<SocketLogger*>(logger.get()))
+            socket_logger->set_format(LogFormat::JSON);
+        else if (auto* multi_logger = dynamic_cast<MultiSocketLogger*>(logger.get()))
+            multi_logger->set_format(LogFormat::JSON);
+        else if (auto* uring_logger = dynamic_cast<UringFileLogger*>(logger.get()))
+            uring_logger->set_format(LogFormat::JSON);
+        else
+        {
+            std::cerr << "Ошибка: --json поддерживается только для file и socket" << std::endl;
+            return 1;
+        }
+    }
+
+    if (staging)
+    {
+        auto* file_logger = dynamic_cast<FileLogger*>(logger.get());
+        if (!file_logger || file_logger->enable_staging() != LoggerError::NONE)
+        {
+            std::cerr << "Ошибка: --staging поддерживается только для file" << std::endl;
+            return 1;
+        }
+    }
+
+    if (!layout_pattern.empty())
+    {
+        std::string reason;
+        std::unique_ptr<PatternLayout> layout = PatternLayout::compile(layout_pattern, "app", &reason);
+        if (!layout)
+        {
+            std::cerr << "Ошибка: некорректный шаблон " << layout_pattern << ": " << reason << std::endl;
+            return 1;
+        }
+        if (auto* file_logger = dynamic_cast<FileLogger*>(logger.get()))
+            file_logger->set_layout(std::move(layout));
+        else if (auto* socket_logger = dynamic_cast<SocketLogger*>(logger.get()))
+            socket_logger->set_layout(std::move(layout));
+        else if (auto* multi_logger = dynamic_cast<MultiSocketLogger*>(logger.get()))
+            multi_logger->set_layout(*layout);
+        else if (auto* uring_logger = dynamic_cast<UringFileLogger*>(logger.get()))
+            uring_logger->set_layout(std::move(layout));
+        else
+        {
+            std::cerr << "Ошибка: --layout поддерживается только для file и socket" << std::endl;
+            return 1;
+        }
+    }
+
+    std::unique_ptr<FlightRecorder> recorder;
+    if (!flight_file.empty())
+    {
+        recorder = create_flight_recorder(flight_file);
+        if (!recorder)
+        {
+            std::cerr << "Ошибка: не удалось открыть самописец " << flight_file << std::endl;
+            return 1;
+        }
+        FlightRecorder::install_signal_handlers(recorder.get());
     }
 
     // Создание и запуск приложения
     ConsoleApp app(std::move(logger));
+    app.attach_recorder(recorder.get());
+    app.set_seq_field(seq_field);
+    if (sync_errors)
+        app.configure_lane(LogLevel::ERROR, LaneOptions{0, 16, FlushPolicy::SYNC});
     if (!app.init())
     {
         std::cerr << "Ошибка: не удалось создать приложение" << std::endl;
         return 1;
     }
+    pthread_sigmask(SIG_UNBLOCK, &term_set, nullptr);
 
-    app.run();
+    if (stdin_mode)
+        app.run_stream();
+    else
+        app.run();
     app.close();
+    FlightRecorder::finish_termination(); // После SIGTERM - завершение по сигналу, когда очередь записана
     return 0;
-}
\ No newline at end of file
+}
@@ -1,9 +1,12 @@
 #include "console_app.h"
 #include "logger.h"
 #include "file_logger.h" 
+#include "load_generator.h"
 #include <filesystem>
 #include <vector>
+#include <algorithm>
 #include <atomic>
+#include <unistd.h>
 
 namespace fs = std::filesystem;
 
@@ -23,7 +26,12 @@ void clean()
         "test_thread.log",
         "test_history.log",
         "test_input.log",
-        "test_close.log"
+        "test_close.log",
+        "test_stream.log",
+        "test_replay_src.log",
+        "test_replay_dst.log",
+        "test_lanes.log",
+        "test_tickets.log"
     };   
 
     for (const auto& file : files) 
@@ -214,6 +222,154 @@ bool test_app_close()
     return lines == msg_cnt;
 }
 
+// Тест потокового режима (чтение из pipe с префиксами уровней)
+bool test_app_stream()
+{
+    auto logger = create_file_logger("test_stream.log", LogLevel::INFO);
+    ConsoleApp app(std::move(logger));
+
+    if (!app.init()) return false;
+
+    int fds[2];
+    if (pipe(fds) != 0) return false;
+
+    std::string input = "[ERROR] stream error\ndebug skipped\n\nplain line\nINFO: last line";
+    write(fds[1], input.data(), input.size());
+    ::close(fds[1]);
+
+    size_t lines = app.run_stream(fds[0]);
+    ::close(fds[0]);
+
+    std::ifstream file("test_stream.log");
+    std::string line;
+    int count = 0;
+    bool has_error = false, has_debug = false;
+    while (std::getline(file, line))
+    {
+        count++;
+        if (line.find("[ERROR] stream error") != std::string::npos) has_error = true;
+        if (line.find("skipped") != std::string::npos) has_debug = true;
+    }
+
+    return lines == 4 && count == 3 && has_error && !has_debug;
+}
+
+// Тест приоритетных полос: ERROR обгоняет накопившиеся DEBUG, полоса DEBUG ограничена
+bool test_app_lanes()
+{
+    auto logger = create_file_logger("test_lanes.log", LogLevel::DEBUG);
+    ConsoleApp app(std::move(logger));
+    app.configure_lane(LogLevel::DEBUG, LaneOptions{1000, 1, FlushPolicy::NONE});
+    app.configure_lane(LogLevel::ERROR, LaneOptions{0, 16, FlushPolicy::SYNC});
+    app.set_seq_field(true);
+
+    // Сообщения копятся до запуска фонового потока
+    for (int i = 0; i < 5000; ++i)
+        app.add_test_msg("debug " + std::to_string(i), LogLevel::DEBUG);
+    app.add_test_msg("urgent", LogLevel::ERROR);
+    bool dropped = app.get_dropped(LogLevel::DEBUG) == 4000 && app.get_dropped(LogLevel::ERROR) == 0;
+
+    if (!app.init()) return false;
+    app.close();
+
+    std::ifstream file("test_lanes.log");
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(file, line))
+        lines.push_back(line);
+
+    // ERROR записано первым, но по времени и номеру постановки в очередь остается последним
+    return dropped && lines.size() == 1001 && lines[0].find("[ERROR] urgent seq=5001") != std::string::npos &&
+           lines[0].substr(0, 31) >= lines.back().substr(0, 31) &&
+           lines[1].find("[DEBUG] debug 0 seq=1") != std::string::npos;
+}
+
+// Тест воспроизведения журнала и генератора нагрузки
+bool test_app_replay()
+{
+    {
+        auto source = create_file_logger("test_replay_src.log", LogLevel::DEBUG);
+        source->log("first", LogLevel::DEBUG);
+        source->log("second", LogLevel::ERROR);
+        source->log("third", LogLevel::INFO);
+    }
+
+    auto logger = create_file_logger("test_replay_dst.log", LogLevel::DEBUG);
+    LoadGenerator generator(*logger);
+    if (!generator.load_file("test_replay_src.log") || generator.get_loaded() != 3)
+        return false;
+
+    ReplayOptions options;
+    options.speed = 0;
+    options.threads = 2;
+    LoadReport replayed = generator.replay(options);
+
+    // Хронометрированное воспроизведение тоже распределяется по потокам
+    options.speed = 1000;
+    LoadReport timed = generator.replay(options);
+
+    GeneratorOptions generator_options;
+    generator_options.count = 50;
+    LoadReport generated = generator.generate(generator_options);
+
+    std::ifstream file("test_replay_dst.log");
+    std::string line;
+    int lines = 0;
+    bool has_error = false;
+    while (std::getline(file, line))
+    {
+        lines++;
+        if (line.find("[ERROR] second") != std::string::npos) has_error = true;
+    }
+
+    return replayed.sent == 3 && timed.sent == 3 && timed.errors == 0 && generated.sent == 50 &&
+           lines == 56 && has_error;
+}
+
+// Тест: Подтверждения записи - ticket, барьер flush_until, отброшенные полосой и фильтром уровня записи
+bool test_app_tickets()
+{
+    auto logger = create_file_logger("test_tickets.log", LogLevel::DEBUG);
+    Logger* sink = logger.get();
+    ConsoleApp app(std::move(logger));
+    app.configure_lane(LogLevel::DEBUG, LaneOptions{100, 1, FlushPolicy::NONE});
+
+    // До запуска потока полоса DEBUG переполняется; подтверждение отброшенной записи - DROPPED
+    for (int i = 0; i < 300; ++i)
+        app.add_test_msg("debug " + std::to_string(i), LogLevel::DEBUG);
+    LogTicket lost = app.log_with_ticket("lost", LogLevel::DEBUG);
+    bool rejected = lost.done.wait_for(std::chrono::seconds(0)) == std::future_status::ready &&
+                    lost.done.get() == TicketResult::DROPPED;
+
+    LogTicket audit = app.log_with_ticket("audit", LogLevel::ERROR, true);
+    if (!app.init()) return false;
+    bool confirmed = audit.done.wait_for(std::chrono::seconds(2)) == std::future_status::ready &&
+                     audit.done.get() == TicketResult::WRITTEN;
+
+    // Запись ниже уровня логгера: подтверждение FILTERED сразу, без ожидания сброса
+    sink->set_log_level(LogLevel::INFO);
+    LogTicket skipped = app.log_with_ticket("skipped", LogLevel::DEBUG);
+    bool filtered = skipped.done.wait_for(std::chrono::seconds(0)) == std::future_status::ready &&
+                    skipped.done.get() == TicketResult::FILTERED;
+
+    // Барьер по последней записи, включая отброшенные номера
+    uint64_t last = app.add_test_msg("last", LogLevel::INFO);
+    bool barrier = last == app.get_last_seq() && app.flush_until(last, std::chrono::seconds(2)) &&
+                   app.get_durable_seq() >= last;
+    bool timeout = !app.flush_until(last + 1, std::chrono::milliseconds(20)); // Такой записи еще нет
+
+    std::ifstream file("test_tickets.log");
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(file, line))
+        lines.push_back(line);
+    app.close();
+
+    return rejected && confirmed && filtered && barrier && timeout && lines.size() == 102 &&
+           std::count_if(lines.begin(), lines.end(),
+                         [](const std::string& l) { return l.find("[ERROR] audit") != std::string::npos; }) == 1;
+}
+
 int main()
 {
     std::cout << "Тесты ConsoleApp: " << std::endl;
@@ -225,6 +381,10 @@ int main()
     print("История сообщений", test_app_history());
     print("Обработка ошибок", test_app_invalid_input());
     print("Корректное закрытие", test_app_close());
+    print("Потоковый режим", test_app_stream());
+    print("Воспроизведение журнала", test_app_replay());
+    print("Приоритетные полосы", test_app_lanes());
+    print("Подтверждения записи", test_app_tickets());
 
     clean();
     return 0;
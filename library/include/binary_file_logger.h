@@ -0,0 +1,53 @@
+#ifndef BINARY_FILE_LOGGER_H
+#define BINARY_FILE_LOGGER_H
+
+#include "logger.h"
+#include <atomic>
+#include "binary_log.h"
+#include "file_logger.h"
+
+// Файловый логгер в компактном двоичном формате (см. binary_log.h)
+// Время хранится в наносекундах разностями, уровень - в байте тега,
+// повторяющиеся шаблоны сообщений - ссылками на словарь
+class BinaryFileLogger : public Logger
+{
+public:
+    BinaryFileLogger(const std::string& file_name, LogLevel level = LogLevel::INFO, bool use_dictionary = true);
+    ~BinaryFileLogger();
+
+    // Запрещаем копирование
+    BinaryFileLogger(const BinaryFileLogger&) = delete;
+    BinaryFileLogger& operator=(const BinaryFileLogger&) = delete;
+
+    // Реализация виртуальных методов
+    LoggerError log(const std::string& msg, LogLevel level) override;
+    LoggerError log_at(const std::string& msg, LogLevel level, std::chrono::system_clock::time_point time) override;
+    std::string get_type() const override { return "binary"; }
+    LoggerError flush() override;
+    LoggerError sync() override;
+
+    // Установка и получение уровня логирования
+    void set_log_level(LogLevel level) override
+    {
+        log_level.store(level, std::memory_order_relaxed);
+    }
+
+    LogLevel get_log_level() const override
+    {
+        return log_level.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::string name;           // Имя файла
+    std::ofstream log_file;     // Файловый поток для записи
+    SyncHandle sync_handle;     // Дескриптор того же файла для sync (под log_mutex)
+    std::atomic<LogLevel> log_level; // Текущий уровень логирования (меняется из другого потока)
+    std::mutex log_mutex;       // Мьютекс для потокобезопасности
+    BinaryLogEncoder encoder;   // Состояние кодировщика (время и словарь)
+    std::string buffer;         // Переиспользуемый буфер записи
+};
+
+// Фабричная функция для создания двоичного файлового логгера
+std::unique_ptr<Logger> create_binary_file_logger(const std::string& file_name, LogLevel level = LogLevel::INFO);
+
+#endif // BINARY_FILE_LOGGER_H
@@ -0,0 +1,73 @@
+#ifndef BINARY_LOG_H
+#define BINARY_LOG_H
+
+#include "logger.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Сигнатура сегмента двоичного журнала (за ней следует 8 байт базового времени в нс)
+constexpr char BINARY_LOG_MAGIC[8] = {'L', 'O', 'G', 'B', 'I', 'N', '1', '\n'};
+
+// Формат записи:
+//   байт тега: биты 0-1 - уровень, биты 2-3 - вид сообщения
+//   varint (zigzag) - разница времени с предыдущей записью в нс
+//   литерал: varint длина + байты
+//   шаблон:  [новый: varint длина + байты шаблона] varint id, затем varint числовые аргументы
+// Шаблон - сообщение, в котором числа заменены на '\0' ("user 15 login" -> "user \0 login")
+enum class BinaryMsgKind : uint8_t
+{
+    LITERAL = 0,       // Сообщение целиком
+    TEMPLATE = 1,      // Ссылка на ранее переданный шаблон
+    NEW_TEMPLATE = 2   // Новый шаблон (добавляется в словарь)
+};
+
+// Запись двоичного журнала после декодирования
+struct BinaryLogRecord
+{
+    int64_t time_ns = 0; // Время (нс от эпохи)
+    LogLevel level = LogLevel::INFO;
+    std::string msg;
+};
+
+// Кодировщик: хранит состояние сегмента (время предыдущей записи и словарь шаблонов)
+class BinaryLogEncoder
+{
+public:
+    explicit BinaryLogEncoder(bool use_dictionary = true);
+
+    void begin_segment(std::string& out, int64_t base_ns);  // Заголовок сегмента, сброс словаря
+    void encode(std::string& out, int64_t time_ns, LogLevel level, const std::string& msg);
+
+private:
+    bool use_dictionary;
+    int64_t last_ns = 0;
+    std::unordered_map<std::string, uint32_t> dictionary; // Шаблон -> id
+    std::string pattern;         // Буфер шаблона текущего сообщения
+    std::vector<uint64_t> args;  // Числовые аргументы текущего сообщения
+};
+
+// Потоковый декодер: читает сегменты подряд, словарь сбрасывается в начале каждого сегмента
+class BinaryLogDecoder
+{
+public:
+    explicit BinaryLogDecoder(std::istream& in);
+
+    bool next(BinaryLogRecord& record); // false - конец данных или ошибка формата
+    bool failed() const { return error; }
+
+private:
+    bool read_varint(uint64_t& value);
+    bool read_segment_header();
+
+    std::istream& in;
+    int64_t last_ns = 0;
+    bool error = false;
+    bool in_segment = false;
+    std::vector<std::string> dictionary; // id -> шаблон
+};
+
+// Разбиение сообщения на шаблон и числовые аргументы; false, если шаблонизировать нечего
+bool split_template(const std::string& msg, std::string& pattern, std::vector<uint64_t>& args);
+
+#endif // BINARY_LOG_H
@@ -0,0 +1,76 @@
+#ifndef BLOCK_CODEC_H
+#define BLOCK_CODEC_H
+
+#include <string>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// Блочное сжатие класса LZ4 (собственная реализация, без сторонних библиотек)
+//
+// Поток состоит из независимых блоков; заголовок блока (12 байт, little-endian):
+//   сигнатура BLOCK_MAGIC, размер исходных данных (старший бит - блок хранится без сжатия),
+//   размер полезной нагрузки. Сигнатура позволяет начать чтение с любого места потока.
+constexpr uint32_t BLOCK_MAGIC = 0x31425A4C; // "LZB1"
+constexpr size_t BLOCK_HEADER_SIZE = 12;
+constexpr size_t MAX_BLOCK_SIZE = 4 << 20;   // Максимальный размер исходного блока
+
+// Сжатие данных в формате последовательностей LZ4 (результат дописывается в out)
+void lz_compress(const char* data, size_t size, std::string& out);
+
+// Распаковка ровно raw_size байт; false при поврежденных данных
+bool lz_decompress(const char* data, size_t size, char* out, size_t raw_size);
+
+// Сжатие и оформление одного блока с заголовком
+void compress_block(const char* data, size_t size, std::string& out);
+
+// Распаковка одного блока, начинающегося в pos; pos сдвигается за блок
+bool decompress_block(const char* data, size_t size, size_t& pos, std::string& out);
+
+// Поиск ближайшего заголовка блока, начиная с pos (size - если не найден)
+size_t find_block(const char* data, size_t size, size_t pos);
+
+// Потоковый компрессор: данные копятся в блок, сжатие и запись выполняются фоновым потоком
+class BlockCompressor
+{
+public:
+    using Writer = std::function<bool(const char* data, size_t size)>;
+
+    BlockCompressor(Writer writer, size_t block_size = 64 * 1024,
+                    std::chrono::milliseconds flush_interval = std::chrono::milliseconds(1000));
+    ~BlockCompressor(); // Дописывает все накопленные данные
+
+    BlockCompressor(const BlockCompressor&) = delete;
+    BlockCompressor& operator=(const BlockCompressor&) = delete;
+
+    void append(const char* data, size_t size); // Добавление данных (без сжатия в вызывающем потоке)
+    void flush();                               // Закрыть текущий блок и дождаться его записи
+    bool failed() const { return write_failed; }
+
+private:
+    void seal();   // Перенос текущего блока в очередь (под мьютексом)
+    void worker(); // Фоновое сжатие и запись
+
+    Writer writer;
+    size_t block_size;
+    std::chrono::milliseconds flush_interval;
+
+    std::mutex mutex;
+    std::condition_variable condition;   // Появились блоки для записи или пора остановиться
+    std::condition_variable written;     // Блок записан (для flush)
+    std::string current;                 // Заполняемый блок
+    std::chrono::steady_clock::time_point current_start; // Время первой записи в блок
+    std::deque<std::string> sealed;      // Закрытые блоки, ожидающие сжатия
+    uint64_t sealed_count = 0;           // Сколько блоков закрыто
+    uint64_t written_count = 0;          // Сколько блоков записано
+    bool stop_flag = false;
+    std::atomic<bool> write_failed = false;
+    std::thread thread;
+};
+
+#endif // BLOCK_CODEC_H
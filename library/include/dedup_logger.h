@@ -0,0 +1,85 @@
+#ifndef DEDUP_LOGGER_H
+#define DEDUP_LOGGER_H
+
+#include "logger.h"
+#include <vector>
+#include <thread>
+#include <condition_variable>
+
+// Логгер-обертка, схлопывающая повторяющиеся сообщения.
+// Повтор одного из window последних различных сообщений не пишется, а считается;
+// при вытеснении сообщения из окна или по таймауту выводится строка со счетчиком,
+// временем первого и последнего повтора и текстом сообщения.
+// Решение принимается под mutex, а запись в обернутый логгер выполняется вне его,
+// поэтому медленный приемник не задерживает подсчет повторов в других потоках
+// (порядок строк разных потоков между собой при этом не фиксируется)
+class DedupLogger : public Logger
+{
+public:
+    DedupLogger(std::unique_ptr<Logger> sink,
+                std::chrono::milliseconds timeout = std::chrono::milliseconds(1000), size_t window = 1);
+    ~DedupLogger();
+
+    // Запрещаем копирование
+    DedupLogger(const DedupLogger&) = delete;
+    DedupLogger& operator=(const DedupLogger&) = delete;
+
+    // Реализация виртуальных методов
+    LoggerError log(const std::string& msg, LogLevel level) override;
+    LoggerError log_at(const std::string& msg, LogLevel level, std::chrono::system_clock::time_point time) override;
+    std::string get_type() const override { return "dedup(" + sink->get_type() + ")"; }
+
+    // Повтором считается запись с тем же сообщением и полями (в виде key=value);
+    // первая запись передается обернутому логгеру с полями, а не склеенной строкой
+    LoggerError log_record(const StructuredRecord& record) override;
+
+    // Уровень хранится в обернутом логгере
+    void set_log_level(LogLevel level) override { sink->set_log_level(level); }
+    LogLevel get_log_level() const override { return sink->get_log_level(); }
+
+    // Немедленный вывод всех накопленных счетчиков и сброс обернутого логгера
+    LoggerError flush() override;
+    LoggerError sync() override;
+
+private:
+    using Clock = std::chrono::system_clock;
+
+    // Недавнее сообщение и его повторы
+    struct Entry
+    {
+        size_t hash;
+        LogLevel level;
+        std::string msg;
+        uint64_t repeats = 0;           // Повторов с момента последней сводки
+        Clock::time_point first, last;  // Время первого и последнего повтора
+    };
+
+    // Сводка о повторах для вывода вне mutex
+    struct Summary
+    {
+        std::string text;
+        LogLevel level;
+    };
+
+    // Учет сообщения: true - повтор (только счетчик); иначе сообщение занимает место в окне,
+    // а сводка о вытесненном попадает в evicted
+    bool count_repeat(const std::string& msg, LogLevel level, Clock::time_point now, Summary& evicted, bool& has_evicted);
+    bool take_summary(Entry& entry, Summary& out) const; // Сводка и сброс счетчика (под mutex)
+    void write_summaries(const std::vector<Summary>& summaries); // Вывод (вне mutex)
+    void timer_task();                        // Периодический вывод сводок
+
+    std::unique_ptr<Logger> sink;     // Обернутый логгер
+    std::chrono::milliseconds timeout;
+    size_t window;                    // Размер окна сравнения
+    std::vector<Entry> recent;        // Последние различные сообщения (новые в конце)
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool stop_flag = false;
+    std::thread timer;
+};
+
+// Фабричная функция для создания логгера с подавлением повторов
+std::unique_ptr<Logger> create_dedup_logger(std::unique_ptr<Logger> sink,
+    std::chrono::milliseconds timeout = std::chrono::milliseconds(1000), size_t window = 1);
+
+#endif // DEDUP_LOGGER_H
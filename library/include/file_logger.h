@@ -2,6 +2,32 @@
 #define FILE_LOGGER_H
 
 #include "logger.h"
+#include <atomic>
+#include <thread>
+#include "log_index.h"
+#include "block_codec.h"
+#include "structured_log.h"
+#include "pattern_layout.h"
+#include "lock_profiler.h"
+
+// Дескриптор для fsync, открываемый вместе с потоком записи (std::ofstream не дает своего).
+// Указывает на тот же файл, даже если имя журнала потом переименуют или удалят
+class SyncHandle
+{
+public:
+    SyncHandle() = default;
+    ~SyncHandle() { reset(); }
+
+    SyncHandle(const SyncHandle&) = delete;
+    SyncHandle& operator=(const SyncHandle&) = delete;
+
+    void open(const std::string& file_name); // Сразу после открытия потока записи
+    void reset();
+    LoggerError sync() const;                // fsync; FILE_OPEN_FAILED, если не открыт
+
+private:
+    int fd = -1;
+};
 
 // Класс файлового логгера, наследуется от базового Logger
 class FileLogger : public Logger
@@ -16,25 +42,77 @@ public:
 
     // Реализация виртуальных методов
     LoggerError log(const std::string& msg, LogLevel level) override;
+    LoggerError log_at(const std::string& msg, LogLevel level, std::chrono::system_clock::time_point time) override;
+    LoggerError log_record(const StructuredRecord& record) override;
     std::string get_type() const override { return "file"; }
+    LoggerError flush() override;
+    LoggerError sync() override;
 
     // Установка и получение уровня логирования
     void set_log_level(LogLevel level) override
     {
-        log_level = level;
+        log_level.store(level, std::memory_order_relaxed);
     }
 
     LogLevel get_log_level() const override
     {
-        return log_level;
+        return log_level.load(std::memory_order_relaxed);
     }
 
+    // Формат вывода: текст (по умолчанию) или JSON Lines
+    void set_format(LogFormat value) { format.store(value, std::memory_order_relaxed); }
+    LogFormat get_format() const { return format.load(std::memory_order_relaxed); }
+
+    // Макет текстовых строк вместо msg_format (pattern_layout.h); nullptr - стандартный формат.
+    // Задается до начала логирования
+    void set_layout(std::unique_ptr<PatternLayout> value) { layout = std::move(value); }
+    const PatternLayout* get_layout() const { return layout.get(); }
+
+    // Включение разреженного индекса <file_name>.idx:
+    // новый блок начинается каждые every_records записей или каждые every_seconds секунд.
+    // Индекс покрывает записи с момента включения; остальное (LogIndex::uncovered) просматривается целиком
+    LoggerError enable_index(size_t every_records = 1000, int every_seconds = 1);
+
+    // Включение блочного сжатия: строки копятся в блоки по block_size байт,
+    // сжатие и запись выполняются фоновым потоком (несовместимо с индексом).
+    // Вызывается до начала логирования
+    LoggerError enable_compression(size_t block_size = 64 * 1024);
+
+    // Включение буферов потоков: каждый поток копирует готовые строки в собственный буфер
+    // без общего мьютекса, а фоновый поток раз в interval (или при заполнении буфера до
+    // buffer_size) сливает буферы в порядке времени записей и пишет их одной операцией.
+    // Порядок по времени соблюдается в пределах одного слияния. Совместимо с индексом и сжатием.
+    // Вызывается до начала логирования; flush и sync дописывают накопленное
+    LoggerError enable_staging(size_t buffer_size = 64 * 1024,
+                               std::chrono::milliseconds interval = std::chrono::milliseconds(10));
+
 private:
+    struct StagingState; // Реестр буферов потоков и фоновый поток слияния (file_logger.cpp)
+
+    LoggerError write_line(const std::string& line, LogLevel level, std::chrono::system_clock::time_point time);
+    void index_record(std::time_t time, LogLevel level, size_t size); // Учет записи в текущем блоке
+    void write_index_block();                                          // Запись текущего блока в индекс
+    LoggerError stage_line(const std::string& line, LogLevel level, std::chrono::system_clock::time_point time);
+    LoggerError merge_staged();                                        // Слияние буферов потоков в файл
+    void staging_loop();                                               // Фоновый поток слияния
+
     std::string name;           // Имя файла
     std::ofstream log_file;     // Файловый поток для записи
-    LogLevel log_level;        // Текущий уровень логирования
-    std::mutex log_mutex;       // Мьютекс для потокобезопасности
+    SyncHandle sync_handle;     // Дескриптор того же файла для sync (под log_mutex)
+    std::atomic<LogLevel> log_level; // Текущий уровень логирования (меняется из другого потока)
+    LogMutex log_mutex{"FileLogger::log_mutex"}; // Мьютекс для потокобезопасности
+    std::atomic<LogFormat> format = LogFormat::TEXT;
+    std::unique_ptr<PatternLayout> layout; // Макет текстовых строк (nullptr - msg_format)
+
+    // Индекс
+    std::ofstream index_file;   // Файл индекса (закрыт, если индекс выключен)
+    size_t index_records = 0;   // Записей в блоке
+    int index_seconds = 0;      // Длительность блока в секундах
+    uint64_t file_offset = 0;   // Текущий размер файла журнала
+    LogIndexEntry block{};      // Текущий (незавершенный) блок
 
+    std::unique_ptr<BlockCompressor> compressor; // Компрессор (nullptr, если сжатие выключено)
+    std::unique_ptr<StagingState> staging;       // Буферы потоков (nullptr, если выключены)
 };
 
-#endif // FILE_LOGGER_H
\ No newline at end of file
+#endif // FILE_LOGGER_H
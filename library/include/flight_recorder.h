@@ -0,0 +1,84 @@
+#ifndef FLIGHT_RECORDER_H
+#define FLIGHT_RECORDER_H
+
+#include "logger.h"
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+// Сигнатура файла кольцевого буфера
+constexpr char FLIGHT_MAGIC[8] = {'L', 'O', 'G', 'R', 'I', 'N', 'G', '1'};
+
+// Заголовок файла: курсоры атомарны и разделяются через отображение файла
+struct FlightHeader
+{
+    char magic[8];
+    uint64_t capacity;              // Размер области данных
+    std::atomic<uint64_t> cursor;   // Всего зарезервировано байт (позиция = cursor % capacity)
+    std::atomic<uint64_t> seq;      // Следующий порядковый номер записи
+    uint64_t reserved[4];
+};
+
+// Запись, восстановленная из кольцевого буфера
+struct RecoveredRecord
+{
+    uint64_t seq;
+    int64_t time_ns; // Время (нс от эпохи)
+    LogLevel level;
+    std::string msg;
+};
+
+// "Бортовой самописец": последние N МБ записей в кольце, отображенном на файл (MAP_SHARED).
+// Запись не использует блокировок и системных вызовов (кроме clock_gettime), поэтому
+// данные переживают аварийное завершение процесса и запись допустима из обработчика сигнала
+class FlightRecorder : public Logger
+{
+public:
+    FlightRecorder(const std::string& file_name, size_t size_mb = 16, LogLevel level = LogLevel::DEBUG);
+    ~FlightRecorder();
+
+    // Запрещаем копирование
+    FlightRecorder(const FlightRecorder&) = delete;
+    FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+    LoggerError init(); // Создание или повторное открытие файла кольца
+
+    // Реализация виртуальных методов
+    LoggerError log(const std::string& msg, LogLevel level) override;
+    std::string get_type() const override { return "flight"; }
+
+    void set_log_level(LogLevel level) override { log_level = level; }
+    LogLevel get_log_level() const override { return log_level; }
+
+    // Запись без блокировок; безопасна для вызова из обработчика сигнала
+    bool record(const char* msg, size_t len, LogLevel level);
+
+    // Обработчики SIGSEGV/SIGABRT/SIGTERM/SIGBUS: отметка о сбое в кольце и штатное завершение по сигналу.
+    // SIGTERM завершает процесс не сразу: обработчик запоминает сигнал и пишет байт в termination_fd(),
+    // основной цикл приложения дописывает очередь и вызывает finish_termination. Повторный SIGTERM
+    // завершает процесс немедленно
+    static void install_signal_handlers(FlightRecorder* recorder);
+
+    static int termination_signal();  // Отложенный сигнал завершения (0 - не было)
+    static int termination_fd();      // Становится читаемым после SIGTERM (-1 - обработчики не установлены)
+    static void finish_termination(); // Завершение по отложенному сигналу, если он был
+
+    // Извлечение целых записей из файла кольца, упорядоченных по номеру
+    static bool recover(const std::string& file_name, std::vector<RecoveredRecord>& records);
+
+private:
+    static void signal_handler(int sig);
+
+    std::string name;            // Имя файла кольца
+    size_t capacity;             // Размер области данных
+    std::atomic<LogLevel> log_level;
+    int fd = -1;
+    FlightHeader* header = nullptr; // Начало отображения
+    char* data = nullptr;           // Область данных
+};
+
+// Фабричная функция для создания самописца
+std::unique_ptr<FlightRecorder> create_flight_recorder(const std::string& file_name, size_t size_mb = 16,
+                                                       LogLevel level = LogLevel::DEBUG);
+
+#endif // FLIGHT_RECORDER_H
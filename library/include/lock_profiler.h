@@ -0,0 +1,84 @@
+#ifndef LOCK_PROFILER_H
+#define LOCK_PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Статистика одного места блокировки (все мьютексы с одинаковым именем суммируются)
+struct LockStats
+{
+    static constexpr size_t BUCKETS = 16; // Корзина i: ожидание < 2^(i+9) нс (последняя - все больше)
+
+    std::string name;
+    std::atomic<uint64_t> acquisitions{0}; // Все захваты
+    std::atomic<uint64_t> contended{0};    // Захваты, которым пришлось ждать
+    std::atomic<uint64_t> wait_ns{0};      // Суммарное ожидание
+    std::atomic<uint64_t> max_wait_ns{0};
+    std::atomic<uint64_t> histogram[BUCKETS] = {};
+    LockStats* next = nullptr;             // Список всех мест блокировки
+};
+
+// Мьютекс со сбором статистики: число захватов, число захватов с ожиданием
+// и гистограмма времени ожидания. Неконкурентный захват стоит одного try_lock
+// и одного атомарного инкремента; время измеряется только при ожидании
+class ProfiledMutex
+{
+public:
+    explicit ProfiledMutex(const char* name);
+
+    ProfiledMutex(const ProfiledMutex&) = delete;
+    ProfiledMutex& operator=(const ProfiledMutex&) = delete;
+
+    void lock()
+    {
+        stats->acquisitions.fetch_add(1, std::memory_order_relaxed);
+        if (!mutex.try_lock())
+            lock_contended();
+    }
+    bool try_lock()
+    {
+        if (!mutex.try_lock())
+            return false;
+        stats->acquisitions.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    void unlock() { mutex.unlock(); }
+
+    const LockStats& get_stats() const { return *stats; }
+
+private:
+    void lock_contended(); // Захват с ожиданием и учет его длительности
+
+    std::mutex mutex;
+    LockStats* stats;
+};
+
+// Отчет по всем местам блокировки (захваты, доля конкурентных, среднее и максимальное ожидание,
+// гистограмма). Места без захватов пропускаются
+void lock_profile_report(std::ostream& out);
+void lock_profile_reset(); // Обнуление счетчиков (например, между сценариями)
+const LockStats* lock_profile_find(const std::string& name); // nullptr, если места нет
+
+// Мьютексы библиотеки. При сборке с -DLOGGING_LOCK_PROFILING=ON они собирают статистику,
+// иначе это обычный std::mutex (имя игнорируется) без дополнительных затрат
+#ifdef LOGGING_LOCK_PROFILING
+using LogMutex = ProfiledMutex;
+using LogCondition = std::condition_variable_any;
+using LogUniqueLock = std::unique_lock<ProfiledMutex>;
+#else
+class LogMutex : public std::mutex
+{
+public:
+    explicit LogMutex(const char*) {}
+};
+using LogCondition = std::condition_variable;
+using LogUniqueLock = std::unique_lock<std::mutex>;
+#endif
+
+#endif // LOCK_PROFILER_H
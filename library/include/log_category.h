@@ -0,0 +1,90 @@
+#ifndef LOG_CATEGORY_H
+#define LOG_CATEGORY_H
+
+#include "logger.h"
+#include <atomic>
+#include <map>
+#include <vector>
+
+class CategoryRegistry;
+
+// Именованная категория ("net.http", "db") со своим атомарным уровнем.
+// Категории реестра пишут в общий логгер; уровень, не заданный явно, наследуется от родителя.
+// Ссылка на категорию - это кэшированный дескриптор: проверка уровня стоит одной relaxed-загрузки
+class LogCategory : public Logger
+{
+public:
+    // Проверка уровня без виртуальных вызовов и блокировок
+    bool is_enabled(LogLevel level) const
+    {
+        return level >= log_level.load(std::memory_order_relaxed);
+    }
+
+    // Реализация виртуальных методов
+    LoggerError log(const std::string& msg, LogLevel level) override;
+    LoggerError log_at(const std::string& msg, LogLevel level, std::chrono::system_clock::time_point time) override;
+    std::string get_type() const override { return "category"; }
+
+    void set_log_level(LogLevel level) override; // Явный уровень (распространяется на потомков без своего уровня)
+    LogLevel get_log_level() const override { return log_level.load(std::memory_order_relaxed); }
+    void reset_log_level();                      // Возврат к унаследованному уровню
+
+    const std::string& get_name() const { return name; }
+    bool has_own_level() const { return own_level; }
+
+private:
+    friend class CategoryRegistry;
+    LogCategory(CategoryRegistry& registry, const std::string& name, LogCategory* parent);
+
+    CategoryRegistry& registry;
+    std::string name;                   // Полное имя категории
+    std::string prefix;                 // "[name] " для вывода
+    LogCategory* parent;                // nullptr у корневой категории
+    std::vector<LogCategory*> children; // Изменяется под мьютексом реестра
+    std::atomic<LogLevel> log_level;
+    bool own_level = false;             // Уровень задан явно (под мьютексом реестра)
+};
+
+// Реестр категорий над общим логгером.
+// Фильтруют категории, и их записи должны обходить уровень приемника. Поэтому приемник -
+// отдельный и пропускающий все уровни: ConfigLogger::category_sink() (без общего уровня
+// конфигурации) или логгер, созданный только для реестра с уровнем DEBUG. Уровень приемника
+// реестр не меняет: логгер, в который пишут и напрямую, сохраняет свой уровень, но он же
+// отсекает и записи категорий
+class CategoryRegistry
+{
+public:
+    explicit CategoryRegistry(std::shared_ptr<Logger> sink, LogLevel root_level = LogLevel::INFO);
+
+    CategoryRegistry(const CategoryRegistry&) = delete;
+    CategoryRegistry& operator=(const CategoryRegistry&) = delete;
+
+    // Категория по имени; недостающие родители создаются ("net.http" -> "net" -> корень)
+    LogCategory& get(const std::string& name);
+    LogCategory& root() { return *root_category; }
+
+    void set_level(const std::string& name, LogLevel level) { get(name).set_log_level(level); }
+
+    std::vector<std::string> names(); // Имена всех созданных категорий
+
+    Logger& get_sink() { return *sink; }
+
+private:
+    friend class LogCategory;
+    void propagate(LogCategory& category, LogLevel level); // Уровень для потомков без явного уровня
+
+    std::shared_ptr<Logger> sink;
+    std::mutex mutex; // Создание категорий и изменение уровней (редкие операции)
+    std::map<std::string, std::unique_ptr<LogCategory>> categories;
+    LogCategory* root_category;
+};
+
+// Проверка уровня до вычисления сообщения
+#define LOG_CATEGORY(category, level, msg)        \
+    do                                            \
+    {                                             \
+        if ((category).is_enabled(level))         \
+            (category).log((msg), (level));       \
+    } while (0)
+
+#endif // LOG_CATEGORY_H
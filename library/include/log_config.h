@@ -0,0 +1,142 @@
+#ifndef LOG_CONFIG_H
+#define LOG_CONFIG_H
+
+#include "logger.h"
+#include "log_category.h"
+#include "structured_log.h"
+#include <atomic>
+#include <map>
+#include <thread>
+#include <vector>
+
+// Описание одного логгера-приемника из файла конфигурации
+struct SinkConfig
+{
+    std::string name;                 // Имя секции [sink <name>]
+    std::string type = "file";        // file, binary, socket, uring
+    std::string path;                 // Файл (file, binary)
+    std::string host;                 // Адрес сервера (socket)
+    int port = 0;                     // Порт сервера (socket)
+    LogLevel level = LogLevel::INFO;  // Уровень приемника
+    size_t compression = 0;           // Размер блока сжатия в байтах (0 - без сжатия)
+    size_t index = 0;                 // Записей в блоке индекса (0 - без индекса)
+    size_t staging = 0;               // Размер буфера потока в байтах (0 - запись без буферов потоков)
+    int dedup = 0;                    // Таймаут подавления повторов в мс (0 - выключено)
+    LogFormat format = LogFormat::TEXT; // Формат вывода (file, socket)
+    std::string layout;               // Шаблон текстовых строк (pattern_layout.h; %c - имя приемника)
+
+    // Совпадение всего, кроме уровня: такой приемник переиспользуется при перезагрузке
+    bool same_sink(const SinkConfig& other) const
+    {
+        return name == other.name && type == other.type && path == other.path && host == other.host &&
+               port == other.port && compression == other.compression && index == other.index && staging == other.staging &&
+               dedup == other.dedup && format == other.format && layout == other.layout;
+    }
+};
+
+// Конфигурация логирования.
+// Формат файла:
+//   level = INFO            # общий уровень
+//   [sink main]             # приемник
+//   type = file
+//   path = app.txt
+//   level = DEBUG
+//   compression = 65536     # или index = 1000, dedup = 1000, format = json, staging = 65536
+//   layout = %d{ISO8601} %l %c: %m%X
+//   [category net.http]     # уровень категории (см. log_category.h)
+//   level = DEBUG
+struct LogConfig
+{
+    LogLevel level = LogLevel::INFO;
+    std::vector<SinkConfig> sinks;
+    std::map<std::string, LogLevel> categories;
+};
+
+// Разбор конфигурации; при ошибке в error записывается номер строки и причина
+bool parse_log_config(std::istream& input, LogConfig& config, std::string& error);
+bool load_log_config(const std::string& file_name, LogConfig& config, std::string& error);
+
+// Создание приемника по описанию (nullptr при ошибке)
+std::unique_ptr<Logger> create_sink(const SinkConfig& config);
+
+// Неизменяемый снимок конфигурации вместе с созданными приемниками
+struct LogConfigSnapshot
+{
+    LogConfig config;
+    std::vector<std::shared_ptr<Logger>> sinks;
+    uint64_t version = 0;
+};
+
+// Логгер, который пишет во все приемники текущего снимка конфигурации.
+// Перезагрузка строит новый снимок и атомарно подменяет указатель (в стиле RCU):
+// пишущие потоки не ждут перезагрузку, а уже начатые записи завершаются на старых
+// приемниках. Замененный снимок хранится в списке retired, и удаляет его (закрывает
+// приемники, останавливает их потоки) только поток перезагрузки или слежения, когда
+// пишущие потоки отпустили все ссылки, - пишущий поток никогда не выполняет деструкторы.
+// std::atomic_load/atomic_store для shared_ptr в libstdc++ не lock-free: они берут мьютекс
+// из внутреннего пула по адресу указателя, но только на время копирования указателя
+class ConfigLogger : public Logger
+{
+public:
+    explicit ConfigLogger(const std::string& file_name);
+    ~ConfigLogger();
+
+    // Запрещаем копирование
+    ConfigLogger(const ConfigLogger&) = delete;
+    ConfigLogger& operator=(const ConfigLogger&) = delete;
+
+    // Реализация виртуальных методов
+    LoggerError log(const std::string& msg, LogLevel level) override;
+    LoggerError log_at(const std::string& msg, LogLevel level, std::chrono::system_clock::time_point time) override;
+    LoggerError log_record(const StructuredRecord& record) override;
+    std::string get_type() const override { return "config"; }
+    LoggerError flush() override;
+    LoggerError sync() override;
+
+    // Общий уровень (до следующей перезагрузки)
+    void set_log_level(LogLevel level) override { log_level.store(level, std::memory_order_relaxed); }
+    LogLevel get_log_level() const override { return log_level.load(std::memory_order_relaxed); }
+
+    // Чтение файла и публикация нового снимка; при ошибке остается прежний
+    LoggerError load();
+
+    // Слежение за файлом через inotify: перезагрузка после каждого сохранения
+    bool watch();
+
+    // Приемник для CategoryRegistry: пишет во все приемники снимка без общего уровня,
+    // потому что записи категорий уже отфильтрованы их уровнями. Уровень ConfigLogger
+    // продолжает действовать для записей мимо категорий. Реестр не должен пережить ConfigLogger
+    std::shared_ptr<Logger> category_sink();
+
+    // Реестр, созданный над category_sink(), к которому применяются уровни категорий
+    // (вызывается до watch). Общий уровень задается и корневой категории
+    void attach_categories(CategoryRegistry* registry);
+
+    std::shared_ptr<const LogConfigSnapshot> snapshot() const { return std::atomic_load(&current); }
+    uint64_t get_version() const { return snapshot()->version; }
+
+private:
+    class CategorySink;
+
+    LoggerError write_all(const std::string& msg, LogLevel level, std::chrono::system_clock::time_point time);
+    LoggerError write_all(const StructuredRecord& record); // Запись во все приемники снимка без общего уровня
+    void apply_levels(const LogConfig& config); // Уровни категорий и общий уровень (под reload_mutex)
+    void watch_task();                          // Поток слежения за файлом
+    void release_retired();                     // Удаление снимков без пишущих потоков (под reload_mutex)
+
+    std::string file_name;
+    std::shared_ptr<const LogConfigSnapshot> current; // Доступ только через atomic_load/atomic_store
+    std::atomic<LogLevel> log_level;
+    std::mutex reload_mutex;                    // Сериализует перезагрузки (пишущие потоки его не берут)
+    std::vector<std::shared_ptr<const LogConfigSnapshot>> retired; // Замененные снимки (под reload_mutex)
+    CategoryRegistry* categories = nullptr;
+
+    int inotify_fd = -1;
+    int stop_pipe[2] = {-1, -1};                // Пробуждение потока слежения при остановке
+    std::thread watcher;
+};
+
+// Фабричная функция: чтение конфигурации и (по желанию) слежение за ней
+std::unique_ptr<ConfigLogger> create_config_logger(const std::string& file_name, bool watch = true);
+
+#endif // LOG_CONFIG_H
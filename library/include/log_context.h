@@ -0,0 +1,178 @@
+#ifndef LOG_CONTEXT_H
+#define LOG_CONTEXT_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+// Поле контекста: ключ и значение
+struct ContextField
+{
+    std::string_view key;
+    std::string_view value;
+};
+
+class ContextSnapshot;
+
+// Контекст потока (MDC): поля запроса (trace, tenant, ...), которые дописываются к каждой
+// записи потока - в тексте msg_format как key=value, в JSON как поля. Поля добавляются
+// только через ContextScope; чтение - одно обращение к thread_local, без выделения памяти
+class LogContext
+{
+public:
+    static constexpr size_t MAX_FIELDS = 16;
+
+    // Контекст текущего потока
+    static LogContext& current()
+    {
+        thread_local LogContext context;
+        return context;
+    }
+
+    // Номер потока (tid) в каждой записи; выключен по умолчанию, чтобы не менять формат журнала
+    static void set_thread_ids(bool value) { thread_ids_flag.store(value, std::memory_order_relaxed); }
+    static bool thread_ids() { return thread_ids_flag.load(std::memory_order_relaxed); }
+
+    // Есть ли что дописывать к записи
+    bool has_fields() const { return depth > 0 || adopted != nullptr || thread_ids(); }
+
+    // Обход полей: принятого снимка (поток записи), иначе собственных
+    template<typename F>
+    void for_each(F f) const;
+
+    // Номер потока - источника записи для вывода (для принятого снимка - поток, который его снял);
+    // 0, если номера потоков выключены
+    uint32_t thread_id() const;
+
+    // Номер потока - источника записи независимо от set_thread_ids (элемент %t макета)
+    uint32_t native_thread_id() const;
+
+    // Дописывание " key=value ... tid=N" к тексту записи
+    void append_text(std::string& out) const;
+
+private:
+    friend class ContextScope;
+    friend class ContextRestore;
+
+    LogContext() = default;
+
+    ContextField fields[MAX_FIELDS];
+    size_t depth = 0;                          // Число открытых ContextScope (поля сверх MAX_FIELDS не хранятся)
+    const ContextSnapshot* adopted = nullptr;  // Контекст другого потока на время ContextRestore
+    uint32_t tid = 0;                          // Кэш gettid
+
+    inline static std::atomic<bool> thread_ids_flag{false};
+};
+
+// RAII-поле контекста: действует до конца области видимости.
+// Ключ должен жить дольше области (обычно строковый литерал), значение копируется
+// во встроенный буфер (длиннее VALUE_CAPACITY - обрезается), поэтому можно передать временную строку
+class ContextScope
+{
+public:
+    static constexpr size_t VALUE_CAPACITY = 64;
+
+    ContextScope(std::string_view key, std::string_view value)
+    {
+        LogContext& context = LogContext::current();
+        size_t len = value.size() < VALUE_CAPACITY ? value.size() : VALUE_CAPACITY;
+        std::memcpy(storage, value.data(), len);
+        if (context.depth < LogContext::MAX_FIELDS)
+            context.fields[context.depth] = ContextField{key, std::string_view(storage, len)};
+        context.depth++;
+    }
+
+    ~ContextScope()
+    {
+        LogContext::current().depth--;
+    }
+
+    // Поле связано с местом в стеке контекста
+    ContextScope(const ContextScope&) = delete;
+    ContextScope& operator=(const ContextScope&) = delete;
+
+private:
+    char storage[VALUE_CAPACITY];
+};
+
+// Снимок контекста для передачи записи в другой поток (очередь ConsoleApp).
+// Ключи и значения копируются во встроенный буфер на INLINE_CAPACITY байт (trace, tenant и
+// номер записи помещаются без выделения памяти); больший контекст переносится в spill.
+// Поля сверх CAPACITY байт отбрасываются
+class ContextSnapshot
+{
+public:
+    static constexpr size_t INLINE_CAPACITY = 80;
+    static constexpr size_t CAPACITY = 192;
+
+    // Снятие контекста текущего потока (вызывается после проверки уровня)
+    void capture();
+
+    // Дополнительное поле после снятия (например, номер записи в очереди); false - не поместилось
+    bool append(std::string_view key, std::string_view value);
+
+    bool empty() const { return count == 0 && tid == 0; }
+    uint32_t get_thread_id() const { return tid; }
+
+    template<typename F>
+    void for_each(F f) const
+    {
+        const char* base = spill.empty() ? data : spill.data();
+        size_t pos = 0;
+        for (uint8_t i = 0; i < count; i++)
+        {
+            uint8_t key_len = static_cast<uint8_t>(base[pos]);
+            uint8_t value_len = static_cast<uint8_t>(base[pos + 1]);
+            pos += 2;
+            f(ContextField{std::string_view(base + pos, key_len), std::string_view(base + pos + key_len, value_len)});
+            pos += key_len + value_len;
+        }
+    }
+
+private:
+    char data[INLINE_CAPACITY]; // Поля подряд: длина ключа, длина значения, ключ, значение
+    std::string spill;          // Те же поля, если не поместились в data (иначе пуст)
+    uint16_t used = 0;
+    uint8_t count = 0;
+    uint32_t tid = 0;
+};
+
+// Принятие снимка в потоке записи: до конца области msg_format и кодировщик JSON
+// выводят поля и tid потока, который поставил запись в очередь
+class ContextRestore
+{
+public:
+    explicit ContextRestore(const ContextSnapshot& snapshot)
+        : previous(LogContext::current().adopted)
+    {
+        LogContext::current().adopted = snapshot.empty() ? nullptr : &snapshot;
+    }
+
+    ~ContextRestore()
+    {
+        LogContext::current().adopted = previous;
+    }
+
+    ContextRestore(const ContextRestore&) = delete;
+    ContextRestore& operator=(const ContextRestore&) = delete;
+
+private:
+    const ContextSnapshot* previous;
+};
+
+template<typename F>
+void LogContext::for_each(F f) const
+{
+    if (adopted)
+    {
+        adopted->for_each(f);
+        return;
+    }
+    size_t stored = depth < MAX_FIELDS ? depth : MAX_FIELDS;
+    for (size_t i = 0; i < stored; i++)
+        f(fields[i]);
+}
+
+#endif // LOG_CONTEXT_H
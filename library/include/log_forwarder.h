@@ -0,0 +1,95 @@
+#ifndef LOG_FORWARDER_H
+#define LOG_FORWARDER_H
+
+#include "logger.h"
+#include <atomic>
+#include <deque>
+#include <sys/types.h>
+
+// Параметры пересылки журнала
+struct ForwardOptions
+{
+    std::string checkpoint;                           // Файл позиции (пусто - <журнал>.fwd)
+    bool tail = false;                                // Без сохраненной позиции начинать с конца файла
+    std::chrono::milliseconds connect_timeout{3000};  // Ожидание одной попытки connect
+    std::chrono::milliseconds drain_idle{2000};       // Старый файл закрывается, когда столько не растет
+};
+
+// Пересылка дописываемого журнала в сокет ("host:port" или "unix:/path") через sendfile.
+// Позиция (inode и смещение) сохраняется в файле позиции и переживает перезапуск и ротацию.
+// После ротации старый файл дочитывается, пока в него пишут; до его закрытия в файле позиции
+// хранится и его inode со смещением, так что сбой во время дочитывания не теряет его хвост.
+// Формат файла позиции: строка "inode смещение" текущего файла (0 0 - еще не открыт),
+// затем такие же строки дочитываемых файлов от старых к новым
+class LogForwarder
+{
+public:
+    LogForwarder(const std::string& path, const std::string& target, ForwardOptions options = {});
+    ~LogForwarder();
+
+    // Запрещаем копирование
+    LogForwarder(const LogForwarder&) = delete;
+    LogForwarder& operator=(const LogForwarder&) = delete;
+
+    // Наблюдение за каталогом журнала и загрузка позиции; FILE_OPEN_FAILED - ошибка inotify
+    LoggerError init();
+
+    // Один проход: подключение, пересылка старых файлов и текущего, сохранение позиции.
+    // drain - старые файлы закрываются сразу после пересылки (однократный запуск).
+    // WRITE_FAILED - нет соединения или ошибка отправки (соединение закрыто, позиция указывает
+    // на первый неотправленный байт); FILE_OPEN_FAILED - файл нельзя прочитать (будет открыт заново)
+    LoggerError step(bool drain = false);
+
+    // Ожидание изменений в каталоге журнала не дольше timeout
+    void wait(std::chrono::milliseconds timeout);
+
+    // Сохранение позиции (temp-файл и rename: после сбоя остается старая или новая позиция)
+    LoggerError save();
+
+    // Остановка из обработчика сигнала или другого потока: прерывает пересылку и ожидание
+    void stop() { stop_flag.store(true, std::memory_order_relaxed); }
+    bool stopped() const { return stop_flag.load(std::memory_order_relaxed); }
+
+    bool is_connected() const { return sock != -1; }
+    bool is_draining() const { return !draining.empty(); }  // Есть недочитанные старые файлы
+    bool has_rotated() const { return rotated; }            // Последний проход обнаружил ротацию
+    uint64_t get_sent() const { return sent; }
+
+private:
+    // Пересылаемый файл: дескриптор, номер inode и смещение первого неотправленного байта
+    struct Source
+    {
+        int fd = -1;
+        ino_t ino = 0;
+        off_t offset = 0;
+        std::chrono::steady_clock::time_point seen; // Последний рост (для старых файлов)
+    };
+
+    bool open_current();                  // Открытие журнала по имени
+    LoggerError forward(Source& source);  // Пересылка от offset до конца файла
+    bool connect_target();
+    void close_socket();
+    std::string find_rotated(ino_t ino) const; // Поиск переименованного файла по inode
+    bool load_checkpoint();
+    void close_source(Source& source);
+
+    std::string path;
+    std::string target;
+    ForwardOptions options;
+    int notify = -1;
+    int sock = -1;
+
+    Source current;                    // Файл, открытый по имени журнала
+    std::deque<Source> draining;       // Старые файлы после ротации, от старых к новым
+    bool resume = false;               // saved_current применяется при открытии файла с тем же inode
+    bool positioned = false;           // Позиция известна (файл позиции или первое открытие): tail не действует
+    Source saved_current;
+    bool rotated = false;
+    std::atomic<bool> stop_flag{false};
+    uint64_t sent = 0;
+
+    std::string saved_text;            // Последнее сохраненное содержимое файла позиции
+    std::chrono::steady_clock::time_point saved_time;
+};
+
+#endif // LOG_FORWARDER_H
@@ -0,0 +1,52 @@
+#ifndef LOG_INDEX_H
+#define LOG_INDEX_H
+
+#include "logger.h"
+#include "mapped_file.h"
+#include <cstdint>
+#include <ctime>
+#include <utility>
+#include <vector>
+
+// Сигнатура файла индекса
+constexpr char LOG_INDEX_MAGIC[8] = {'L', 'O', 'G', 'I', 'D', 'X', '1', '\0'};
+
+// Запись разреженного индекса: один блок последовательных записей журнала
+struct LogIndexEntry
+{
+    uint64_t offset;      // Смещение начала блока в файле журнала
+    uint64_t length;      // Длина блока в байтах
+    int64_t first_time;   // Время первой записи блока (секунды от эпохи)
+    int64_t last_time;    // Время последней записи блока
+    uint32_t counts[3];   // Число записей каждого уровня (DEBUG, INFO, ERROR)
+    uint32_t records;     // Всего записей в блоке
+};
+
+// Чтение индекса (файл отображается в память) и поиск блоков по времени
+class LogIndex
+{
+public:
+    bool open(const std::string& index_name);
+
+    const LogIndexEntry* begin() const { return entries; }
+    const LogIndexEntry* end() const { return entries + count; }
+    size_t size() const { return count; }
+
+    // Диапазон блоков [first, last), которые могут содержать записи из [from, to]
+    std::pair<size_t, size_t> find_range(std::time_t from, std::time_t to) const;
+
+    // Есть ли в блоке записи уровня не ниже level
+    static bool has_level(const LogIndexEntry& entry, LogLevel level);
+
+    // Участки [begin, end) журнала размера file_size, не покрытые блоками: до первого блока
+    // (записи до включения индекса или без файла индекса), между несмежными блоками
+    // (запуски без индекса) и хвост после последнего блока. Их нужно просматривать целиком
+    std::vector<std::pair<uint64_t, uint64_t>> uncovered(uint64_t file_size) const;
+
+private:
+    MappedFile file;
+    const LogIndexEntry* entries = nullptr;
+    size_t count = 0;
+};
+
+#endif // LOG_INDEX_H
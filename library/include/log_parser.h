@@ -0,0 +1,31 @@
+#ifndef LOG_PARSER_H
+#define LOG_PARSER_H
+
+#include "logger.h"
+#include <string_view>
+#include <ctime>
+#include <cstdint>
+
+// Запись, разобранная из строки формата Logger::msg_format или JSON Lines (encode_json)
+struct LogRecord
+{
+    std::time_t time = 0;  // Время записи (секунды от эпохи)
+    uint32_t nsec = 0;     // Доли секунды в наносекундах (0, если в строке их нет)
+    LogLevel level = LogLevel::INFO;
+    std::string_view msg;  // Текст сообщения (указывает в исходную строку; в JSON - с экранированием)
+};
+
+// Разбор строки вида "[2024-01-15 14:30:25] [INFO] Сообщение" или строки JSON
+// {"time":"2024-01-15T14:30:25.123456789","level":"INFO","msg":"Сообщение",...}
+bool parse_log_line(std::string_view line, LogRecord& record);
+
+// Быстрое извлечение уровня без разбора времени (для поиска по большим файлам)
+bool peek_log_level(std::string_view line, LogLevel& level);
+
+// Разбор только метки времени "2024-01-15 14:30:25" или "2024-01-15T14:30:25" (без скобок)
+bool parse_log_time(std::string_view str, std::time_t& time);
+
+// Разбор названия уровня ("DEBUG", "INFO", "ERROR")
+bool parse_level_name(std::string_view name, LogLevel& level);
+
+#endif // LOG_PARSER_H
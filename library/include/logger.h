@@ -9,6 +9,9 @@
 #include <chrono>
 #include <sstream>
 #include <fstream>
+#include <ctime>
+#include <cstdio>
+#include "log_context.h"
 
 // Уровни логирования
 enum class LogLevel
@@ -26,6 +29,8 @@ enum class LoggerError
     WRITE_FAILED      // Ошибка записи
 };
 
+class StructuredRecord; // Структурированная запись (structured_log.h)
+
 // Базовый абстрактный класс логгера
 class Logger
 {
@@ -38,6 +43,23 @@ public:
     virtual LogLevel get_log_level() const = 0;
     virtual std::string get_type() const = 0;
 
+    // Запись с заранее известным временем (например, переведенным из тактов TscClock
+    // фоновым потоком). По умолчанию время игнорируется
+    virtual LoggerError log_at(const std::string& msg, LogLevel level, std::chrono::system_clock::time_point time)
+    {
+        (void)time;
+        return log(msg, level);
+    }
+
+    // Структурированная запись с полями "ключ - значение" (structured_log.h).
+    // По умолчанию поля дописываются к сообщению в виде key=value
+    virtual LoggerError log_record(const StructuredRecord& record);
+
+    // Сброс буферов логгера: flush - передача данных ОС, sync - дополнительно на диск.
+    // По умолчанию логгер ничего не буферизует
+    virtual LoggerError flush() { return LoggerError::NONE; }
+    virtual LoggerError sync() { return flush(); }
+
     // Вспомогательные методы для логирования
     void debug(const std::string& msg)
     {
@@ -54,33 +76,15 @@ public:
         log(msg, LogLevel::ERROR);
     }
 
-protected:
-    // Статический метод для форматирования сообщения
+    // Статический метод для форматирования сообщения (открыт для утилит, восстанавливающих текст)
     static std::string msg_format(LogLevel level, const std::string& msg)
     {
-        auto curr = std::chrono::system_clock::now();
-        auto time = std::chrono::system_clock::to_time_t(curr);
-
-        std::stringstream ss;
-        // Формат: [2024-01-15 14:30:25] [INFO] Сообщение
-        ss << "[" << std::put_time(std::localtime(&time), "%Y-%m-%d %X") << "] "\
-        << "[" << level_to_str(level) << "] " << msg;
-
-        return ss.str();
+        return msg_format(level, msg, std::chrono::system_clock::now());
     }
 
-private:
-    // Преобразование уровня логирования в строку
-    static std::string level_to_str(LogLevel level)
-    {
-        switch(level)
-        {
-            case LogLevel::DEBUG: return "DEBUG";
-            case LogLevel::INFO: return "INFO";
-            case LogLevel::ERROR: return "ERROR";
-            default: return "UNKNOWN";
-        }
-    }
+    // Форматирование с заданным временем записи: стандартный макет DefaultLayout
+    // (pattern_layout.h) с полями контекста потока (ContextScope) в виде key=value
+    static std::string msg_format(LogLevel level, const std::string& msg, std::chrono::system_clock::time_point curr);
 };
 
 // Фабричные функции для создания логгеров
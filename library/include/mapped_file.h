@@ -0,0 +1,31 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <string_view>
+
+// Отображение файла в память только для чтения (RAII-обертка над mmap)
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& file_name); // Отображение файла целиком
+    void close();
+
+    const char* data() const { return addr; }
+    size_t size() const { return length; }
+    std::string_view view() const { return std::string_view(addr, length); }
+    bool is_open() const { return fd != -1; }
+
+private:
+    int fd = -1;              // Дескриптор файла
+    const char* addr = nullptr; // Адрес отображения
+    size_t length = 0;        // Размер файла
+};
+
+#endif // MAPPED_FILE_H
@@ -0,0 +1,115 @@
+#ifndef MULTI_SOCKET_LOGGER_H
+#define MULTI_SOCKET_LOGGER_H
+
+#include "socket_logger.h"
+#include <vector>
+#include <condition_variable>
+
+// Адрес получателя журнала
+struct SocketEndpoint
+{
+    std::string host;
+    int port = 0;
+};
+
+// Выбор соединения для записи
+enum class BalanceMode
+{
+    ROUND_ROBIN, // По кругу: равномерная нагрузка на всех получателей
+    HASH         // По ключу (log_keyed) или по потоку: порядок записей одного ключа сохраняется,
+                 // пока его соединение исправно (см. MultiSocketLogger)
+};
+
+// Параметры пула соединений
+struct SocketPoolOptions
+{
+    size_t connections = 1;                      // Соединений на каждого получателя
+    BalanceMode balance = BalanceMode::ROUND_ROBIN;
+    std::chrono::milliseconds probe{1000};       // Период проверки соединений
+    std::chrono::milliseconds timeout{1000};     // Ожидание одной попытки connect
+};
+
+// Сетевой логгер с несколькими получателями. Записи распределяются по пулу
+// соединений; при ошибке отправки соединение исключается из пула и запись уходит
+// в следующее исправное. Фоновый поток проверяет соединения и возвращает
+// восстановленные в пул.
+// Порядок записей одного ключа в режиме HASH гарантирован только в пределах одного соединения:
+// при исключении соединения записи ключа уходят в следующее исправное, а после возврата -
+// снова в свое, и получатели могут принять записи с разных сторон переключения не по порядку.
+// Строгий порядок требует упорядочивания на приемнике (например, по времени записи)
+class MultiSocketLogger : public Logger
+{
+public:
+    MultiSocketLogger(const std::vector<SocketEndpoint>& endpoints, LogLevel level = LogLevel::INFO,
+                      const SocketPoolOptions& options = SocketPoolOptions());
+    ~MultiSocketLogger();
+
+    // Запрещаем копирование
+    MultiSocketLogger(const MultiSocketLogger&) = delete;
+    MultiSocketLogger& operator=(const MultiSocketLogger&) = delete;
+
+    // Подключение ко всем получателям и запуск проверки; ошибка, только если недоступны все
+    LoggerError init();
+
+    // Реализация виртуальных методов
+    LoggerError log(const std::string& msg, LogLevel level) override;
+    LoggerError log_at(const std::string& msg, LogLevel level, std::chrono::system_clock::time_point time) override;
+    LoggerError log_record(const StructuredRecord& record) override;
+    std::string get_type() const override { return "multisocket"; }
+    LoggerError flush() override;
+
+    // Запись с ключом балансировки: в режиме HASH записи одного ключа идут в одно соединение
+    LoggerError log_keyed(const std::string& key, const std::string& msg, LogLevel level);
+
+    void set_log_level(LogLevel level) override { log_level.store(level, std::memory_order_relaxed); }
+    LogLevel get_log_level() const override { return log_level.load(std::memory_order_relaxed); }
+
+    // Формат вывода для всех соединений
+    void set_format(LogFormat value);
+
+    // Макет текстовых строк: каждое соединение получает свою копию (до начала логирования)
+    void set_layout(const PatternLayout& value);
+
+    size_t get_connections() const { return slots.size(); }
+    size_t get_healthy() const;                                 // Исправных соединений
+    bool is_healthy(size_t endpoint) const;                     // Есть исправное соединение с получателем
+    uint64_t get_failovers() const { return failovers.load(std::memory_order_relaxed); } // Переотправок
+
+private:
+    // Соединение пула
+    struct Slot
+    {
+        size_t endpoint;                  // Индекс получателя
+        std::unique_ptr<SocketLogger> socket;
+        std::atomic<bool> healthy{false};
+    };
+
+    // Отправка через соединение, начиная с first; при ошибке - следующее исправное
+    template<typename Send>
+    LoggerError send(size_t first, Send send_to);
+
+    void probe_task();                     // Фоновая проверка соединений
+    size_t thread_slot() const;            // Соединение потока в режиме HASH
+    void report(const Slot& slot, const char* state) const; // Сообщение о смене состояния
+
+    std::vector<SocketEndpoint> endpoints;
+    std::vector<std::unique_ptr<Slot>> slots; // Соединения получателя i идут с шагом endpoints.size()
+    SocketPoolOptions options;
+    std::atomic<LogLevel> log_level;
+    std::atomic<size_t> next{0};              // Счетчик для ROUND_ROBIN
+    std::atomic<uint64_t> failovers{0};
+
+    std::mutex probe_mutex;
+    std::condition_variable probe_condition;
+    bool stop_flag = false;
+    std::thread probe_thread;
+};
+
+// Разбор списка получателей вида "host:port,host:port"; пустой вектор при ошибке
+std::vector<SocketEndpoint> parse_endpoints(const std::string& list);
+
+// Фабричная функция: nullptr, если не удалось подключиться ни к одному получателю
+std::unique_ptr<MultiSocketLogger> create_multi_socket_logger(const std::vector<SocketEndpoint>& endpoints,
+    LogLevel level = LogLevel::INFO, const SocketPoolOptions& options = SocketPoolOptions());
+
+#endif // MULTI_SOCKET_LOGGER_H
@@ -0,0 +1,144 @@
+#ifndef PATTERN_LAYOUT_H
+#define PATTERN_LAYOUT_H
+
+#include "logger.h"
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Запись для форматирования макетом
+struct LayoutRecord
+{
+    LogLevel level;
+    std::string_view msg;
+    std::chrono::system_clock::time_point time;
+};
+
+// Элементы макета, общие для PatternLayout и StaticLayout. Все дописывают в out
+// без промежуточных строк; числа выводятся через std::to_chars
+namespace layout
+{
+    enum class DateStyle : uint8_t
+    {
+        DEFAULT, // 2024-01-15 14:30:25.123456789 (как msg_format)
+        ISO8601, // 2024-01-15T14:30:25.123456789
+        EPOCH    // 1705329025.123456789
+    };
+
+    // Календарная часть кэшируется на секунду в каждом потоке
+    void append_date(std::string& out, std::chrono::system_clock::time_point time, DateStyle style);
+    void append_level(std::string& out, LogLevel level);
+    void append_thread(std::string& out);  // Номер потока - источника записи (tid)
+    void append_context(std::string& out); // Поля контекста потока: " key=value" на каждое
+
+    // Части StaticLayout
+    template<char... C>
+    struct Text
+    {
+        static void append(std::string& out, const LayoutRecord&)
+        {
+            static constexpr char text[] = {C...};
+            out.append(text, sizeof...(C));
+        }
+    };
+
+    template<DateStyle Style = DateStyle::DEFAULT>
+    struct Date
+    {
+        static void append(std::string& out, const LayoutRecord& record) { append_date(out, record.time, Style); }
+    };
+
+    struct Level
+    {
+        static void append(std::string& out, const LayoutRecord& record) { append_level(out, record.level); }
+    };
+
+    struct Message
+    {
+        static void append(std::string& out, const LayoutRecord& record) { out.append(record.msg); }
+    };
+
+    struct Thread
+    {
+        static void append(std::string& out, const LayoutRecord&) { append_thread(out); }
+    };
+
+    struct Context
+    {
+        static void append(std::string& out, const LayoutRecord&)
+        {
+            const LogContext& context = LogContext::current();
+            if (context.has_fields())
+                append_context(out);
+        }
+    };
+}
+
+// Макет, заданный на этапе компиляции: части разворачиваются в прямую последовательность
+// вызовов без разбора шаблона и ветвлений по шагам
+template<typename... Parts>
+struct StaticLayout
+{
+    static void format(const LayoutRecord& record, std::string& out)
+    {
+        (Parts::append(out, record), ...);
+    }
+};
+
+// [2024-01-15 14:30:25.123456789] [INFO] сообщение key=value - формат msg_format
+using DefaultLayout = StaticLayout<layout::Text<'['>, layout::Date<>, layout::Text<']', ' ', '['>, layout::Level,
+                                   layout::Text<']', ' '>, layout::Message, layout::Context>;
+
+// 2024-01-15T14:30:25.123456789 INFO сообщение key=value
+using IsoLayout = StaticLayout<layout::Date<layout::DateStyle::ISO8601>, layout::Text<' '>, layout::Level,
+                               layout::Text<' '>, layout::Message, layout::Context>;
+
+// Макет по шаблону, например "%d{ISO8601} %t %l %c: %m%X".
+// Шаблон разбирается один раз в плоскую последовательность шагов; соседние литералы
+// объединяются и хранятся в одной строке. Для шаблонов DefaultLayout и IsoLayout
+// используется их специализация.
+//   %d, %d{ISO8601}, %d{EPOCH} - время записи   %l - уровень     %m - сообщение
+//   %t - номер потока           %c - имя макета (например, приложения)
+//   %X - поля контекста потока (" key=value")   %% - знак процента
+class PatternLayout
+{
+public:
+    static constexpr const char* DEFAULT_PATTERN = "[%d] [%l] %m%X";
+    static constexpr const char* ISO_PATTERN = "%d{ISO8601} %l %m%X";
+
+    // Разбор шаблона; nullptr и описание ошибки в error при неверном шаблоне
+    static std::unique_ptr<PatternLayout> compile(const std::string& pattern, const std::string& name = "",
+                                                  std::string* error = nullptr);
+
+    // Дописывание записи в out (без перевода строки)
+    void format(const LayoutRecord& record, std::string& out) const
+    {
+        if (specialized)
+            specialized(record, out);
+        else
+            run_steps(record, out);
+    }
+
+    const std::string& get_pattern() const { return pattern; }
+    bool is_specialized() const { return specialized != nullptr; }
+
+private:
+    enum class StepType : uint8_t { TEXT, DATE, LEVEL, MESSAGE, THREAD, CONTEXT };
+
+    struct Step
+    {
+        StepType type;
+        layout::DateStyle style;  // DATE
+        uint32_t offset, length;  // TEXT: участок literals
+    };
+
+    PatternLayout() = default;
+    void run_steps(const LayoutRecord& record, std::string& out) const;
+
+    std::string pattern;
+    std::string literals;    // Все литералы подряд
+    std::vector<Step> steps;
+    void (*specialized)(const LayoutRecord&, std::string&) = nullptr;
+};
+
+#endif // PATTERN_LAYOUT_H
@@ -0,0 +1,100 @@
+#ifndef RATE_LIMIT_H
+#define RATE_LIMIT_H
+
+#include "logger.h"
+#include <atomic>
+#include <cstdint>
+
+// Политика ограничения для места вызова
+struct CallSitePolicy
+{
+    double rate = 0;                 // Сообщений в секунду (0 - без ограничения скорости)
+    double burst = 1;                // Допустимый всплеск (емкость корзины токенов)
+    uint32_t sample_every = 1;       // Пропускать 1 из N сообщений
+    uint32_t first_per_second = 0;   // Первые K сообщений в секунду пропускаются без выборки
+
+    static CallSitePolicy rate_limit(double per_second, double burst);
+    static CallSitePolicy sample(uint32_t every);
+    static CallSitePolicy first_then_sample(uint32_t first, uint32_t every);
+};
+
+// Место вызова (file:line) со своим состоянием ограничения.
+// Все проверки выполняются на атомиках без блокировок
+class CallSite
+{
+public:
+    CallSite(const char* file, int line, const CallSitePolicy& policy);
+
+    CallSite(const CallSite&) = delete;
+    CallSite& operator=(const CallSite&) = delete;
+
+    bool allow(LogLevel level); // Пропустить ли очередное сообщение (иначе оно считается подавленным)
+
+    // Сводка о подавленных сообщениях: не чаще раза в секунду (или сразу при force).
+    // Счетчик сбрасывается, только если логгер принял сводку (уровень проходит, запись без ошибки).
+    // Логгер запоминается как владелец места вызова (последний, в который оно писало)
+    void report(Logger& logger, LogLevel level, bool force = false);
+
+    uint64_t get_suppressed() const { return suppressed.load(std::memory_order_relaxed); }
+
+    // Сводка по местам вызова, которые пишут в logger и затихли раньше, чем подошло время
+    // сводки. Вызывает владелец логгера перед последним сбросом; сводки других логгеров не трогаются
+    static void report_all(Logger& logger);
+
+private:
+    const char* file;
+    int line;
+    CallSitePolicy policy;
+    int64_t interval_ns;    // Интервал между токенами
+    int64_t tolerance_ns;   // Допустимое опережение (burst токенов)
+
+    std::atomic<int64_t> arrival_ns{0};    // Теоретическое время следующего сообщения (GCRA)
+    std::atomic<uint64_t> calls{0};        // Счетчик для выборки 1 из N
+    std::atomic<int64_t> window_second{0}; // Текущая секунда для "первые K в секунду"
+    std::atomic<uint32_t> window_count{0}; // Сообщений в текущей секунде
+    std::atomic<uint64_t> suppressed{0};   // Подавлено с момента последней сводки
+    std::atomic<int64_t> last_report_ns{0};
+    std::atomic<LogLevel> last_level{LogLevel::INFO}; // Уровень для сводки
+    std::atomic<Logger*> owner{nullptr};   // Логгер, в который пишет место вызова (только сравнение)
+    CallSite* next = nullptr;              // Список всех мест вызова
+};
+
+// Запись сообщения, прошедшего ограничение: строка - через log, структурированная запись
+// (structured_log.h) - через log_record, чтобы поля дошли до логгера, а не склеились в текст
+inline LoggerError log_limited(Logger& logger, const std::string& msg, LogLevel level)
+{
+    return logger.log(msg, level);
+}
+
+inline LoggerError log_limited(Logger& logger, const StructuredRecord& record, LogLevel)
+{
+    return logger.log_record(record);
+}
+
+// Макросы проверяют ограничение до вычисления сообщения, форматирования и постановки в очередь.
+// Сводка проверяется и на подавленных вызовах, чтобы место, где пропускать больше нечего,
+// все равно сообщало о подавленных сообщениях раз в секунду. msg - строка или StructuredRecord
+// (его уровень должен совпадать с level)
+#define LOG_LIMITED(logger, level, policy, msg)                                   \
+    do                                                                            \
+    {                                                                             \
+        static CallSite log_call_site_(__FILE__, __LINE__, (policy));            \
+        if ((level) >= (logger).get_log_level())                                  \
+        {                                                                         \
+            bool log_call_pass_ = log_call_site_.allow(level);                    \
+            log_call_site_.report((logger), (level));                             \
+            if (log_call_pass_)                                                   \
+                log_limited((logger), (msg), (level));                            \
+        }                                                                         \
+    } while (0)
+
+#define LOG_RATE_LIMITED(logger, level, per_second, burst, msg) \
+    LOG_LIMITED(logger, level, CallSitePolicy::rate_limit((per_second), (burst)), msg)
+
+#define LOG_SAMPLED(logger, level, every, msg) \
+    LOG_LIMITED(logger, level, CallSitePolicy::sample(every), msg)
+
+#define LOG_FIRST_THEN_SAMPLED(logger, level, first, every, msg) \
+    LOG_LIMITED(logger, level, CallSitePolicy::first_then_sample((first), (every)), msg)
+
+#endif // RATE_LIMIT_H
@@ -0,0 +1,113 @@
+#ifndef SHM_RING_H
+#define SHM_RING_H
+
+#include "logger.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+
+// Сигнатура кольца в разделяемой памяти
+constexpr char SHM_RING_MAGIC[8] = {'L', 'O', 'G', 'S', 'H', 'M', '1', '\0'};
+
+// Заголовок кольца. Курсоры разнесены по строкам кэша: head меняют производители, tail - читатель
+struct ShmRingHeader
+{
+    char magic[8];                          // Пишется последним: кольцо готово к работе
+    uint64_t slots;                         // Число ячеек (степень двойки)
+    uint64_t slot_size;                     // Размер ячейки в байтах
+    alignas(64) std::atomic<uint64_t> head; // Следующая ячейка для производителей
+    std::atomic<uint64_t> dropped;          // Отброшено из-за заполненного кольца
+    alignas(64) std::atomic<uint64_t> tail; // Следующая ячейка для читателя
+    std::atomic<uint64_t> skipped;          // Пропущено ячеек аварийно завершившихся производителей
+    alignas(64) std::atomic<uint32_t> futex;   // Счетчик публикаций (слово futex)
+    std::atomic<uint32_t> waiting;             // Читатель спит на futex
+};
+
+// Запись, прочитанная из кольца (текст действителен только внутри обработчика)
+struct ShmRecord
+{
+    int64_t time_ns;
+    LogLevel level;
+    uint32_t pid;          // Процесс-производитель
+    bool truncated;        // Сообщение не поместилось в ячейку
+    std::string_view msg;
+};
+
+// Кольцо записей журнала в разделяемой памяти (shm_open + mmap) для нескольких процессов.
+// Производители (любое число процессов и потоков) резервируют ячейки без блокировок
+// по схеме ограниченной очереди Вьюкова; единственный читатель (демон logd) забирает их по порядку.
+// Ячейка, которую начал и не закончил заполнять аварийно завершившийся процесс, пропускается,
+// поэтому сбой производителя не останавливает кольцо
+class ShmRing
+{
+public:
+    ~ShmRing();
+
+    ShmRing(const ShmRing&) = delete;
+    ShmRing& operator=(const ShmRing&) = delete;
+
+    // Открытие кольца с именем вида "/app"; если его нет - создание с указанными размерами
+    static std::unique_ptr<ShmRing> open(const std::string& name, size_t slots = 16384, size_t slot_size = 512);
+    static bool unlink(const std::string& name); // Удаление имени кольца
+
+    // Производитель: копирование записи в ячейку. false - кольцо заполнено (запись учтена в dropped)
+    bool push(const char* msg, size_t len, LogLevel level, int64_t time_ns);
+
+    // Читатель: обработка готовых записей (не более max); возвращает их число.
+    // Ячейки, зависшие дольше stall_timeout, пропускаются, если их производитель завершился
+    size_t drain(const std::function<void(const ShmRecord&)>& handler, size_t max = SIZE_MAX);
+
+    // Читатель: ожидание новых записей на futex (false - по таймауту)
+    bool wait(std::chrono::milliseconds timeout);
+
+    void set_stall_timeout(std::chrono::milliseconds timeout) { stall_timeout = timeout; }
+
+    const std::string& get_name() const { return name; }
+    size_t get_slot_size() const { return header->slot_size; }
+    uint64_t get_dropped() const { return header->dropped.load(std::memory_order_relaxed); }
+    uint64_t get_skipped() const { return header->skipped.load(std::memory_order_relaxed); }
+    size_t size() const; // Занятые ячейки (приблизительно)
+
+private:
+    ShmRing(const std::string& name, ShmRingHeader* header, size_t mapped);
+    char* slot(uint64_t pos) const;
+    bool producer_alive(uint64_t seq) const; // По номеру заполняемой ячейки
+
+    std::string name;
+    ShmRingHeader* header;
+    size_t mapped;                  // Размер отображения
+    uint64_t mask;
+
+    // Состояние читателя
+    uint64_t stall_pos = UINT64_MAX;               // Ячейка, на которой читатель ждет
+    std::chrono::steady_clock::time_point stall_start;
+    std::chrono::milliseconds stall_timeout{500};
+};
+
+// Логгер процесса-производителя: запись в кольцо без системных вызовов (кроме пробуждения
+// читателя). Форматирование и запись в файл выполняет демон logd
+class ShmLogger : public Logger
+{
+public:
+    ShmLogger(std::unique_ptr<ShmRing> ring, LogLevel level = LogLevel::INFO);
+
+    // Реализация виртуальных методов
+    LoggerError log(const std::string& msg, LogLevel level) override;
+    LoggerError log_at(const std::string& msg, LogLevel level, std::chrono::system_clock::time_point time) override;
+    std::string get_type() const override { return "shm"; }
+
+    void set_log_level(LogLevel level) override { log_level.store(level, std::memory_order_relaxed); }
+    LogLevel get_log_level() const override { return log_level.load(std::memory_order_relaxed); }
+
+    ShmRing& get_ring() { return *ring; }
+
+private:
+    std::unique_ptr<ShmRing> ring;
+    std::atomic<LogLevel> log_level;
+};
+
+// Фабричная функция для создания логгера разделяемой памяти
+std::unique_ptr<Logger> create_shm_logger(const std::string& name, LogLevel level = LogLevel::INFO);
+
+#endif // SHM_RING_H
@@ -2,11 +2,26 @@
 #define SOCKET_LOGGER_H
 
 #include "logger.h"
+#include <atomic>
+#include "block_codec.h"
+#include "structured_log.h"
+#include "pattern_layout.h"
+#include "lock_profiler.h"
+#include <deque>
+#include <thread>
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <unistd.h>
 
+// Параметры подключения в фоновом режиме
+struct ConnectOptions
+{
+    std::chrono::milliseconds timeout{1000};    // Ожидание одной попытки connect
+    std::chrono::milliseconds retry{1000};      // Пауза между попытками
+    size_t buffer_limit = 4 << 20;              // Байт сообщений, ожидающих соединения (старые вытесняются)
+};
+
 // Класс сетевого логгера, наследуется от базового Logger
 class SocketLogger : public Logger
 {
@@ -20,40 +35,111 @@ public:
 
     // Реализация виртуальных методов
     LoggerError log(const std::string& msg, LogLevel level) override;
+    LoggerError log_at(const std::string& msg, LogLevel level, std::chrono::system_clock::time_point time) override;
+    LoggerError log_record(const StructuredRecord& record) override;
     std::string get_type() const override { return "socket"; }
+    LoggerError flush() override; // Отправка накопленного сжатого блока
     
-    // Инициализация соединения
+    // Инициализация соединения (блокирующая, не дольше таймаута подключения)
     LoggerError init();
 
+    // Фоновое подключение: логгер готов сразу, сообщения до установки соединения
+    // (и после его разрыва) копятся в буфере, отдельный поток повторяет неблокирующий connect.
+    // Запись (или блок сжатия), на которой оборвалось соединение, отправляется заново целиком:
+    // доставка не менее одного раза, новое соединение начинается с целой строки или кадра
+    LoggerError start_async(const ConnectOptions& options = ConnectOptions());
+
+    void set_connect_timeout(std::chrono::milliseconds timeout) { connect_timeout = timeout; }
+    void set_verbose(bool value) { verbose = value; } // Сообщения о подключении в консоль
+
+    // Переподключение при отправке без соединения (по умолчанию включено). Выключенное -
+    // запись без соединения сразу завершается WRITE_FAILED, а подключает reconnect/init
+    // (пул MultiSocketLogger переключается на другое соединение, а не ждет connect)
+    void set_reconnect_on_send(bool value) { reconnect_on_send = value; }
+    size_t get_dropped() const { return dropped; } // Вытеснено из буфера ожидания
+
     // Установка и получение уровня логирования
     void set_log_level(LogLevel level) override
     {
-        log_level = level;
+        log_level.store(level, std::memory_order_relaxed);
     }
 
     LogLevel get_log_level() const override
     {
-        return log_level;
+        return log_level.load(std::memory_order_relaxed);
     }
 
+    // Формат вывода: текст (по умолчанию) или JSON Lines
+    void set_format(LogFormat value) { format.store(value, std::memory_order_relaxed); }
+    LogFormat get_format() const { return format.load(std::memory_order_relaxed); }
+
+    // Макет текстовых строк вместо msg_format (pattern_layout.h); nullptr - стандартный формат.
+    // Задается до начала логирования
+    void set_layout(std::unique_ptr<PatternLayout> value) { layout = std::move(value); }
+    const PatternLayout* get_layout() const { return layout.get(); }
+
     // Проверка состояния
     bool is_init() const { return init_flag; }          // Проверка инициализации
     bool is_connected() const { return sockfd != -1; }  // Проверка соединения
+    bool wait_connected(std::chrono::milliseconds timeout); // Ожидание соединения (фоновый режим)
     
     // Повторное соединение
     LoggerError reconnect();
 
+    // Проверка живости без отправки: закрытое получателем соединение
+    // (EOF или ошибка на сокете) закрывается, возвращается false
+    bool check_connection();
+
+    // Включение блочного сжатия: сообщения копятся в блоки, сжатие и отправка -
+    // в фоновом потоке. Получатель распаковывает поток утилитой logunpack.
+    // Вызывается после init() и до начала логирования
+    LoggerError enable_compression(size_t block_size = 64 * 1024);
+
 private:
     std::string host;     // Хост для подключения
     int port;             // Порт для подключения
-    int sockfd;           // Дескриптор сокета
-    LogLevel log_level;  // Текущий уровень логирования
-    std::mutex log_mutex; // Мьютекс для потокобезопасности
+    std::atomic<int> sockfd; // Дескриптор сокета (-1 - нет соединения)
+    std::atomic<LogLevel> log_level; // Текущий уровень логирования (меняется из другого потока)
+    LogMutex log_mutex{"SocketLogger::log_mutex"}; // Мьютекс для потокобезопасности
+    std::atomic<LogFormat> format = LogFormat::TEXT;
+    std::unique_ptr<PatternLayout> layout; // Макет текстовых строк (nullptr - msg_format)
     bool init_flag;       // Флаг инициализации
+    std::unique_ptr<BlockCompressor> compressor; // Компрессор (nullptr, если сжатие выключено)
+    std::chrono::milliseconds connect_timeout{3000};
+    std::atomic<bool> verbose = true;
+    std::atomic<bool> reconnect_on_send = true;
+
+    // Фоновое подключение
+    bool async_flag = false;
+    ConnectOptions async_options;
+    std::deque<std::string> pending; // Сообщения, ожидающие соединения (под log_mutex)
+    size_t pending_bytes = 0;
+    std::atomic<size_t> dropped = 0;
+    std::mutex async_mutex;          // Пробуждение потока подключения
+    std::condition_variable async_condition;
+    bool stop_flag = false;
+    std::thread connect_thread;
 
     // Внутренние методы
     LoggerError connect_to_server(); // Подключение к серверу
+    int open_connection(bool verbose); // Неблокирующий connect с таймаутом; дескриптор или -1
+    void connect_task();               // Поток фонового подключения
+    void buffer_line(const std::string& line); // Сообщение в буфер ожидания (под log_mutex)
+    bool send_pending();               // Отправка буфера ожидания (под log_mutex)
+    LoggerError send_or_buffer(const char* data, size_t size); // Отправка или буфер (под log_mutex)
+    void wake_connect();               // Сигнал потоку подключения
     void close_socket();             // Закрытие сокета
+    LoggerError send_all(const char* data, size_t size); // Отправка целиком (под log_mutex)
+    LoggerError send_line(const std::string& line);      // Отправка готовой строки
 };
 
+// Неблокирующий connect: недоступный получатель задерживает не дольше timeout, а не на весь
+// системный таймаут SYN. Дескриптор (в блокирующем режиме) или -1
+int connect_with_timeout(const sockaddr* addr, socklen_t len, std::chrono::milliseconds timeout);
+
+// Фабричная функция для логгера с фоновым подключением: возвращается сразу,
+// независимо от доступности сервера
+std::unique_ptr<SocketLogger> create_async_socket_logger(const std::string& host, int port,
+    LogLevel level = LogLevel::INFO, const ConnectOptions& options = ConnectOptions());
+
 #endif // SOCKET_LOGGER_H
\ No newline at end of file
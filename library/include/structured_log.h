@@ -0,0 +1,120 @@
+#ifndef STRUCTURED_LOG_H
+#define STRUCTURED_LOG_H
+
+#include "logger.h"
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+// Формат вывода логгеров File/Socket
+enum class LogFormat
+{
+    TEXT, // [время] [УРОВЕНЬ] сообщение key=value
+    JSON  // Одна строка JSON на запись (JSON Lines)
+};
+
+// Типизированное поле структурированной записи
+struct LogField
+{
+    enum class Type : uint8_t { INT, UINT, DOUBLE, BOOL, STRING };
+
+    std::string_view key;
+    Type type;
+    union
+    {
+        int64_t i;
+        uint64_t u;
+        double d;
+        bool b;
+    };
+    std::string_view str; // Значение типа STRING
+};
+
+// Структурированная запись: сообщение и поля "ключ - значение".
+// Поля хранятся во встроенном массиве, ключи и строки - ссылками на данные вызывающего,
+// поэтому запись не выделяет память и должна быть передана логгеру до выхода из области видимости
+class StructuredRecord
+{
+public:
+    static constexpr size_t MAX_FIELDS = 16;
+
+    StructuredRecord(std::string_view msg, LogLevel level,
+                     std::chrono::system_clock::time_point time = std::chrono::system_clock::now())
+        : msg(msg), level(level), time(time)
+    {}
+
+    // Добавление поля; поля сверх MAX_FIELDS отбрасываются (см. is_truncated)
+    template<typename T>
+    StructuredRecord& add(std::string_view key, const T& value)
+    {
+        if (count == MAX_FIELDS)
+        {
+            truncated = true;
+            return *this;
+        }
+
+        LogField& field = fields[count++];
+        field.key = key;
+        if constexpr (std::is_same_v<T, bool>)
+        {
+            field.type = LogField::Type::BOOL;
+            field.b = value;
+        }
+        else if constexpr (std::is_floating_point_v<T>)
+        {
+            field.type = LogField::Type::DOUBLE;
+            field.d = value;
+        }
+        else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+        {
+            field.type = LogField::Type::INT;
+            field.i = value;
+        }
+        else if constexpr (std::is_integral_v<T>)
+        {
+            field.type = LogField::Type::UINT;
+            field.u = value;
+        }
+        else
+        {
+            field.type = LogField::Type::STRING;
+            field.str = std::string_view(value);
+        }
+        return *this;
+    }
+
+    std::string_view get_msg() const { return msg; }
+    LogLevel get_level() const { return level; }
+    std::chrono::system_clock::time_point get_time() const { return time; }
+
+    const LogField* begin() const { return fields; }
+    const LogField* end() const { return fields + count; }
+    size_t size() const { return count; }
+    bool is_truncated() const { return truncated; }
+
+private:
+    std::string_view msg;
+    LogLevel level;
+    std::chrono::system_clock::time_point time;
+    LogField fields[MAX_FIELDS];
+    uint8_t count = 0;
+    bool truncated = false;
+};
+
+// Текстовый вид: "сообщение key=value key2=\"строка с пробелами\"" (без метки времени)
+void format_text_fields(const StructuredRecord& record, std::string& out);
+
+class PatternLayout; // Макет текстовых строк (pattern_layout.h)
+
+// Строка записи для файлового или сетевого логгера с переводом строки (дописывается в out):
+// JSON Lines, текст по макету layout или, при layout == nullptr, в формате msg_format
+void format_line(const StructuredRecord& record, LogFormat format, const PatternLayout* layout, std::string& out);
+
+// Запись JSON Lines: {"time":"...","level":"INFO","msg":"...",поля...,поля контекста...}\n (дописывается в out)
+void encode_json(const StructuredRecord& record, std::string& out);
+
+// Экранирование строки для JSON с проверкой UTF-8: некорректные последовательности
+// заменяются на U+FFFD. Участки из 16 байт без спецсимволов копируются целиком (SSE2)
+void json_escape(std::string_view str, std::string& out);
+
+#endif // STRUCTURED_LOG_H
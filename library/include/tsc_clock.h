@@ -0,0 +1,44 @@
+#ifndef TSC_CLOCK_H
+#define TSC_CLOCK_H
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Дешевый источник времени для горячего пути: в записи хранятся "сырые" такты,
+// а перевод в системное время выполняет фоновый поток.
+// На x86 используется rdtsc (при инвариантном TSC), иначе - steady_clock в наносекундах
+class TscClock
+{
+public:
+    // Текущее значение в тактах
+    static uint64_t now()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        if (is_tsc())
+            return __rdtsc();
+#endif
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Перевод тактов в системное время с наносекундным разрешением. Параметры читаются
+    // без блокировок; калибровка по system_clock уточняется не чаще раза в секунду
+    static std::chrono::system_clock::time_point to_time_point(uint64_t ticks);
+
+    // Используется ли rdtsc. CPUID проверяется при первом обращении, а не при
+    // динамической инициализации, поэтому now() безопасен и из статических конструкторов
+    static bool is_tsc()
+    {
+        static const bool value = detect_tsc();
+        return value;
+    }
+
+private:
+    static bool detect_tsc();
+};
+
+#endif // TSC_CLOCK_H
@@ -0,0 +1,142 @@
+#ifndef URING_FILE_LOGGER_H
+#define URING_FILE_LOGGER_H
+
+#include "logger.h"
+#include <atomic>
+#include <deque>
+#include <set>
+#include <sys/uio.h>
+#include <thread>
+#include <vector>
+#include "structured_log.h"
+#include "pattern_layout.h"
+#include "lock_profiler.h"
+
+// Параметры UringFileLogger
+struct UringOptions
+{
+    size_t buffer_size = 1 << 20;                      // Размер буфера записи
+    size_t buffers = 8;                                // Число буферов (не больше buffers - 1 в полете)
+    std::chrono::milliseconds flush_interval{100};     // Не дольше этого неполный буфер ждет записи
+    bool sync = false;                                 // fdatasync, связанный с каждой записью буфера
+    bool use_uring = true;                             // false - сразу pwrite из фонового потока
+};
+
+class UringRing; // Кольца io_uring (uring_file_logger.cpp)
+
+// Файловый логгер с асинхронной записью через io_uring (Linux 5.4+).
+// Вызывающий поток только форматирует строку и копирует ее в текущий буфер; заполненные
+// буферы фоновый поток отправляет пачкой одним io_uring_enter, и несколько буферов
+// находятся в записи одновременно. Системные вызовы io_uring выполняются напрямую,
+// без liburing; если ядро не поддерживает io_uring, фоновый поток пишет через pwrite.
+// Свободных буферов нет - вызывающий поток ждет завершения записи (записи не теряются)
+class UringFileLogger : public Logger
+{
+public:
+    UringFileLogger(const std::string& file_name, LogLevel level = LogLevel::INFO, UringOptions options = {});
+    ~UringFileLogger();
+
+    // Запрещаем копирование
+    UringFileLogger(const UringFileLogger&) = delete;
+    UringFileLogger& operator=(const UringFileLogger&) = delete;
+
+    // Открытие файла в режиме добавления, создание колец и запуск фонового потока
+    LoggerError init();
+
+    // Реализация виртуальных методов
+    LoggerError log(const std::string& msg, LogLevel level) override;
+    LoggerError log_at(const std::string& msg, LogLevel level, std::chrono::system_clock::time_point time) override;
+    LoggerError log_record(const StructuredRecord& record) override;
+    std::string get_type() const override { return "uring"; }
+
+    // flush ждет завершения записи всех буферов, заполненных до вызова; sync - еще и fdatasync.
+    // WRITE_FAILED, если с прошлого вызова какая-то запись не удалась
+    LoggerError flush() override;
+    LoggerError sync() override;
+
+    // Установка и получение уровня логирования
+    void set_log_level(LogLevel level) override
+    {
+        log_level.store(level, std::memory_order_relaxed);
+    }
+
+    LogLevel get_log_level() const override
+    {
+        return log_level.load(std::memory_order_relaxed);
+    }
+
+    // Формат вывода и макет - как у FileLogger (задаются до начала логирования)
+    void set_format(LogFormat value) { format.store(value, std::memory_order_relaxed); }
+    LogFormat get_format() const { return format.load(std::memory_order_relaxed); }
+    void set_layout(std::unique_ptr<PatternLayout> value) { layout = std::move(value); }
+
+    // Способ записи: "io_uring" или "pwrite" (ядро без io_uring, use_uring = false
+    // или переход на pwrite после повторяющихся ошибок io_uring_enter)
+    std::string get_backend() const;
+
+    // Поддерживает ли ядро io_uring в нужном объеме (пробное создание колец)
+    static bool uring_supported();
+
+    uint64_t get_submits() const { return submits.load(std::memory_order_relaxed); } // Вызовов io_uring_enter/pwrite
+    uint64_t get_writes() const { return writes.load(std::memory_order_relaxed); }   // Записанных буферов
+    uint64_t get_stalls() const { return stalls.load(std::memory_order_relaxed); }   // Ожиданий свободного буфера
+    uint64_t get_errors() const { return errors.load(std::memory_order_relaxed); }   // Неудачных записей
+
+private:
+    struct Buffer
+    {
+        std::string data;
+        uint64_t seq = 0;     // Номер в порядке заполнения
+        uint64_t offset = 0;  // Смещение в файле
+        size_t done = 0;      // Записано байт
+        bool failed = false;
+        bool in_ring = false; // Отправлен в io_uring и еще не завершен (только фоновый поток)
+        iovec iov{};          // Остаток для IORING_OP_WRITEV (живет до завершения)
+    };
+
+    LoggerError write_line(const std::string& line);
+    void rotate();                               // Текущий буфер - в очередь записи (под log_mutex)
+    void writer_loop();                          // Фоновый поток
+    void submit_ring(Buffer* buffer);            // Подготовка SQE записи (и fdatasync)
+    void write_direct(Buffer* buffer);           // Запись через pwrite
+    void reap_ring(bool wait);                   // Разбор завершений
+    void complete(Buffer* buffer);               // Буфер записан - возврат в свободные
+    void fall_back();                            // Переход с io_uring на pwrite после сбоев
+
+    std::string name;
+    UringOptions options;
+    int fd = -1;
+    std::atomic<LogLevel> log_level;
+    std::atomic<LogFormat> format = LogFormat::TEXT;
+    std::unique_ptr<PatternLayout> layout;
+
+    LogMutex log_mutex{"UringFileLogger::log_mutex"}; // Защищает поля ниже
+    LogCondition ready_condition;                 // Есть буферы для записи или остановка
+    LogCondition free_condition;                  // Освободился буфер или завершилась запись
+    std::vector<std::unique_ptr<Buffer>> storage;
+    std::vector<Buffer*> free_buffers;
+    std::deque<Buffer*> ready;
+    Buffer* current = nullptr;
+    std::set<uint64_t> outstanding;               // Буферы, отправленные в очередь, но не записанные
+    uint64_t next_seq = 1;
+    uint64_t file_end = 0;                        // Смещение для следующего буфера
+    bool writer_waiting = false;                  // Фоновый поток спит на ready_condition
+    bool stop = false;
+    bool failed_since_flush = false;
+
+    static constexpr int MAX_ENTER_FAILURES = 3;   // Неудачных io_uring_enter подряд до перехода на pwrite
+
+    std::unique_ptr<UringRing> ring;              // nullptr - запись через pwrite (только фоновый поток после init)
+    std::atomic<bool> uring_active{false};        // ring != nullptr, для get_backend из других потоков
+    size_t in_flight = 0;                         // Ожидаемых завершений (только фоновый поток)
+    int enter_failures = 0;                       // Неудачных io_uring_enter подряд
+    std::thread writer;
+
+    std::atomic<uint64_t> submits{0}, writes{0}, stalls{0}, errors{0};
+};
+
+// Фабричная функция: nullptr, если не удалось открыть файл
+std::unique_ptr<Logger> create_uring_file_logger(const std::string& file_name, LogLevel level = LogLevel::INFO,
+                                                 UringOptions options = {});
+
+#endif // URING_FILE_LOGGER_H
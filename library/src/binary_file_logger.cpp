@@ -0,0 +1,74 @@
+#include "binary_file_logger.h"
+
+// Конструктор двоичного логгера
+BinaryFileLogger::BinaryFileLogger(const std::string& file_name, LogLevel level, bool use_dictionary)
+    : name(file_name), log_level(level), encoder(use_dictionary)
+{}
+
+// Деструктор
+BinaryFileLogger::~BinaryFileLogger()
+{
+    std::lock_guard<std::mutex> lock(log_mutex);
+    if (log_file.is_open())
+        log_file.close();
+}
+
+// Запись: кодирование без форматирования времени и строк, одна операция write
+LoggerError BinaryFileLogger::log(const std::string& msg, LogLevel level)
+{
+    if (level < log_level.load(std::memory_order_relaxed)) return LoggerError::NONE; // Фильтрация по уровню
+    return log_at(msg, level, std::chrono::system_clock::now());
+}
+
+// Запись с заданным временем
+LoggerError BinaryFileLogger::log_at(const std::string& msg, LogLevel level, std::chrono::system_clock::time_point time)
+{
+    if (level < log_level.load(std::memory_order_relaxed)) return LoggerError::NONE; // Фильтрация по уровню
+
+    int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+
+    std::lock_guard<std::mutex> lock(log_mutex);
+    buffer.clear();
+    if (!log_file.is_open())
+    {
+        // Каждое открытие начинает новый сегмент со своим словарем
+        log_file.open(name, std::ios::out | std::ios::app | std::ios::binary);
+        if (!log_file.is_open())
+            return LoggerError::FILE_OPEN_FAILED;
+        sync_handle.open(name);
+        encoder.begin_segment(buffer, now);
+    }
+
+    encoder.encode(buffer, now, level, msg);
+    log_file.write(buffer.data(), buffer.size());
+
+    if (log_file.fail())
+        return LoggerError::WRITE_FAILED;
+
+    log_file.flush();
+    return LoggerError::NONE;
+}
+
+LoggerError BinaryFileLogger::flush()
+{
+    std::lock_guard<std::mutex> lock(log_mutex);
+    if (log_file.is_open())
+        log_file.flush();
+    return log_file.fail() ? LoggerError::WRITE_FAILED : LoggerError::NONE;
+}
+
+LoggerError BinaryFileLogger::sync()
+{
+    LoggerError result = flush();
+    if (result != LoggerError::NONE)
+        return result;
+
+    std::lock_guard<std::mutex> lock(log_mutex);
+    return sync_handle.sync(); // Свой дескриптор, а не повторное открытие по имени
+}
+
+// Фабричный метод для создания двоичного логгера
+std::unique_ptr<Logger> create_binary_file_logger(const std::string& file_name, LogLevel level)
+{
+    return std::make_unique<BinaryFileLogger>(file_name, level);
+}
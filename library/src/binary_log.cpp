@@ -0,0 +1,255 @@
+#include "binary_log.h"
+#include <cstring>
+
+namespace
+{
+    const size_t MAX_DICTIONARY = 65536;  // Предел числа шаблонов в сегменте
+    const size_t MAX_DIGITS = 18;         // Числа длиннее не помещаются в uint64 без потерь
+
+    void write_varint(std::string& out, uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    uint64_t zigzag(int64_t value)
+    {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    int64_t unzigzag(uint64_t value)
+    {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    void write_fixed64(std::string& out, int64_t value)
+    {
+        for (int i = 0; i < 8; ++i)
+            out.push_back(static_cast<char>((static_cast<uint64_t>(value) >> (8 * i)) & 0xFF));
+    }
+}
+
+// Числа без ведущих нулей заменяются на '\0', чтобы декодирование давало исходный текст
+bool split_template(const std::string& msg, std::string& pattern, std::vector<uint64_t>& args)
+{
+    pattern.clear();
+    args.clear();
+    if (msg.find('\0') != std::string::npos)
+        return false; // '\0' зарезервирован под место аргумента
+
+    size_t i = 0;
+    while (i < msg.size())
+    {
+        if (msg[i] < '0' || msg[i] > '9')
+        {
+            pattern.push_back(msg[i++]);
+            continue;
+        }
+
+        size_t end = i;
+        while (end < msg.size() && msg[end] >= '0' && msg[end] <= '9')
+            ++end;
+
+        size_t digits = end - i;
+        if ((msg[i] == '0' && digits > 1) || digits > MAX_DIGITS)
+        {
+            pattern.append(msg, i, digits); // Оставляем как текст
+        }
+        else
+        {
+            uint64_t value = 0;
+            for (size_t k = i; k < end; ++k)
+                value = value * 10 + (msg[k] - '0');
+            args.push_back(value);
+            pattern.push_back('\0');
+        }
+        i = end;
+    }
+    return true;
+}
+
+BinaryLogEncoder::BinaryLogEncoder(bool use_dictionary)
+    : use_dictionary(use_dictionary)
+{}
+
+void BinaryLogEncoder::begin_segment(std::string& out, int64_t base_ns)
+{
+    out.append(BINARY_LOG_MAGIC, sizeof(BINARY_LOG_MAGIC));
+    write_fixed64(out, base_ns);
+    last_ns = base_ns;
+    dictionary.clear();
+}
+
+void BinaryLogEncoder::encode(std::string& out, int64_t time_ns, LogLevel level, const std::string& msg)
+{
+    uint8_t tag = static_cast<uint8_t>(level);
+    size_t tag_pos = out.size();
+    out.push_back(0);
+    write_varint(out, zigzag(time_ns - last_ns));
+    last_ns = time_ns;
+
+    BinaryMsgKind kind = BinaryMsgKind::LITERAL;
+    if (use_dictionary && split_template(msg, pattern, args))
+    {
+        auto it = dictionary.find(pattern);
+        if (it != dictionary.end())
+        {
+            kind = BinaryMsgKind::TEMPLATE;
+            write_varint(out, it->second);
+        }
+        else if (dictionary.size() < MAX_DICTIONARY)
+        {
+            kind = BinaryMsgKind::NEW_TEMPLATE;
+            uint32_t id = static_cast<uint32_t>(dictionary.size());
+            write_varint(out, pattern.size());
+            out.append(pattern);
+            dictionary.emplace(pattern, id);
+        }
+
+        if (kind != BinaryMsgKind::LITERAL)
+            for (uint64_t arg : args)
+                write_varint(out, arg);
+    }
+
+    if (kind == BinaryMsgKind::LITERAL)
+    {
+        write_varint(out, msg.size());
+        out.append(msg);
+    }
+
+    out[tag_pos] = static_cast<char>(tag | (static_cast<uint8_t>(kind) << 2));
+}
+
+BinaryLogDecoder::BinaryLogDecoder(std::istream& in)
+    : in(in)
+{}
+
+bool BinaryLogDecoder::read_varint(uint64_t& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        int byte = in.get();
+        if (byte == EOF)
+            return false;
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            return true;
+    }
+    return false;
+}
+
+// Заголовок: сигнатура (первый байт уже прочитан) и базовое время
+bool BinaryLogDecoder::read_segment_header()
+{
+    char magic[sizeof(BINARY_LOG_MAGIC)];
+    magic[0] = BINARY_LOG_MAGIC[0];
+    char base[8];
+    if (!in.read(magic + 1, sizeof(magic) - 1) ||
+        std::memcmp(magic, BINARY_LOG_MAGIC, sizeof(magic)) != 0 ||
+        !in.read(base, sizeof(base)))
+        return false;
+
+    uint64_t value = 0;
+    for (int i = 0; i < 8; ++i)
+        value |= static_cast<uint64_t>(static_cast<uint8_t>(base[i])) << (8 * i);
+
+    last_ns = static_cast<int64_t>(value);
+    dictionary.clear();
+    in_segment = true;
+    return true;
+}
+
+bool BinaryLogDecoder::next(BinaryLogRecord& record)
+{
+    if (error)
+        return false;
+
+    int tag = in.get();
+    while (tag == BINARY_LOG_MAGIC[0]) // Начало нового сегмента
+    {
+        if (!read_segment_header())
+        {
+            error = true;
+            return false;
+        }
+        tag = in.get();
+    }
+
+    if (tag == EOF)
+        return false;
+
+    uint64_t delta, value;
+    uint8_t level = tag & 0x3;
+    auto kind = static_cast<BinaryMsgKind>((tag >> 2) & 0x3);
+    if (!in_segment || level > static_cast<uint8_t>(LogLevel::ERROR) || !read_varint(delta))
+    {
+        error = true;
+        return false;
+    }
+
+    last_ns += unzigzag(delta);
+    record.time_ns = last_ns;
+    record.level = static_cast<LogLevel>(level);
+    record.msg.clear();
+
+    const std::string* pattern = nullptr;
+    switch (kind)
+    {
+        case BinaryMsgKind::LITERAL:
+        case BinaryMsgKind::NEW_TEMPLATE:
+        {
+            if (!read_varint(value) || value > (1u << 30))
+            {
+                error = true;
+                return false;
+            }
+            std::string text(value, '\0');
+            if (!in.read(text.data(), value))
+            {
+                error = true;
+                return false;
+            }
+            if (kind == BinaryMsgKind::LITERAL)
+            {
+                record.msg = std::move(text);
+                return true;
+            }
+            dictionary.push_back(std::move(text));
+            pattern = &dictionary.back();
+            break;
+        }
+        case BinaryMsgKind::TEMPLATE:
+            if (!read_varint(value) || value >= dictionary.size())
+            {
+                error = true;
+                return false;
+            }
+            pattern = &dictionary[value];
+            break;
+        default:
+            error = true;
+            return false;
+    }
+
+    // Подстановка числовых аргументов в шаблон
+    for (char c : *pattern)
+    {
+        if (c != '\0')
+        {
+            record.msg.push_back(c);
+            continue;
+        }
+        if (!read_varint(value))
+        {
+            error = true;
+            return false;
+        }
+        record.msg += std::to_string(value);
+    }
+    return true;
+}
@@ -0,0 +1,342 @@
+#include "block_codec.h"
+#include <cstring>
+#include <vector>
+
+namespace
+{
+    const size_t MIN_MATCH = 4;      // Минимальная длина совпадения
+    const size_t LAST_LITERALS = 5;  // Последние байты блока всегда передаются литералами
+    const size_t MF_LIMIT = 12;      // Совпадения не ищутся ближе к концу блока
+    const size_t MAX_OFFSET = 65535; // Окно поиска
+    const int HASH_LOG = 14;         // Размер хеш-таблицы: 16К позиций
+
+    uint32_t read32(const char* ptr)
+    {
+        uint32_t value;
+        std::memcpy(&value, ptr, sizeof(value));
+        return value;
+    }
+
+    uint32_t hash(uint32_t value)
+    {
+        return (value * 2654435761u) >> (32 - HASH_LOG);
+    }
+
+    void write_u32(std::string& out, uint32_t value)
+    {
+        for (int i = 0; i < 4; ++i)
+            out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+
+    uint32_t load_u32(const char* ptr)
+    {
+        const auto* bytes = reinterpret_cast<const unsigned char*>(ptr);
+        return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+    }
+
+    // Длина сверх 15 кодируется байтами по 255
+    void write_length(std::string& out, size_t length)
+    {
+        while (length >= 255)
+        {
+            out.push_back(static_cast<char>(255));
+            length -= 255;
+        }
+        out.push_back(static_cast<char>(length));
+    }
+
+    bool read_length(const unsigned char* data, size_t size, size_t& pos, size_t& length)
+    {
+        unsigned char byte;
+        do
+        {
+            if (pos >= size)
+                return false;
+            byte = data[pos++];
+            length += byte;
+        } while (byte == 255);
+        return true;
+    }
+
+    // Последовательность: токен, литералы, смещение и длина совпадения
+    void write_sequence(std::string& out, const char* literals, size_t literal_len, size_t offset, size_t match_len)
+    {
+        size_t match_code = match_len ? match_len - MIN_MATCH : 0;
+        unsigned char token = static_cast<unsigned char>(
+            (std::min<size_t>(literal_len, 15) << 4) | std::min<size_t>(match_code, 15));
+        out.push_back(static_cast<char>(token));
+        if (literal_len >= 15)
+            write_length(out, literal_len - 15);
+        out.append(literals, literal_len);
+
+        if (match_len == 0)
+            return; // Последняя последовательность - только литералы
+
+        out.push_back(static_cast<char>(offset & 0xFF));
+        out.push_back(static_cast<char>(offset >> 8));
+        if (match_code >= 15)
+            write_length(out, match_code - 15);
+    }
+}
+
+void lz_compress(const char* data, size_t size, std::string& out)
+{
+    thread_local std::vector<int32_t> table;
+    table.assign(size_t(1) << HASH_LOG, -1);
+
+    size_t anchor = 0, pos = 0;
+    if (size >= MF_LIMIT)
+    {
+        const size_t limit = size - MF_LIMIT;
+        while (pos <= limit)
+        {
+            uint32_t value = read32(data + pos);
+            uint32_t h = hash(value);
+            int32_t ref = table[h];
+            table[h] = static_cast<int32_t>(pos);
+
+            if (ref < 0 || pos - ref > MAX_OFFSET || read32(data + ref) != value)
+            {
+                // Ускорение на несжимаемых участках: шаг растет с длиной литералов
+                pos += 1 + ((pos - anchor) >> 6);
+                continue;
+            }
+
+            size_t match = static_cast<size_t>(ref);
+            // Расширение совпадения назад, пока не дошли до литералов предыдущей последовательности
+            while (pos > anchor && match > 0 && data[pos - 1] == data[match - 1])
+            {
+                --pos;
+                --match;
+            }
+
+            size_t length = MIN_MATCH;
+            size_t max_length = size - LAST_LITERALS - pos;
+            while (length < max_length && data[pos + length] == data[match + length])
+                ++length;
+
+            write_sequence(out, data + anchor, pos - anchor, pos - match, length);
+            pos += length;
+            anchor = pos;
+
+            if (pos >= 2 && pos - 2 <= limit)
+                table[hash(read32(data + pos - 2))] = static_cast<int32_t>(pos - 2);
+        }
+    }
+
+    write_sequence(out, data + anchor, size - anchor, 0, 0);
+}
+
+bool lz_decompress(const char* data, size_t size, char* out, size_t raw_size)
+{
+    const auto* src = reinterpret_cast<const unsigned char*>(data);
+    size_t ip = 0, op = 0;
+
+    while (ip < size)
+    {
+        unsigned char token = src[ip++];
+
+        size_t literal_len = token >> 4;
+        if (literal_len == 15 && !read_length(src, size, ip, literal_len))
+            return false;
+        if (literal_len > size - ip || literal_len > raw_size - op)
+            return false;
+
+        std::memcpy(out + op, src + ip, literal_len);
+        ip += literal_len;
+        op += literal_len;
+
+        if (ip == size)
+            break; // Последняя последовательность
+
+        if (size - ip < 2)
+            return false;
+        size_t offset = src[ip] | (src[ip + 1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > op)
+            return false;
+
+        size_t match_len = token & 15;
+        if (match_len == 15 && !read_length(src, size, ip, match_len))
+            return false;
+        match_len += MIN_MATCH;
+        if (match_len > raw_size - op)
+            return false;
+
+        // Совпадение может перекрывать само себя, поэтому при малом смещении копируем побайтно
+        char* dst = out + op;
+        const char* from = dst - offset;
+        if (offset >= match_len)
+            std::memcpy(dst, from, match_len);
+        else
+            for (size_t i = 0; i < match_len; ++i)
+                dst[i] = from[i];
+        op += match_len;
+    }
+
+    return op == raw_size;
+}
+
+void compress_block(const char* data, size_t size, std::string& out)
+{
+    size_t header = out.size();
+    out.resize(header + BLOCK_HEADER_SIZE);
+    lz_compress(data, size, out);
+
+    size_t payload = out.size() - header - BLOCK_HEADER_SIZE;
+    uint32_t raw_field = static_cast<uint32_t>(size);
+    if (payload >= size)
+    {
+        // Несжимаемые данные хранятся как есть
+        out.resize(header + BLOCK_HEADER_SIZE);
+        out.append(data, size);
+        payload = size;
+        raw_field |= 0x80000000u;
+    }
+
+    std::string fields;
+    write_u32(fields, BLOCK_MAGIC);
+    write_u32(fields, raw_field);
+    write_u32(fields, static_cast<uint32_t>(payload));
+    out.replace(header, BLOCK_HEADER_SIZE, fields);
+}
+
+bool decompress_block(const char* data, size_t size, size_t& pos, std::string& out)
+{
+    if (size - pos < BLOCK_HEADER_SIZE || load_u32(data + pos) != BLOCK_MAGIC)
+        return false;
+
+    uint32_t raw_field = load_u32(data + pos + 4);
+    size_t payload = load_u32(data + pos + 8);
+    bool stored = raw_field & 0x80000000u;
+    size_t raw_size = raw_field & 0x7FFFFFFFu;
+    const char* body = data + pos + BLOCK_HEADER_SIZE;
+
+    if (raw_size > MAX_BLOCK_SIZE || payload > size - pos - BLOCK_HEADER_SIZE || (stored && payload != raw_size))
+        return false;
+
+    size_t start = out.size();
+    if (stored)
+        out.append(body, raw_size);
+    else
+    {
+        out.resize(start + raw_size);
+        if (!lz_decompress(body, payload, out.data() + start, raw_size))
+        {
+            out.resize(start);
+            return false;
+        }
+    }
+
+    pos += BLOCK_HEADER_SIZE + payload;
+    return true;
+}
+
+size_t find_block(const char* data, size_t size, size_t pos)
+{
+    for (; pos + BLOCK_HEADER_SIZE <= size; ++pos)
+    {
+        const char* hit = static_cast<const char*>(std::memchr(data + pos, BLOCK_MAGIC & 0xFF, size - pos));
+        if (!hit)
+            break;
+        pos = hit - data;
+        if (pos + BLOCK_HEADER_SIZE <= size && load_u32(hit) == BLOCK_MAGIC)
+            return pos;
+    }
+    return size;
+}
+
+BlockCompressor::BlockCompressor(Writer writer, size_t block_size, std::chrono::milliseconds flush_interval)
+    : writer(std::move(writer)),
+      block_size(std::min(std::max<size_t>(block_size, 1024), MAX_BLOCK_SIZE)),
+      flush_interval(flush_interval)
+{
+    current.reserve(this->block_size);
+    thread = std::thread(&BlockCompressor::worker, this);
+}
+
+BlockCompressor::~BlockCompressor()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        seal();
+        stop_flag = true;
+        condition.notify_all();
+    }
+    if (thread.joinable())
+        thread.join();
+}
+
+void BlockCompressor::seal()
+{
+    if (current.empty())
+        return;
+
+    sealed.push_back(std::move(current));
+    current = std::string();
+    current.reserve(block_size);
+    sealed_count++;
+    condition.notify_all();
+}
+
+void BlockCompressor::append(const char* data, size_t size)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    while (size > 0)
+    {
+        if (current.empty())
+            current_start = std::chrono::steady_clock::now();
+
+        size_t part = std::min(size, block_size - current.size());
+        current.append(data, part);
+        data += part;
+        size -= part;
+
+        if (current.size() >= block_size)
+            seal();
+    }
+}
+
+void BlockCompressor::flush()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    seal();
+    uint64_t target = sealed_count;
+    written.wait(lock, [this, target] { return written_count >= target || stop_flag; });
+}
+
+void BlockCompressor::worker()
+{
+    std::string compressed;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        condition.wait_for(lock, flush_interval, [this] { return !sealed.empty() || stop_flag; });
+
+        // Блок, который заполняется слишком долго, закрывается по таймеру
+        if (sealed.empty() && !current.empty() &&
+            std::chrono::steady_clock::now() - current_start >= flush_interval)
+            seal();
+
+        if (sealed.empty())
+        {
+            if (stop_flag)
+                break;
+            continue;
+        }
+
+        std::string block = std::move(sealed.front());
+        sealed.pop_front();
+        lock.unlock();
+
+        // Сжатие и запись вне мьютекса: производители продолжают заполнять следующий блок
+        compressed.clear();
+        compress_block(block.data(), block.size(), compressed);
+        if (!writer(compressed.data(), compressed.size()))
+            write_failed = true;
+
+        lock.lock();
+        written_count++;
+        written.notify_all();
+    }
+}
@@ -0,0 +1,179 @@
+#include "dedup_logger.h"
+#include "structured_log.h"
+#include <functional>
+
+namespace
+{
+    // Время вида 14:30:25.123
+    std::string format_time(std::chrono::system_clock::time_point time)
+    {
+        auto t = std::chrono::system_clock::to_time_t(time);
+        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count() % 1000;
+        std::tm tm{};
+        localtime_r(&t, &tm);
+
+        std::stringstream ss;
+        ss << std::put_time(&tm, "%X") << "." << std::setw(3) << std::setfill('0') << ms;
+        return ss.str();
+    }
+}
+
+DedupLogger::DedupLogger(std::unique_ptr<Logger> sink, std::chrono::milliseconds timeout, size_t window)
+    : sink(std::move(sink)), timeout(timeout), window(window > 0 ? window : 1)
+{
+    recent.reserve(this->window);
+    timer = std::thread(&DedupLogger::timer_task, this);
+}
+
+DedupLogger::~DedupLogger()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop_flag = true;
+        condition.notify_all();
+    }
+    if (timer.joinable())
+        timer.join();
+    flush();
+}
+
+// При окне из одного сообщения повторяется всегда последнее; в большем окне сводка
+// может выйти после других сообщений, поэтому относится к сообщению только по его тексту
+bool DedupLogger::take_summary(Entry& entry, Summary& out) const
+{
+    if (entry.repeats == 0)
+        return false;
+
+    out.text = std::string(window == 1 ? "последнее сообщение повторено " : "сообщение повторено ") +
+        std::to_string(entry.repeats) + " раз (" + format_time(entry.first) + " - " +
+        format_time(entry.last) + "): " + entry.msg;
+    out.level = entry.level;
+    entry.repeats = 0;
+    return true;
+}
+
+void DedupLogger::write_summaries(const std::vector<Summary>& summaries)
+{
+    for (const auto& summary : summaries)
+        sink->log(summary.text, summary.level);
+}
+
+LoggerError DedupLogger::log(const std::string& msg, LogLevel level)
+{
+    return log_at(msg, level, Clock::now());
+}
+
+bool DedupLogger::count_repeat(const std::string& msg, LogLevel level, Clock::time_point now,
+                               Summary& evicted, bool& has_evicted)
+{
+    size_t hash = std::hash<std::string>{}(msg) ^ static_cast<size_t>(level);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& entry : recent)
+    {
+        if (entry.hash == hash && entry.level == level && entry.msg == msg)
+        {
+            // Повтор: только счетчик, без форматирования и ввода-вывода
+            if (entry.repeats++ == 0)
+                entry.first = now;
+            entry.last = now;
+            return true;
+        }
+    }
+
+    // Новое сообщение вытесняет самое старое из окна
+    has_evicted = false;
+    if (recent.size() >= window)
+    {
+        has_evicted = take_summary(recent.front(), evicted);
+        recent.erase(recent.begin());
+    }
+    recent.push_back(Entry{hash, level, msg, 0, now, now});
+    return false;
+}
+
+LoggerError DedupLogger::log_at(const std::string& msg, LogLevel level, Clock::time_point now)
+{
+    if (level < sink->get_log_level()) return LoggerError::NONE; // Фильтрация до хеширования
+
+    Summary summary;
+    bool evicted = false;
+    if (count_repeat(msg, level, now, summary, evicted))
+        return LoggerError::NONE;
+
+    if (evicted)
+        sink->log(summary.text, summary.level);
+    return sink->log_at(msg, level, now);
+}
+
+LoggerError DedupLogger::log_record(const StructuredRecord& record)
+{
+    if (record.get_level() < sink->get_log_level()) return LoggerError::NONE;
+
+    std::string text;
+    format_text_fields(record, text);
+
+    Summary summary;
+    bool evicted = false;
+    if (count_repeat(text, record.get_level(), record.get_time(), summary, evicted))
+        return LoggerError::NONE;
+
+    if (evicted)
+        sink->log(summary.text, summary.level);
+    return sink->log_record(record);
+}
+
+LoggerError DedupLogger::flush()
+{
+    std::vector<Summary> summaries;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        Summary summary;
+        for (auto& entry : recent)
+            if (take_summary(entry, summary))
+                summaries.push_back(std::move(summary));
+    }
+    write_summaries(summaries);
+    return sink->flush();
+}
+
+LoggerError DedupLogger::sync()
+{
+    LoggerError result = flush();
+    if (result != LoggerError::NONE)
+        return result;
+    return sink->sync();
+}
+
+// Сводки по таймауту: длительный поток повторов не остается невидимым
+void DedupLogger::timer_task()
+{
+    std::vector<Summary> summaries;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stop_flag)
+    {
+        condition.wait_for(lock, timeout, [this] { return stop_flag; });
+        auto now = Clock::now();
+        Summary summary;
+        for (auto& entry : recent)
+            if (entry.repeats > 0 && now - entry.first >= timeout && take_summary(entry, summary))
+                summaries.push_back(std::move(summary));
+
+        if (!summaries.empty())
+        {
+            lock.unlock();
+            write_summaries(summaries);
+            summaries.clear();
+            lock.lock();
+        }
+    }
+}
+
+// Фабричный метод для создания логгера с подавлением повторов
+std::unique_ptr<Logger> create_dedup_logger(std::unique_ptr<Logger> sink,
+    std::chrono::milliseconds timeout, size_t window)
+{
+    if (!sink)
+        return nullptr;
+    return std::make_unique<DedupLogger>(std::move(sink), timeout, window);
+}
@@ -1,4 +1,72 @@
 #include "file_logger.h"
+#include <filesystem>
+#include <algorithm>
+#include <queue>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace
+{
+    // Строка в буфере потока
+    struct StagedRecord
+    {
+        int64_t time;   // Время записи в наносекундах (ключ слияния)
+        size_t offset;  // Начало строки в data
+        uint32_t length;
+        LogLevel level;
+    };
+
+    // Буфер одного потока. Мьютекс делят только поток-владелец и слияние, поэтому он
+    // почти никогда не бывает занят и не переходит между ядрами при каждой записи
+    struct StagingBuffer
+    {
+        LogMutex mutex{"FileLogger::staging"};
+        std::string data;
+        std::vector<StagedRecord> records;
+        std::atomic<bool> orphaned{false}; // Поток завершился, новых строк не будет
+        std::atomic<bool> retired{false};  // Логгер уничтожен: запись в кэше потока подлежит удалению
+
+        // Данные, снятые слиянием (только под merge_mutex); обмен с data сохраняет емкость обоих
+        std::string taken;
+        std::vector<StagedRecord> taken_records;
+    };
+
+    // Буферы текущего потока по номерам логгеров. Буферы уничтоженных логгеров помечаются
+    // retired (память освобождает ~FileLogger) и удаляются из кэша при следующей записи потока,
+    // поэтому кэш не растет с каждым пересозданным логгером (например, при перезагрузке конфигурации)
+    struct StagingCache
+    {
+        std::vector<std::pair<uint64_t, std::shared_ptr<StagingBuffer>>> entries;
+
+        ~StagingCache()
+        {
+            for (auto& entry : entries)
+                entry.second->orphaned.store(true, std::memory_order_release);
+        }
+    };
+
+    thread_local StagingCache staging_cache;
+    std::atomic<uint64_t> staging_ids{1};
+}
+
+struct FileLogger::StagingState
+{
+    uint64_t id = 0;
+    size_t buffer_size = 0;
+    std::chrono::milliseconds interval{0};
+
+    LogMutex registry_mutex{"FileLogger::staging_registry"}; // Только при первой записи потока
+    std::vector<std::shared_ptr<StagingBuffer>> buffers;
+
+    LogMutex merge_mutex{"FileLogger::merge_mutex"};          // Одно слияние за раз
+    std::string merged;                                       // Переиспользуемый буфер записи
+
+    LogMutex wake_mutex{"FileLogger::staging_wake"};
+    LogCondition wake;
+    bool stop = false;
+    std::thread merger;
+};
 
 // Конструктор файлового логгера
 FileLogger::FileLogger(const std::string& file_name, LogLevel level)
@@ -8,37 +76,416 @@ FileLogger::FileLogger(const std::string& file_name, LogLevel level)
 // Деструктор 
 FileLogger::~FileLogger()
 {
-    std::lock_guard<std::mutex> lock(log_mutex); // Защита от гонки данных
+    if (staging)
+    {
+        {
+            std::lock_guard<LogMutex> lock(staging->wake_mutex);
+            staging->stop = true;
+        }
+        staging->wake.notify_one();
+        staging->merger.join();
+        merge_staged(); // Строки, добавленные после последнего слияния
+
+        // Буферы живых потоков остаются в их кэшах до следующей записи: память освобождается сейчас
+        std::lock_guard<LogMutex> lock(staging->registry_mutex);
+        for (auto& buffer : staging->buffers)
+        {
+            std::lock_guard<LogMutex> buffer_lock(buffer->mutex);
+            std::string().swap(buffer->data);
+            std::string().swap(buffer->taken);
+            std::vector<StagedRecord>().swap(buffer->records);
+            std::vector<StagedRecord>().swap(buffer->taken_records);
+            buffer->retired.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    compressor.reset(); // Дописываем накопленные сжатые блоки до закрытия файла
+
+    std::lock_guard<LogMutex> lock(log_mutex); // Защита от гонки данных
     if (log_file.is_open())
         log_file.close();    // Закрытие файла при уничтожении объекта
+
+    if (index_file.is_open())
+    {
+        write_index_block(); // Сохранение последнего неполного блока
+        index_file.close();
+    }
+}
+
+// Включение индекса: файл индекса дополняется, смещения считаются от текущего конца журнала
+LoggerError FileLogger::enable_index(size_t every_records, int every_seconds)
+{
+    std::lock_guard<LogMutex> lock(log_mutex);
+    if (index_file.is_open())
+        return LoggerError::NONE;
+    if (compressor)
+        return LoggerError::FILE_OPEN_FAILED; // Смещения в сжатом файле не соответствуют строкам
+
+    std::string index_name = name + ".idx";
+    std::error_code ec;
+    bool is_new = !std::filesystem::exists(index_name, ec) || std::filesystem::file_size(index_name, ec) == 0;
+
+    index_file.open(index_name, std::ios::out | std::ios::app | std::ios::binary);
+    if (!index_file.is_open())
+        return LoggerError::FILE_OPEN_FAILED;
+
+    if (is_new)
+        index_file.write(LOG_INDEX_MAGIC, sizeof(LOG_INDEX_MAGIC));
+
+    auto size = std::filesystem::file_size(name, ec);
+    file_offset = ec ? 0 : size;
+    index_records = every_records > 0 ? every_records : 1;
+    index_seconds = every_seconds > 0 ? every_seconds : 1;
+    block = LogIndexEntry{};
+    return LoggerError::NONE;
+}
+
+// Включение сжатия: файл пишет только фоновый поток компрессора
+LoggerError FileLogger::enable_compression(size_t block_size)
+{
+    std::lock_guard<LogMutex> lock(log_mutex);
+    if (compressor)
+        return LoggerError::NONE;
+    if (index_file.is_open())
+        return LoggerError::FILE_OPEN_FAILED;
+
+    if (log_file.is_open())
+        log_file.close();
+    log_file.open(name, std::ios::out | std::ios::app | std::ios::binary);
+    if (!log_file.is_open())
+        return LoggerError::FILE_OPEN_FAILED;
+    sync_handle.open(name);
+
+    compressor = std::make_unique<BlockCompressor>([this](const char* data, size_t size)
+    {
+        log_file.write(data, size);
+        log_file.flush();
+        return !log_file.fail();
+    }, block_size);
+    return LoggerError::NONE;
+}
+
+// Включение буферов потоков: дальше строки попадают в файл только через merge_staged
+LoggerError FileLogger::enable_staging(size_t buffer_size, std::chrono::milliseconds interval)
+{
+    std::lock_guard<LogMutex> lock(log_mutex);
+    if (staging)
+        return LoggerError::NONE;
+
+    staging = std::make_unique<StagingState>();
+    staging->id = staging_ids.fetch_add(1, std::memory_order_relaxed);
+    staging->buffer_size = buffer_size > 0 ? buffer_size : 64 * 1024;
+    staging->interval = interval.count() > 0 ? interval : std::chrono::milliseconds(10);
+    staging->merger = std::thread(&FileLogger::staging_loop, this);
+    return LoggerError::NONE;
+}
+
+// Запись в буфер текущего потока
+LoggerError FileLogger::stage_line(const std::string& line, LogLevel level, std::chrono::system_clock::time_point time)
+{
+    StagingBuffer* buffer = nullptr;
+    auto& entries = staging_cache.entries;
+    for (size_t i = 0; i < entries.size();)
+    {
+        if (entries[i].second->retired.load(std::memory_order_relaxed))
+        {
+            entries[i] = std::move(entries.back());
+            entries.pop_back();
+            continue;
+        }
+        if (entries[i].first == staging->id)
+            buffer = entries[i].second.get();
+        ++i;
+    }
+    if (!buffer)
+    {
+        // Первая запись потока: регистрация буфера
+        auto created = std::make_shared<StagingBuffer>();
+        {
+            std::lock_guard<LogMutex> lock(staging->registry_mutex);
+            staging->buffers.push_back(created);
+        }
+        staging_cache.entries.emplace_back(staging->id, created);
+        buffer = created.get();
+    }
+
+    size_t size = 0;
+    {
+        std::lock_guard<LogMutex> lock(buffer->mutex);
+        int64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+        buffer->records.push_back(StagedRecord{ns, buffer->data.size(), static_cast<uint32_t>(line.size()), level});
+        buffer->data.append(line);
+        size = buffer->data.size();
+    }
+
+    if (size >= staging->buffer_size)
+    {
+        // Слияние не успевает за потоком: запись выполняет сам поток
+        if (size >= 4 * staging->buffer_size)
+            return merge_staged();
+        staging->wake.notify_one();
+    }
+    return LoggerError::NONE;
+}
+
+// Слияние: буферы потоков снимаются обменом, строки упорядочиваются по времени
+// (k-путевое слияние, внутри потока порядок сохраняется) и пишутся одним блоком
+LoggerError FileLogger::merge_staged()
+{
+    std::lock_guard<LogMutex> merge_lock(staging->merge_mutex);
+
+    std::vector<std::shared_ptr<StagingBuffer>> buffers;
+    {
+        std::lock_guard<LogMutex> lock(staging->registry_mutex);
+        buffers = staging->buffers;
+    }
+
+    size_t total = 0;
+    std::vector<bool> finished(buffers.size());
+    for (size_t i = 0; i < buffers.size(); ++i)
+    {
+        // Признак читается до обмена: после него в буфере гарантированно ничего не останется
+        finished[i] = buffers[i]->orphaned.load(std::memory_order_acquire);
+        std::lock_guard<LogMutex> lock(buffers[i]->mutex);
+        buffers[i]->data.swap(buffers[i]->taken);
+        buffers[i]->records.swap(buffers[i]->taken_records);
+        total += buffers[i]->taken.size();
+    }
+
+    // Буферы завершившихся потоков больше не нужны
+    if (std::find(finished.begin(), finished.end(), true) != finished.end())
+    {
+        std::lock_guard<LogMutex> lock(staging->registry_mutex);
+        for (size_t i = 0; i < buffers.size(); ++i)
+        {
+            if (finished[i])
+                staging->buffers.erase(std::find(staging->buffers.begin(), staging->buffers.end(), buffers[i]));
+        }
+    }
+    if (total == 0)
+        return LoggerError::NONE;
+
+    struct Head
+    {
+        int64_t time;
+        size_t run, pos;
+    };
+    auto later = [](const Head& a, const Head& b) { return a.time > b.time || (a.time == b.time && a.run > b.run); };
+    std::priority_queue<Head, std::vector<Head>, decltype(later)> heads(later);
+    for (size_t i = 0; i < buffers.size(); ++i)
+    {
+        if (!buffers[i]->taken_records.empty())
+            heads.push(Head{buffers[i]->taken_records[0].time, i, 0});
+    }
+
+    std::lock_guard<LogMutex> lock(log_mutex);
+    std::string& merged = staging->merged;
+    merged.clear();
+    merged.reserve(total);
+    while (!heads.empty())
+    {
+        Head head = heads.top();
+        heads.pop();
+        StagingBuffer& run = *buffers[head.run];
+        const StagedRecord& record = run.taken_records[head.pos];
+        merged.append(run.taken, record.offset, record.length);
+        if (index_file.is_open())
+            index_record(static_cast<std::time_t>(record.time / 1000000000), record.level, record.length);
+
+        if (++head.pos < run.taken_records.size())
+        {
+            head.time = run.taken_records[head.pos].time;
+            heads.push(head);
+        }
+    }
+    for (auto& buffer : buffers)
+    {
+        buffer->taken.clear();
+        buffer->taken_records.clear();
+    }
+
+    if (compressor)
+    {
+        compressor->append(merged.data(), merged.size());
+        return compressor->failed() ? LoggerError::WRITE_FAILED : LoggerError::NONE;
+    }
+
+    if (!log_file.is_open())
+    {
+        log_file.open(name, std::ios::out | std::ios::app);
+        if (!log_file.is_open())
+            return LoggerError::FILE_OPEN_FAILED;
+        sync_handle.open(name);
+    }
+    log_file.write(merged.data(), merged.size());
+    log_file.flush();
+    return log_file.fail() ? LoggerError::WRITE_FAILED : LoggerError::NONE;
+}
+
+void FileLogger::staging_loop()
+{
+    LogUniqueLock lock(staging->wake_mutex);
+    while (!staging->stop)
+    {
+        staging->wake.wait_for(lock, staging->interval);
+        lock.unlock();
+        merge_staged();
+        lock.lock();
+    }
+}
+
+// Учет записи: блок закрывается по числу записей или по времени
+void FileLogger::index_record(std::time_t time, LogLevel level, size_t size)
+{
+    if (block.records > 0 && time - block.first_time >= index_seconds)
+        write_index_block();
+
+    if (block.records == 0)
+    {
+        block.offset = file_offset;
+        block.first_time = time;
+    }
+
+    // Время, переданное через log_at, может немного отличаться от порядка записей
+    block.first_time = std::min<int64_t>(block.first_time, time);
+    block.last_time = std::max<int64_t>(block.last_time, time);
+    block.length += size;
+    block.counts[static_cast<int>(level)]++;
+    block.records++;
+    file_offset += size;
+
+    if (block.records >= index_records)
+        write_index_block();
+}
+
+void FileLogger::write_index_block()
+{
+    if (block.records == 0)
+        return;
+
+    index_file.write(reinterpret_cast<const char*>(&block), sizeof(block));
+    index_file.flush();
+    block = LogIndexEntry{};
 }
 
 // Основной метод логирования
 LoggerError FileLogger::log(const std::string& msg, LogLevel level)
 {
-    if (level < log_level) return LoggerError::NONE; // Пропуск сообщений ниже установленного уровня
+    if (level < log_level.load(std::memory_order_relaxed)) return LoggerError::NONE; // Пропуск сообщений ниже установленного уровня
+    return log_at(msg, level, std::chrono::system_clock::now());
+}
+
+// Запись с заданным временем
+LoggerError FileLogger::log_at(const std::string& msg, LogLevel level, std::chrono::system_clock::time_point time)
+{
+    if (level < log_level.load(std::memory_order_relaxed)) return LoggerError::NONE; // Пропуск сообщений ниже установленного уровня
+    return log_record(StructuredRecord(msg, level, time));
+}
+
+// Структурированная запись: поля в JSON или в виде key=value в тексте.
+// Строка форматируется вне мьютекса в буфере потока, который переиспользуется между записями
+LoggerError FileLogger::log_record(const StructuredRecord& record)
+{
+    if (record.get_level() < log_level.load(std::memory_order_relaxed)) return LoggerError::NONE;
+
+    thread_local std::string line;
+    line.clear();
+    format_line(record, get_format(), layout.get(), line);
+    return write_line(line, record.get_level(), record.get_time());
+}
+
+// Запись готовой строки (с переводом строки)
+LoggerError FileLogger::write_line(const std::string& line, LogLevel level, std::chrono::system_clock::time_point time)
+{
+    if (staging)
+        return stage_line(line, level, time);
+
+    if (compressor)
+    {
+        // Сжатый режим: в вызывающем потоке только копирование в блок
+        compressor->append(line.data(), line.size());
+        return compressor->failed() ? LoggerError::WRITE_FAILED : LoggerError::NONE;
+    }
 
-    std::lock_guard<std::mutex> lock(log_mutex); // Потокобезопасность
+    std::lock_guard<LogMutex> lock(log_mutex); // Потокобезопасность
     if (!log_file.is_open()) 
     {
         // Открытие файла в режиме добавления 
         log_file.open(name, std::ios::out | std::ios::app);
         if (!log_file.is_open()) 
             return LoggerError::FILE_OPEN_FAILED; // Ошибка открытия файла
+        sync_handle.open(name);
     }
 
-    // Форматирование и запись сообщения
-    log_file << msg_format(level, msg) << std::endl;
+    log_file.write(line.data(), line.size());
 
     if (log_file.fail())
         return LoggerError::WRITE_FAILED; // Ошибка записи
 
     log_file.flush(); // Принудительная запись в файл
+
+    if (index_file.is_open())
+        index_record(std::chrono::system_clock::to_time_t(time), level, line.size());
+
     return LoggerError::NONE; // Успешное выполнение
 }
 
+// Сброс буферов: в сжатом режиме закрывается текущий блок
+LoggerError FileLogger::flush()
+{
+    if (staging)
+    {
+        LoggerError result = merge_staged();
+        if (result != LoggerError::NONE)
+            return result;
+    }
+
+    if (compressor)
+    {
+        compressor->flush();
+        return compressor->failed() ? LoggerError::WRITE_FAILED : LoggerError::NONE;
+    }
+
+    std::lock_guard<LogMutex> lock(log_mutex);
+    if (log_file.is_open())
+        log_file.flush();
+    return log_file.fail() ? LoggerError::WRITE_FAILED : LoggerError::NONE;
+}
+
+// fsync через дескриптор, открытый вместе с потоком записи: повторное открытие по имени
+// после ротации попало бы в новый файл, а данные старого остались бы несброшенными
+LoggerError FileLogger::sync()
+{
+    LoggerError result = flush();
+    if (result != LoggerError::NONE)
+        return result;
+
+    std::lock_guard<LogMutex> lock(log_mutex);
+    return sync_handle.sync();
+}
+
+void SyncHandle::open(const std::string& file_name)
+{
+    reset();
+    fd = ::open(file_name.c_str(), O_WRONLY | O_APPEND | O_CLOEXEC);
+}
+
+void SyncHandle::reset()
+{
+    if (fd != -1)
+        ::close(fd);
+    fd = -1;
+}
+
+LoggerError SyncHandle::sync() const
+{
+    if (fd == -1)
+        return LoggerError::FILE_OPEN_FAILED;
+    return ::fsync(fd) == 0 ? LoggerError::NONE : LoggerError::WRITE_FAILED;
+}
+
 // Фабричный метод для создания файлового логгера
 std::unique_ptr<Logger> create_file_logger(const std::string& file_name, LogLevel level)
 {
     return  std::make_unique<FileLogger>(file_name, level);
-}
\ No newline at end of file
+}
@@ -0,0 +1,258 @@
+#include "flight_recorder.h"
+#include "mapped_file.h"
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    const uint32_t RECORD_MAGIC = 0x31434552; // "REC1"
+    const size_t ALIGN = 8;
+
+    // Заголовок записи; поле committed пишется последним
+    struct RecordHeader
+    {
+        uint32_t magic;
+        uint32_t size;      // Полный размер записи с выравниванием
+        uint64_t seq;
+        int64_t time_ns;
+        uint32_t level;
+        uint32_t msg_len;
+        uint32_t checksum;  // FNV-1a по номеру и тексту
+        uint32_t committed; // 1 - запись завершена
+    };
+
+    uint32_t checksum(uint64_t seq, const char* msg, size_t len)
+    {
+        uint32_t hash = 2166136261u;
+        for (int i = 0; i < 8; ++i)
+            hash = (hash ^ static_cast<uint8_t>(seq >> (8 * i))) * 16777619u;
+        for (size_t i = 0; i < len; ++i)
+            hash = (hash ^ static_cast<uint8_t>(msg[i])) * 16777619u;
+        return hash;
+    }
+
+    std::atomic<FlightRecorder*> signal_recorder{nullptr}; // Самописец для обработчиков сигналов
+    const int crash_signals[] = {SIGSEGV, SIGABRT, SIGTERM, SIGBUS};
+    std::atomic<int> pending_signal{0};    // Отложенный SIGTERM
+    int wake_pipe[2] = {-1, -1};           // self-pipe: пробуждение основного цикла
+}
+
+FlightRecorder::FlightRecorder(const std::string& file_name, size_t size_mb, LogLevel level)
+    : name(file_name), capacity(std::max<size_t>(size_mb, 1) << 20), log_level(level)
+{}
+
+FlightRecorder::~FlightRecorder()
+{
+    FlightRecorder* self = this;
+    signal_recorder.compare_exchange_strong(self, nullptr);
+
+    if (header)
+        munmap(header, sizeof(FlightHeader) + capacity);
+    if (fd != -1)
+        close(fd);
+}
+
+// Существующее кольцо того же размера продолжается, иначе файл создается заново
+LoggerError FlightRecorder::init()
+{
+    if (header)
+        return LoggerError::NONE;
+
+    fd = open(name.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd == -1)
+        return LoggerError::FILE_OPEN_FAILED;
+
+    size_t total = sizeof(FlightHeader) + capacity;
+    struct stat st{};
+    bool reuse = fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) == total;
+    if (!reuse && ftruncate(fd, total) == -1)
+    {
+        close(fd);
+        fd = -1;
+        return LoggerError::FILE_OPEN_FAILED;
+    }
+
+    void* ptr = mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (ptr == MAP_FAILED)
+    {
+        close(fd);
+        fd = -1;
+        return LoggerError::FILE_OPEN_FAILED;
+    }
+
+    header = static_cast<FlightHeader*>(ptr);
+    data = static_cast<char*>(ptr) + sizeof(FlightHeader);
+
+    if (!reuse || std::memcmp(header->magic, FLIGHT_MAGIC, sizeof(FLIGHT_MAGIC)) != 0 ||
+        header->capacity != capacity)
+    {
+        std::memset(ptr, 0, sizeof(FlightHeader));
+        header->capacity = capacity;
+        header->cursor.store(0);
+        header->seq.store(0);
+        std::memcpy(header->magic, FLIGHT_MAGIC, sizeof(FLIGHT_MAGIC));
+    }
+    return LoggerError::NONE;
+}
+
+bool FlightRecorder::record(const char* msg, size_t len, LogLevel level)
+{
+    if (!header)
+        return false;
+
+    len = std::min(len, capacity / 4 - sizeof(RecordHeader)); // Длинные сообщения обрезаются
+    size_t size = (sizeof(RecordHeader) + len + ALIGN - 1) & ~(ALIGN - 1);
+
+    // Резервирование места: запись не переходит через конец кольца
+    uint64_t cursor = header->cursor.load(std::memory_order_relaxed);
+    uint64_t offset, next;
+    do
+    {
+        offset = cursor % capacity;
+        next = offset + size > capacity ? cursor + (capacity - offset) + size : cursor + size;
+    } while (!header->cursor.compare_exchange_weak(cursor, next, std::memory_order_relaxed));
+    if (offset + size > capacity)
+    {
+        // Хвост, пропущенный при переходе в начало, очищается от записей позапрошлого круга
+        std::memset(data + offset, 0, capacity - offset);
+        offset = 0;
+    }
+
+    timespec ts{};
+    clock_gettime(CLOCK_REALTIME, &ts); // Безопасна в обработчике сигнала
+
+    auto* rec = reinterpret_cast<RecordHeader*>(data + offset);
+    __atomic_store_n(&rec->committed, 0, __ATOMIC_RELAXED);
+    rec->magic = RECORD_MAGIC;
+    rec->size = static_cast<uint32_t>(size);
+    rec->seq = header->seq.fetch_add(1, std::memory_order_relaxed);
+    rec->time_ns = static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+    rec->level = static_cast<uint32_t>(level);
+    rec->msg_len = static_cast<uint32_t>(len);
+    std::memcpy(rec + 1, msg, len);
+    rec->checksum = checksum(rec->seq, msg, len);
+    __atomic_store_n(&rec->committed, 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+LoggerError FlightRecorder::log(const std::string& msg, LogLevel level)
+{
+    if (level < log_level.load(std::memory_order_relaxed)) return LoggerError::NONE;
+    return record(msg.data(), msg.size(), level) ? LoggerError::NONE : LoggerError::FILE_OPEN_FAILED;
+}
+
+// В обработчике только запись в кольцо (атомики и memcpy) и повторная генерация сигнала.
+// SIGTERM не аварийный: завершение откладывается, пока основной цикл не допишет очередь
+void FlightRecorder::signal_handler(int sig)
+{
+    int saved_errno = errno;
+    if (FlightRecorder* recorder = signal_recorder.load())
+    {
+        const char* text = sig == SIGTERM ? "завершение по сигналу " : "аварийное завершение: сигнал ";
+        char msg[64];
+        size_t len = std::strlen(text);
+        std::memcpy(msg, text, len);
+        if (sig >= 10)
+            msg[len++] = static_cast<char>('0' + sig / 10 % 10);
+        msg[len++] = static_cast<char>('0' + sig % 10);
+        recorder->record(msg, len, LogLevel::ERROR);
+    }
+
+    if (sig == SIGTERM)
+    {
+        pending_signal.store(sig);
+        char byte = 0;
+        if (wake_pipe[1] != -1)
+            (void)!write(wake_pipe[1], &byte, 1);
+        errno = saved_errno;
+        return;
+    }
+
+    signal(sig, SIG_DFL);
+    raise(sig);
+}
+
+void FlightRecorder::install_signal_handlers(FlightRecorder* recorder)
+{
+    signal_recorder.store(recorder);
+    if (wake_pipe[0] == -1 && pipe2(wake_pipe, O_NONBLOCK | O_CLOEXEC) == -1)
+        wake_pipe[0] = wake_pipe[1] = -1;
+
+    // Без SA_RESTART: блокирующее чтение основного потока прерывается с EINTR
+    struct sigaction action{};
+    action.sa_handler = &FlightRecorder::signal_handler;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESETHAND;
+    for (int sig : crash_signals)
+        sigaction(sig, &action, nullptr);
+}
+
+int FlightRecorder::termination_signal()
+{
+    return pending_signal.load();
+}
+
+int FlightRecorder::termination_fd()
+{
+    return wake_pipe[0];
+}
+
+void FlightRecorder::finish_termination()
+{
+    int sig = pending_signal.load();
+    if (sig == 0)
+        return;
+    signal(sig, SIG_DFL);
+    raise(sig);
+}
+
+// Просмотр всей области данных: берутся только завершенные записи с верной контрольной суммой
+bool FlightRecorder::recover(const std::string& file_name, std::vector<RecoveredRecord>& records)
+{
+    MappedFile file;
+    if (!file.open(file_name) || file.size() < sizeof(FlightHeader))
+        return false;
+
+    const auto* head = reinterpret_cast<const FlightHeader*>(file.data());
+    if (std::memcmp(head->magic, FLIGHT_MAGIC, sizeof(FLIGHT_MAGIC)) != 0 ||
+        head->capacity != file.size() - sizeof(FlightHeader))
+        return false;
+
+    const char* area = file.data() + sizeof(FlightHeader);
+    size_t cap = head->capacity;
+    for (size_t pos = 0; pos + sizeof(RecordHeader) <= cap; pos += ALIGN)
+    {
+        const auto* rec = reinterpret_cast<const RecordHeader*>(area + pos);
+        if (rec->magic != RECORD_MAGIC || rec->committed != 1 || rec->level > 2 ||
+            rec->size > cap - pos || sizeof(RecordHeader) + rec->msg_len > rec->size)
+            continue;
+
+        const char* msg = reinterpret_cast<const char*>(rec + 1);
+        if (checksum(rec->seq, msg, rec->msg_len) != rec->checksum)
+            continue; // Запись повреждена или частично перезаписана
+
+        records.push_back(RecoveredRecord{rec->seq, rec->time_ns, static_cast<LogLevel>(rec->level),
+                                          std::string(msg, rec->msg_len)});
+        pos += rec->size - ALIGN;
+    }
+
+    std::sort(records.begin(), records.end(),
+              [](const RecoveredRecord& a, const RecoveredRecord& b) { return a.seq < b.seq; });
+    return true;
+}
+
+// Фабричный метод для создания самописца
+std::unique_ptr<FlightRecorder> create_flight_recorder(const std::string& file_name, size_t size_mb, LogLevel level)
+{
+    auto recorder = std::make_unique<FlightRecorder>(file_name, size_mb, level);
+    if (recorder->init() != LoggerError::NONE)
+        return nullptr;
+    return recorder;
+}
@@ -0,0 +1,103 @@
+#include "lock_profiler.h"
+#include <iomanip>
+
+namespace
+{
+    std::mutex registry_mutex;                 // Регистрация мест блокировки (только в конструкторах)
+    std::atomic<LockStats*> lock_sites{nullptr};
+
+    size_t bucket(uint64_t ns)
+    {
+        size_t index = 0;
+        for (ns >>= 9; ns > 0 && index + 1 < LockStats::BUCKETS; ns >>= 1)
+            ++index;
+        return index;
+    }
+}
+
+// Статистика общая для всех мьютексов с данным именем и не удаляется
+ProfiledMutex::ProfiledMutex(const char* name)
+{
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    for (LockStats* site = lock_sites.load(std::memory_order_acquire); site; site = site->next)
+        if (site->name == name)
+        {
+            stats = site;
+            return;
+        }
+
+    stats = new LockStats;
+    stats->name = name;
+    stats->next = lock_sites.load(std::memory_order_relaxed);
+    lock_sites.store(stats, std::memory_order_release);
+}
+
+void ProfiledMutex::lock_contended()
+{
+    auto start = std::chrono::steady_clock::now();
+    mutex.lock();
+    uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    stats->contended.fetch_add(1, std::memory_order_relaxed);
+    stats->wait_ns.fetch_add(ns, std::memory_order_relaxed);
+    stats->histogram[bucket(ns)].fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t max = stats->max_wait_ns.load(std::memory_order_relaxed);
+    while (ns > max && !stats->max_wait_ns.compare_exchange_weak(max, ns, std::memory_order_relaxed))
+        ;
+}
+
+void lock_profile_report(std::ostream& out)
+{
+    auto flags = out.flags();
+    auto precision = out.precision();
+    out << std::fixed << std::setprecision(1);
+
+    for (LockStats* site = lock_sites.load(std::memory_order_acquire); site; site = site->next)
+    {
+        uint64_t total = site->acquisitions.load(std::memory_order_relaxed);
+        if (total == 0)
+            continue;
+
+        uint64_t contended = site->contended.load(std::memory_order_relaxed);
+        uint64_t wait = site->wait_ns.load(std::memory_order_relaxed);
+        out << site->name << ": захватов " << total << ", с ожиданием " << contended << " ("
+            << 100.0 * contended / total << "%)"
+            << ", ожидание среднее " << (contended ? wait / contended / 1000.0 : 0.0) << " мкс"
+            << ", макс " << site->max_wait_ns.load(std::memory_order_relaxed) / 1000.0 << " мкс" << std::endl;
+
+        // Гистограмма: верхняя граница корзины и число ожиданий
+        for (size_t i = 0; i < LockStats::BUCKETS; ++i)
+        {
+            uint64_t count = site->histogram[i].load(std::memory_order_relaxed);
+            if (count == 0)
+                continue;
+            out << "  " << (i + 1 < LockStats::BUCKETS ? "< " : ">= ")
+                << ((uint64_t(1) << (i + (i + 1 < LockStats::BUCKETS ? 9 : 8))) / 1000.0) << " мкс: " << count << std::endl;
+        }
+    }
+
+    out.flags(flags);
+    out.precision(precision);
+}
+
+void lock_profile_reset()
+{
+    for (LockStats* site = lock_sites.load(std::memory_order_acquire); site; site = site->next)
+    {
+        site->acquisitions.store(0, std::memory_order_relaxed);
+        site->contended.store(0, std::memory_order_relaxed);
+        site->wait_ns.store(0, std::memory_order_relaxed);
+        site->max_wait_ns.store(0, std::memory_order_relaxed);
+        for (auto& count : site->histogram)
+            count.store(0, std::memory_order_relaxed);
+    }
+}
+
+const LockStats* lock_profile_find(const std::string& name)
+{
+    for (LockStats* site = lock_sites.load(std::memory_order_acquire); site; site = site->next)
+        if (site->name == name)
+            return site;
+    return nullptr;
+}
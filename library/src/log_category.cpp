@@ -0,0 +1,92 @@
+#include "log_category.h"
+
+LogCategory::LogCategory(CategoryRegistry& registry, const std::string& name, LogCategory* parent)
+    : registry(registry), name(name), prefix(name.empty() ? "" : "[" + name + "] "), parent(parent),
+      log_level(parent ? parent->get_log_level() : LogLevel::INFO)
+{}
+
+LoggerError LogCategory::log(const std::string& msg, LogLevel level)
+{
+    if (!is_enabled(level)) return LoggerError::NONE;
+    return registry.sink->log(prefix + msg, level);
+}
+
+LoggerError LogCategory::log_at(const std::string& msg, LogLevel level, std::chrono::system_clock::time_point time)
+{
+    if (!is_enabled(level)) return LoggerError::NONE;
+    return registry.sink->log_at(prefix + msg, level, time);
+}
+
+void LogCategory::set_log_level(LogLevel level)
+{
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    own_level = true;
+    registry.propagate(*this, level);
+}
+
+void LogCategory::reset_log_level()
+{
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    if (!parent)
+        return; // У корня уровень всегда свой
+
+    own_level = false;
+    registry.propagate(*this, parent->get_log_level());
+}
+
+CategoryRegistry::CategoryRegistry(std::shared_ptr<Logger> sink, LogLevel root_level)
+    : sink(std::move(sink))
+{
+    auto root = std::unique_ptr<LogCategory>(new LogCategory(*this, "", nullptr));
+    root->own_level = true;
+    root->log_level.store(root_level);
+    root_category = root.get();
+    categories.emplace("", std::move(root));
+}
+
+LogCategory& CategoryRegistry::get(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = categories.find(name);
+    if (it != categories.end())
+        return *it->second;
+
+    // Создание цепочки от ближайшего существующего предка
+    LogCategory* parent = root_category;
+    size_t pos = 0;
+    while (true)
+    {
+        size_t dot = name.find('.', pos);
+        std::string part = name.substr(0, dot);
+
+        auto found = categories.find(part);
+        if (found == categories.end())
+        {
+            auto category = std::unique_ptr<LogCategory>(new LogCategory(*this, part, parent));
+            parent->children.push_back(category.get());
+            found = categories.emplace(part, std::move(category)).first;
+        }
+        parent = found->second.get();
+
+        if (dot == std::string::npos)
+            return *parent;
+        pos = dot + 1;
+    }
+}
+
+std::vector<std::string> CategoryRegistry::names()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<std::string> result;
+    for (const auto& category : categories)
+        result.push_back(category.first);
+    return result;
+}
+
+void CategoryRegistry::propagate(LogCategory& category, LogLevel level)
+{
+    category.log_level.store(level, std::memory_order_relaxed);
+    for (LogCategory* child : category.children)
+        if (!child->own_level)
+            propagate(*child, level);
+}
@@ -0,0 +1,548 @@
+#include "log_config.h"
+#include "log_parser.h"
+#include "file_logger.h"
+#include "binary_file_logger.h"
+#include "socket_logger.h"
+#include "uring_file_logger.h"
+#include "dedup_logger.h"
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+namespace
+{
+    std::string trim(const std::string& str)
+    {
+        size_t begin = str.find_first_not_of(" \t\r");
+        if (begin == std::string::npos)
+            return "";
+        size_t end = str.find_last_not_of(" \t\r");
+        return str.substr(begin, end - begin + 1);
+    }
+
+    bool parse_level_value(std::string value, LogLevel& level)
+    {
+        std::transform(value.begin(), value.end(), value.begin(), [](unsigned char c) { return std::toupper(c); });
+        return parse_level_name(value, level);
+    }
+
+    bool parse_size_value(const std::string& value, size_t& size)
+    {
+        if (value == "off" || value == "no")
+        {
+            size = 0;
+            return true;
+        }
+        if (value.empty() || !std::all_of(value.begin(), value.end(), ::isdigit))
+            return false;
+        size = std::strtoull(value.c_str(), nullptr, 10);
+        return true;
+    }
+}
+
+bool parse_log_config(std::istream& input, LogConfig& config, std::string& error)
+{
+    enum class Section { GLOBAL, SINK, CATEGORY } section = Section::GLOBAL;
+    std::string category;
+    LogConfig result;
+    std::string line;
+    int line_no = 0;
+
+    auto fail = [&](const std::string& reason)
+    {
+        error = "строка " + std::to_string(line_no) + ": " + reason;
+        return false;
+    };
+
+    while (std::getline(input, line))
+    {
+        ++line_no;
+        size_t comment = line.find_first_of("#;");
+        line = trim(line.substr(0, comment));
+        if (line.empty())
+            continue;
+
+        // Заголовок секции: [sink <name>] или [category <name>]
+        if (line.front() == '[')
+        {
+            if (line.back() != ']')
+                return fail("незакрытая секция");
+
+            std::string header = trim(line.substr(1, line.size() - 2));
+            size_t space = header.find(' ');
+            std::string kind = header.substr(0, space);
+            std::string name = space == std::string::npos ? "" : trim(header.substr(space + 1));
+            if (name.empty())
+                return fail("у секции нет имени");
+
+            if (kind == "sink")
+            {
+                for (const auto& sink : result.sinks)
+                    if (sink.name == name)
+                        return fail("повторное имя приемника " + name);
+                section = Section::SINK;
+                result.sinks.emplace_back();
+                result.sinks.back().name = name;
+            }
+            else if (kind == "category")
+            {
+                section = Section::CATEGORY;
+                category = name;
+                result.categories[category] = LogLevel::INFO;
+            }
+            else
+                return fail("неизвестная секция " + kind);
+            continue;
+        }
+
+        size_t eq = line.find('=');
+        if (eq == std::string::npos)
+            return fail("ожидается ключ = значение");
+        std::string key = trim(line.substr(0, eq));
+        std::string value = trim(line.substr(eq + 1));
+
+        if (section == Section::GLOBAL || section == Section::CATEGORY)
+        {
+            LogLevel& level = section == Section::GLOBAL ? result.level : result.categories[category];
+            if (key != "level")
+                return fail("неизвестный ключ " + key);
+            if (!parse_level_value(value, level))
+                return fail("неизвестный уровень " + value);
+            continue;
+        }
+
+        SinkConfig& sink = result.sinks.back();
+        if (key == "type")
+        {
+            if (value != "file" && value != "binary" && value != "socket" && value != "uring")
+                return fail("неизвестный тип приемника " + value);
+            sink.type = value;
+        }
+        else if (key == "path")
+            sink.path = value;
+        else if (key == "host")
+            sink.host = value;
+        else if (key == "port")
+        {
+            sink.port = std::atoi(value.c_str());
+            if (sink.port <= 0 || sink.port > 65535)
+                return fail("некорректный порт " + value);
+        }
+        else if (key == "level")
+        {
+            if (!parse_level_value(value, sink.level))
+                return fail("неизвестный уровень " + value);
+        }
+        else if (key == "compression")
+        {
+            if (!parse_size_value(value, sink.compression))
+                return fail("некорректный размер блока " + value);
+        }
+        else if (key == "index")
+        {
+            if (!parse_size_value(value, sink.index))
+                return fail("некорректный размер блока индекса " + value);
+        }
+        else if (key == "staging")
+        {
+            if (!parse_size_value(value, sink.staging))
+                return fail("некорректный размер буфера " + value);
+        }
+        else if (key == "format")
+        {
+            if (value == "text")
+                sink.format = LogFormat::TEXT;
+            else if (value == "json")
+                sink.format = LogFormat::JSON;
+            else
+                return fail("неизвестный формат " + value);
+        }
+        else if (key == "layout")
+        {
+            std::string reason;
+            if (!PatternLayout::compile(value, sink.name, &reason))
+                return fail("некорректный шаблон " + value + ": " + reason);
+            sink.layout = value;
+        }
+        else if (key == "dedup")
+        {
+            size_t timeout = 0;
+            if (!parse_size_value(value, timeout))
+                return fail("некорректный таймаут " + value);
+            sink.dedup = static_cast<int>(timeout);
+        }
+        else
+            return fail("неизвестный ключ " + key);
+    }
+
+    // Проверка полноты описаний приемников
+    for (const auto& sink : result.sinks)
+    {
+        if (sink.type == "socket" ? (sink.host.empty() || sink.port == 0) : sink.path.empty())
+        {
+            error = "приемник " + sink.name + ": указаны не все параметры";
+            return false;
+        }
+        if (sink.type == "binary" && sink.format != LogFormat::TEXT)
+        {
+            error = "приемник " + sink.name + ": формат задается только для file и socket";
+            return false;
+        }
+        if (sink.type == "binary" && !sink.layout.empty())
+        {
+            error = "приемник " + sink.name + ": шаблон задается только для file и socket";
+            return false;
+        }
+        if (sink.type == "uring" && sink.compression > 0)
+        {
+            error = "приемник " + sink.name + ": сжатие не поддерживается для type = uring";
+            return false;
+        }
+        if (sink.type != "file" && sink.staging > 0)
+        {
+            error = "приемник " + sink.name + ": буферы потоков поддерживаются только для type = file";
+            return false;
+        }
+        if (sink.type != "file" && sink.index > 0)
+        {
+            error = "приемник " + sink.name + ": индекс поддерживается только для type = file";
+            return false;
+        }
+    }
+
+    config = std::move(result);
+    return true;
+}
+
+bool load_log_config(const std::string& file_name, LogConfig& config, std::string& error)
+{
+    std::ifstream file(file_name);
+    if (!file.is_open())
+    {
+        error = "не удалось открыть " + file_name;
+        return false;
+    }
+    return parse_log_config(file, config, error);
+}
+
+std::unique_ptr<Logger> create_sink(const SinkConfig& config)
+{
+    std::unique_ptr<Logger> sink;
+    if (config.type == "file")
+    {
+        auto file = std::make_unique<FileLogger>(config.path, config.level);
+        file->set_format(config.format);
+        if (!config.layout.empty())
+            file->set_layout(PatternLayout::compile(config.layout, config.name));
+        if (config.index > 0 && file->enable_index(config.index) != LoggerError::NONE)
+            return nullptr;
+        if (config.compression > 0 && file->enable_compression(config.compression) != LoggerError::NONE)
+            return nullptr;
+        if (config.staging > 0 && file->enable_staging(config.staging) != LoggerError::NONE)
+            return nullptr;
+        sink = std::move(file);
+    }
+    else if (config.type == "binary")
+        sink = create_binary_file_logger(config.path, config.level);
+    else if (config.type == "uring")
+    {
+        auto uring = std::make_unique<UringFileLogger>(config.path, config.level);
+        uring->set_format(config.format);
+        if (!config.layout.empty())
+            uring->set_layout(PatternLayout::compile(config.layout, config.name));
+        if (uring->init() != LoggerError::NONE)
+            return nullptr;
+        sink = std::move(uring);
+    }
+    else if (config.type == "socket")
+    {
+        auto socket = std::make_unique<SocketLogger>(config.host, config.port, config.level);
+        socket->set_format(config.format);
+        if (!config.layout.empty())
+            socket->set_layout(PatternLayout::compile(config.layout, config.name));
+        if (socket->init() != LoggerError::NONE)
+            return nullptr;
+        if (config.compression > 0 && socket->enable_compression(config.compression) != LoggerError::NONE)
+            return nullptr;
+        sink = std::move(socket);
+    }
+
+    if (sink && config.dedup > 0)
+        sink = create_dedup_logger(std::move(sink), std::chrono::milliseconds(config.dedup));
+    return sink;
+}
+
+// Конструктор: пустой снимок до первой загрузки
+ConfigLogger::ConfigLogger(const std::string& file_name)
+    : file_name(file_name), current(std::make_shared<LogConfigSnapshot>()), log_level(LogLevel::INFO)
+{}
+
+ConfigLogger::~ConfigLogger()
+{
+    if (watcher.joinable())
+    {
+        char byte = 0;
+        (void)!::write(stop_pipe[1], &byte, 1);
+        watcher.join();
+    }
+
+    for (int fd : {inotify_fd, stop_pipe[0], stop_pipe[1]})
+        if (fd != -1)
+            ::close(fd);
+}
+
+// Запись во все приемники снимка; снимок удерживается до конца записи
+LoggerError ConfigLogger::log(const std::string& msg, LogLevel level)
+{
+    if (level < log_level.load(std::memory_order_relaxed)) return LoggerError::NONE;
+    return log_at(msg, level, std::chrono::system_clock::now());
+}
+
+LoggerError ConfigLogger::log_at(const std::string& msg, LogLevel level, std::chrono::system_clock::time_point time)
+{
+    if (level < log_level.load(std::memory_order_relaxed)) return LoggerError::NONE;
+    return write_all(msg, level, time);
+}
+
+LoggerError ConfigLogger::log_record(const StructuredRecord& record)
+{
+    if (record.get_level() < log_level.load(std::memory_order_relaxed)) return LoggerError::NONE;
+    return write_all(record);
+}
+
+LoggerError ConfigLogger::write_all(const std::string& msg, LogLevel level, std::chrono::system_clock::time_point time)
+{
+    auto config = snapshot();
+    LoggerError result = LoggerError::NONE;
+    for (const auto& sink : config->sinks)
+    {
+        LoggerError error = sink->log_at(msg, level, time);
+        if (error != LoggerError::NONE)
+            result = error; // Ошибка одного приемника не мешает остальным
+    }
+    return result;
+}
+
+LoggerError ConfigLogger::write_all(const StructuredRecord& record)
+{
+    auto config = snapshot();
+    LoggerError result = LoggerError::NONE;
+    for (const auto& sink : config->sinks)
+        if (LoggerError error = sink->log_record(record); error != LoggerError::NONE)
+            result = error;
+    return result;
+}
+
+// Вход для категорий: общий уровень не проверяется, установка уровня не действует
+class ConfigLogger::CategorySink : public Logger
+{
+public:
+    explicit CategorySink(ConfigLogger& owner) : owner(owner) {}
+
+    LoggerError log(const std::string& msg, LogLevel level) override
+    {
+        return owner.write_all(msg, level, std::chrono::system_clock::now());
+    }
+
+    LoggerError log_at(const std::string& msg, LogLevel level, std::chrono::system_clock::time_point time) override
+    {
+        return owner.write_all(msg, level, time);
+    }
+
+    LoggerError log_record(const StructuredRecord& record) override { return owner.write_all(record); }
+    LoggerError flush() override { return owner.flush(); }
+    LoggerError sync() override { return owner.sync(); }
+
+    void set_log_level(LogLevel) override {} // Фильтруют категории
+    LogLevel get_log_level() const override { return LogLevel::DEBUG; }
+    std::string get_type() const override { return "config-categories"; }
+
+private:
+    ConfigLogger& owner;
+};
+
+std::shared_ptr<Logger> ConfigLogger::category_sink()
+{
+    return std::make_shared<CategorySink>(*this);
+}
+
+LoggerError ConfigLogger::flush()
+{
+    LoggerError result = LoggerError::NONE;
+    for (const auto& sink : snapshot()->sinks)
+        if (LoggerError error = sink->flush(); error != LoggerError::NONE)
+            result = error;
+    return result;
+}
+
+LoggerError ConfigLogger::sync()
+{
+    LoggerError result = LoggerError::NONE;
+    for (const auto& sink : snapshot()->sinks)
+        if (LoggerError error = sink->sync(); error != LoggerError::NONE)
+            result = error;
+    return result;
+}
+
+// Построение нового снимка: приемники с прежними параметрами переиспользуются
+// (у них меняется только атомарный уровень), остальные создаются заново
+LoggerError ConfigLogger::load()
+{
+    LogConfig config;
+    std::string error;
+    if (!load_log_config(file_name, config, error))
+    {
+        std::cerr << "Ошибка конфигурации " << file_name << ": " << error << std::endl;
+        return LoggerError::FILE_OPEN_FAILED;
+    }
+
+    std::lock_guard<std::mutex> lock(reload_mutex);
+    auto old = snapshot();
+    auto next = std::make_shared<LogConfigSnapshot>();
+
+    for (const auto& sink_config : config.sinks)
+    {
+        std::shared_ptr<Logger> sink;
+        for (size_t i = 0; i < old->config.sinks.size(); ++i)
+            if (old->config.sinks[i].same_sink(sink_config))
+            {
+                sink = old->sinks[i];
+                sink->set_log_level(sink_config.level);
+                break;
+            }
+
+        if (!sink)
+            sink = create_sink(sink_config);
+        if (!sink)
+        {
+            std::cerr << "Ошибка конфигурации " << file_name << ": не удалось создать приемник "
+                      << sink_config.name << std::endl;
+            return LoggerError::FILE_OPEN_FAILED;
+        }
+        next->sinks.push_back(std::move(sink));
+    }
+
+    next->config = std::move(config);
+    next->version = old->version + 1;
+
+    std::atomic_store(&current, std::shared_ptr<const LogConfigSnapshot>(std::move(next)));
+    apply_levels(snapshot()->config);
+
+    // Новых ссылок на старый снимок больше не появится; последнюю отпустит release_retired
+    retired.push_back(std::move(old));
+    release_retired();
+    return LoggerError::NONE;
+}
+
+void ConfigLogger::release_retired()
+{
+    retired.erase(std::remove_if(retired.begin(), retired.end(),
+                                 [](const auto& snapshot) { return snapshot.use_count() == 1; }),
+                  retired.end());
+}
+
+void ConfigLogger::attach_categories(CategoryRegistry* registry)
+{
+    std::lock_guard<std::mutex> lock(reload_mutex);
+    categories = registry;
+    apply_levels(snapshot()->config);
+}
+
+void ConfigLogger::apply_levels(const LogConfig& config)
+{
+    // Записи категорий идут через category_sink() мимо общего уровня, поэтому он остается
+    // уровнем из файла и для записей мимо категорий
+    log_level.store(config.level, std::memory_order_relaxed);
+    if (!categories)
+        return;
+
+    categories->root().set_log_level(config.level);
+
+    // Категории, исчезнувшие из файла, возвращаются к унаследованному уровню
+    for (const auto& name : categories->names())
+        if (!name.empty() && config.categories.find(name) == config.categories.end())
+            categories->get(name).reset_log_level();
+
+    for (const auto& [name, level] : config.categories)
+        categories->set_level(name, level);
+}
+
+bool ConfigLogger::watch()
+{
+    if (watcher.joinable())
+        return true;
+
+    // Слежение за каталогом: редакторы часто сохраняют файл через переименование
+    std::filesystem::path path(file_name);
+    std::string dir = path.has_parent_path() ? path.parent_path().string() : ".";
+
+    inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_fd == -1 || pipe(stop_pipe) == -1)
+        return false;
+    if (inotify_add_watch(inotify_fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) == -1)
+        return false;
+
+    watcher = std::thread(&ConfigLogger::watch_task, this);
+    return true;
+}
+
+void ConfigLogger::watch_task()
+{
+    std::string base = std::filesystem::path(file_name).filename().string();
+    alignas(inotify_event) char buffer[4096];
+
+    while (true)
+    {
+        // Пока есть замененные снимки, поток просыпается и удаляет освободившиеся
+        bool pending = false;
+        {
+            std::lock_guard<std::mutex> lock(reload_mutex);
+            release_retired();
+            pending = !retired.empty();
+        }
+
+        pollfd fds[2] = {{inotify_fd, POLLIN, 0}, {stop_pipe[0], POLLIN, 0}};
+        int ready = poll(fds, 2, pending ? 100 : -1);
+        if (ready == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            return;
+        }
+        if (fds[1].revents)
+            return;
+        if (ready == 0)
+            continue;
+
+        // Разбор событий: интересны только события для нашего файла
+        bool changed = false;
+        ssize_t len;
+        while ((len = ::read(inotify_fd, buffer, sizeof(buffer))) > 0)
+        {
+            for (char* ptr = buffer; ptr < buffer + len;)
+            {
+                auto* event = reinterpret_cast<inotify_event*>(ptr);
+                if (event->len > 0 && base == event->name)
+                    changed = true;
+                ptr += sizeof(inotify_event) + event->len;
+            }
+        }
+
+        if (changed)
+            load(); // При ошибке разбора остается прежний снимок
+    }
+}
+
+// Фабричная функция для создания логгера по файлу конфигурации
+std::unique_ptr<ConfigLogger> create_config_logger(const std::string& file_name, bool watch)
+{
+    auto logger = std::make_unique<ConfigLogger>(file_name);
+    if (logger->load() != LoggerError::NONE)
+        return nullptr;
+    if (watch && !logger->watch())
+        return nullptr;
+    return logger;
+}
@@ -0,0 +1,93 @@
+#include "log_context.h"
+#include "structured_log.h"
+#include <charconv>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+uint32_t LogContext::thread_id() const
+{
+    if (adopted)
+        return adopted->get_thread_id();
+    return thread_ids() ? native_thread_id() : 0;
+}
+
+uint32_t LogContext::native_thread_id() const
+{
+    if (adopted && adopted->get_thread_id() != 0)
+        return adopted->get_thread_id();
+
+    // gettid - системный вызов, поэтому номер запоминается на поток
+    LogContext& self = const_cast<LogContext&>(*this);
+    if (self.tid == 0)
+        self.tid = static_cast<uint32_t>(::syscall(SYS_gettid));
+    return self.tid;
+}
+
+void LogContext::append_text(std::string& out) const
+{
+    for_each([&out](const ContextField& field)
+    {
+        out += ' ';
+        out += field.key;
+        out += '=';
+        // Как в format_text_fields: значения с пробелами и кавычками - в кавычках
+        if (field.value.empty() || field.value.find_first_of(" \"=\n\t") != std::string_view::npos)
+        {
+            out += '"';
+            json_escape(field.value, out);
+            out += '"';
+        }
+        else
+            out += field.value;
+    });
+
+    uint32_t id = thread_id();
+    if (id != 0)
+    {
+        char buffer[16];
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), id);
+        out += " tid=";
+        out.append(buffer, result.ptr);
+    }
+}
+
+void ContextSnapshot::capture()
+{
+    const LogContext& context = LogContext::current();
+    spill.clear();
+    used = 0;
+    count = 0;
+    tid = context.thread_id();
+
+    context.for_each([this](const ContextField& field) { append(field.key, field.value); });
+}
+
+bool ContextSnapshot::append(std::string_view key, std::string_view value)
+{
+    size_t key_len = key.size() < 255 ? key.size() : 255;
+    size_t value_len = value.size() < 255 ? value.size() : 255;
+    size_t size = 2 + key_len + value_len;
+    if (used + size > CAPACITY || count == 255)
+        return false;
+
+    // Встроенный буфер переполнен: поля переносятся в spill один раз за снимок
+    char* dest = data + used;
+    if (!spill.empty() || used + size > INLINE_CAPACITY)
+    {
+        if (spill.empty())
+        {
+            spill.reserve(CAPACITY);
+            spill.assign(data, used);
+        }
+        spill.resize(used + size);
+        dest = &spill[used];
+    }
+
+    dest[0] = static_cast<char>(key_len);
+    dest[1] = static_cast<char>(value_len);
+    std::memcpy(dest + 2, key.data(), key_len);
+    std::memcpy(dest + 2 + key_len, value.data(), value_len);
+    used += size;
+    count++;
+    return true;
+}
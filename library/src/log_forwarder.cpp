@@ -0,0 +1,358 @@
+#include "log_forwarder.h"
+#include "socket_logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    // Разбор адреса получателя: "host:port" (TCP) или "unix:/path"
+    bool parse_target(const std::string& target, sockaddr_storage& addr, socklen_t& len)
+    {
+        addr = sockaddr_storage{};
+        if (target.compare(0, 5, "unix:") == 0)
+        {
+            auto* un = reinterpret_cast<sockaddr_un*>(&addr);
+            std::string path = target.substr(5);
+            if (path.empty() || path.size() >= sizeof(un->sun_path))
+                return false;
+            un->sun_family = AF_UNIX;
+            std::memcpy(un->sun_path, path.c_str(), path.size());
+            len = sizeof(sockaddr_un);
+            return true;
+        }
+
+        size_t colon = target.rfind(':');
+        if (colon == std::string::npos)
+            return false;
+        auto* in = reinterpret_cast<sockaddr_in*>(&addr);
+        in->sin_family = AF_INET;
+        in->sin_port = htons(std::atoi(target.c_str() + colon + 1));
+        len = sizeof(sockaddr_in);
+        return inet_pton(AF_INET, target.substr(0, colon).c_str(), &in->sin_addr) > 0;
+    }
+}
+
+LogForwarder::LogForwarder(const std::string& path, const std::string& target, ForwardOptions options)
+    : path(path), target(target), options(std::move(options))
+{
+    if (this->options.checkpoint.empty())
+        this->options.checkpoint = path + ".fwd";
+}
+
+LogForwarder::~LogForwarder()
+{
+    close_source(current);
+    for (auto& source : draining)
+        close_source(source);
+    close_socket();
+    if (notify != -1)
+        close(notify);
+}
+
+// Наблюдение за каталогом журнала: изменения файла, его создание и переименование при ротации
+LoggerError LogForwarder::init()
+{
+    sockaddr_storage addr;
+    socklen_t len = 0;
+    if (!parse_target(target, addr, len))
+    {
+        std::cerr << "Ошибка: некорректный адрес получателя " << target << std::endl;
+        return LoggerError::FILE_OPEN_FAILED;
+    }
+
+    notify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    fs::path dir = fs::path(path).has_parent_path() ? fs::path(path).parent_path() : fs::path(".");
+    if (notify == -1 || inotify_add_watch(notify, dir.c_str(),
+            IN_MODIFY | IN_CREATE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE | IN_CLOSE_WRITE) == -1)
+    {
+        std::cerr << "Ошибка: inotify для " << dir << ": " << std::strerror(errno) << std::endl;
+        return LoggerError::FILE_OPEN_FAILED;
+    }
+
+    load_checkpoint();
+    saved_time = std::chrono::steady_clock::now();
+    return LoggerError::NONE;
+}
+
+// Позиция из прошлого запуска. Старые файлы и текущий, если его ротировали, пока пересылка
+// стояла, находятся по inode и дочитываются до нового файла
+bool LogForwarder::load_checkpoint()
+{
+    std::ifstream file(options.checkpoint);
+    std::vector<Source> entries;
+    unsigned long long ino = 0;
+    long long offset = 0;
+    while (file >> ino >> offset)
+    {
+        if (offset < 0)
+            return false;
+        Source entry;
+        entry.ino = static_cast<ino_t>(ino);
+        entry.offset = static_cast<off_t>(offset);
+        entries.push_back(entry);
+    }
+    if (entries.empty())
+        return false;
+
+    positioned = true;
+    saved_current = entries[0];
+
+    auto reopen = [this](Source source)
+    {
+        std::string rotated = find_rotated(source.ino);
+        if (rotated.empty() || (source.fd = open(rotated.c_str(), O_RDONLY | O_CLOEXEC)) == -1)
+        {
+            std::cerr << "Не найден ротированный файл с inode " << source.ino
+                      << ": его непересланный хвост потерян" << std::endl;
+            return;
+        }
+        std::cerr << "Дочитывание ротированного файла " << rotated << std::endl;
+        source.seen = std::chrono::steady_clock::now();
+        draining.push_back(source);
+    };
+
+    for (size_t i = 1; i < entries.size(); ++i)
+        reopen(entries[i]);
+
+    struct stat st{};
+    if (saved_current.ino != 0 && (stat(path.c_str(), &st) != 0 || st.st_ino != saved_current.ino))
+        reopen(saved_current); // Новый файл по имени журнала пересылается с начала
+    else
+        resume = saved_current.ino != 0;
+    return true;
+}
+
+// Открытие журнала по имени (при первом запуске, после ротации или пересоздания)
+bool LogForwarder::open_current()
+{
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat st{};
+    if (fd == -1 || fstat(fd, &st) != 0)
+    {
+        if (fd != -1)
+            close(fd);
+        return false;
+    }
+
+    current.fd = fd;
+    current.ino = st.st_ino;
+    current.seen = std::chrono::steady_clock::now();
+    if (resume && st.st_ino == saved_current.ino)
+        current.offset = saved_current.offset;
+    else if (options.tail && !positioned)
+        current.offset = st.st_size;
+    else
+        current.offset = 0;
+    resume = false;
+    positioned = true;
+    return true;
+}
+
+bool LogForwarder::connect_target()
+{
+    sockaddr_storage addr;
+    socklen_t len = 0;
+    if (!parse_target(target, addr, len))
+        return false;
+
+    sock = connect_with_timeout(reinterpret_cast<sockaddr*>(&addr), len, options.connect_timeout);
+    if (sock == -1)
+    {
+        std::cerr << "Не удалось подключиться к " << target << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void LogForwarder::close_socket()
+{
+    if (sock != -1)
+        close(sock);
+    sock = -1;
+}
+
+void LogForwarder::close_source(Source& source)
+{
+    if (source.fd != -1)
+        close(source.fd);
+    source.fd = -1;
+}
+
+// Пересылка от offset до текущего конца файла без копирования в пространство пользователя.
+// offset сдвигается ядром и после ошибки указывает на первый неотправленный байт
+LoggerError LogForwarder::forward(Source& source)
+{
+    struct stat st{};
+    if (fstat(source.fd, &st) != 0)
+        return LoggerError::FILE_OPEN_FAILED;
+    if (st.st_size < source.offset)
+        source.offset = 0; // Файл усекли (copytruncate)
+
+    while (source.offset < st.st_size && !stopped())
+    {
+        size_t chunk = static_cast<size_t>(std::min<off_t>(st.st_size - source.offset, 1 << 30));
+        ssize_t result = sendfile(sock, source.fd, &source.offset, chunk);
+        if (result == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            return LoggerError::WRITE_FAILED;
+        }
+        if (result == 0)
+            break; // Файл укоротили между fstat и sendfile
+        sent += result;
+    }
+    return LoggerError::NONE;
+}
+
+LoggerError LogForwarder::step(bool drain)
+{
+    rotated = false;
+    if (stopped())
+        return LoggerError::NONE;
+
+    if (current.fd == -1)
+        open_current();
+    if (sock == -1 && !connect_target())
+        return LoggerError::WRITE_FAILED;
+
+    auto now = std::chrono::steady_clock::now();
+    bool changed = false; // Изменился набор файлов: позиция сохраняется сразу
+
+    // Старые файлы пересылаются первыми и закрываются, когда в них перестают писать
+    for (auto it = draining.begin(); it != draining.end();)
+    {
+        off_t before = it->offset;
+        LoggerError result = forward(*it);
+        if (result == LoggerError::WRITE_FAILED)
+        {
+            std::cerr << "Ошибка отправки: " << std::strerror(errno) << std::endl;
+            close_socket();
+            return result;
+        }
+        if (stopped())
+            return LoggerError::NONE; // Позиция сохраняется при остановке
+
+        if (it->offset != before)
+            it->seen = now;
+        if (result != LoggerError::NONE || drain || now - it->seen >= options.drain_idle)
+        {
+            if (result != LoggerError::NONE)
+                std::cerr << "Ошибка чтения ротированного файла (inode " << it->ino << "): "
+                          << std::strerror(errno) << std::endl;
+            close_source(*it);
+            it = draining.erase(it);
+            changed = true;
+        }
+        else
+            ++it;
+    }
+
+    // Ротация: имя указывает на другой inode (или файл удален). Старый файл остается
+    // открытым, пока процесс пишет в него, новый открывается по имени на следующем проходе
+    LoggerError status = LoggerError::NONE;
+    if (current.fd != -1)
+    {
+        struct stat path_st{};
+        bool moved = stat(path.c_str(), &path_st) != 0 || path_st.st_ino != current.ino;
+        status = forward(current);
+        if (status == LoggerError::WRITE_FAILED)
+        {
+            std::cerr << "Ошибка отправки: " << std::strerror(errno) << std::endl;
+            close_socket();
+            return status;
+        }
+        if (status == LoggerError::FILE_OPEN_FAILED)
+        {
+            // Файл открывается заново по имени и, если это тот же inode, с той же позиции
+            std::cerr << "Ошибка чтения " << path << ": " << std::strerror(errno) << std::endl;
+            saved_current = current;
+            resume = true;
+            close_source(current);
+        }
+        else if (moved && !stopped())
+        {
+            current.seen = now;
+            draining.push_back(current);
+            current = Source();
+            rotated = true;
+            changed = true;
+        }
+    }
+
+    // Позиция сохраняется после пересылки, но не чаще раза в секунду при постоянной записи
+    if (changed || drain || now - saved_time >= std::chrono::seconds(1))
+        save();
+    return status;
+}
+
+LoggerError LogForwarder::save()
+{
+    Source none;
+    const Source& head = current.fd != -1 ? current : (resume ? saved_current : none);
+    std::ostringstream text;
+    text << static_cast<unsigned long long>(head.ino) << " " << static_cast<long long>(head.offset) << "\n";
+    for (const auto& source : draining)
+        text << static_cast<unsigned long long>(source.ino) << " " << static_cast<long long>(source.offset) << "\n";
+
+    saved_time = std::chrono::steady_clock::now();
+    if (text.str() == saved_text)
+        return LoggerError::NONE;
+
+    // Запись через временный файл и rename: после сбоя остается старая или новая позиция
+    std::string tmp = options.checkpoint + ".tmp";
+    {
+        std::ofstream file(tmp, std::ios::trunc);
+        file << text.str();
+        if (!file)
+            return LoggerError::WRITE_FAILED;
+    }
+    if (std::rename(tmp.c_str(), options.checkpoint.c_str()) != 0)
+        return LoggerError::WRITE_FAILED;
+    saved_text = text.str();
+    return LoggerError::NONE;
+}
+
+// Ожидание событий inotify; таймаут - запасная проверка и сохранение позиции
+void LogForwarder::wait(std::chrono::milliseconds timeout)
+{
+    pollfd pfd{notify, POLLIN, 0};
+    if (poll(&pfd, 1, static_cast<int>(timeout.count())) > 0)
+    {
+        char buffer[4096];
+        while (read(notify, buffer, sizeof(buffer)) > 0)
+            ;
+    }
+}
+
+// Поиск переименованного при ротации файла по номеру inode (log.txt.1 и т.п. рядом с журналом)
+std::string LogForwarder::find_rotated(ino_t ino) const
+{
+    fs::path log_path(path);
+    fs::path dir = log_path.has_parent_path() ? log_path.parent_path() : fs::path(".");
+    std::string base = log_path.filename().string();
+
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(dir, ec))
+    {
+        std::string name = entry.path().filename().string();
+        struct stat st{};
+        if (name.compare(0, base.size(), base) == 0 && name != base &&
+            stat(entry.path().c_str(), &st) == 0 && st.st_ino == ino)
+            return entry.path().string();
+    }
+    return "";
+}
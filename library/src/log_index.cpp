@@ -0,0 +1,56 @@
+#include "log_index.h"
+#include <algorithm>
+#include <cstring>
+
+bool LogIndex::open(const std::string& index_name)
+{
+    entries = nullptr;
+    count = 0;
+    if (!file.open(index_name))
+        return false;
+
+    if (file.size() < sizeof(LOG_INDEX_MAGIC) ||
+        std::memcmp(file.data(), LOG_INDEX_MAGIC, sizeof(LOG_INDEX_MAGIC)) != 0)
+        return false;
+
+    // Недописанная последняя запись (например, после сбоя) отбрасывается
+    entries = reinterpret_cast<const LogIndexEntry*>(file.data() + sizeof(LOG_INDEX_MAGIC));
+    count = (file.size() - sizeof(LOG_INDEX_MAGIC)) / sizeof(LogIndexEntry);
+    return true;
+}
+
+// Двоичный поиск: блоки упорядочены по времени
+std::pair<size_t, size_t> LogIndex::find_range(std::time_t from, std::time_t to) const
+{
+    const LogIndexEntry* first = std::lower_bound(begin(), end(), from,
+        [](const LogIndexEntry& entry, std::time_t time) { return entry.last_time < time; });
+    const LogIndexEntry* last = std::upper_bound(first, end(), to,
+        [](std::time_t time, const LogIndexEntry& entry) { return time < entry.first_time; });
+
+    return {static_cast<size_t>(first - begin()), static_cast<size_t>(last - begin())};
+}
+
+// Блоки записываются в порядке смещений, поэтому пропуски находятся одним проходом
+std::vector<std::pair<uint64_t, uint64_t>> LogIndex::uncovered(uint64_t file_size) const
+{
+    std::vector<std::pair<uint64_t, uint64_t>> gaps;
+    uint64_t covered = 0;
+    for (const LogIndexEntry& entry : *this)
+    {
+        uint64_t offset = std::min(entry.offset, file_size);
+        if (offset > covered)
+            gaps.emplace_back(covered, offset);
+        covered = std::max(covered, std::min(entry.offset + entry.length, file_size));
+    }
+    if (covered < file_size)
+        gaps.emplace_back(covered, file_size);
+    return gaps;
+}
+
+bool LogIndex::has_level(const LogIndexEntry& entry, LogLevel level)
+{
+    for (int i = static_cast<int>(level); i < 3; ++i)
+        if (entry.counts[i] > 0)
+            return true;
+    return false;
+}
@@ -0,0 +1,175 @@
+#include "log_parser.h"
+
+namespace
+{
+    // Разбор фиксированного числа цифр
+    bool parse_digits(const char* str, int count, int& value)
+    {
+        value = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            if (str[i] < '0' || str[i] > '9')
+                return false;
+            value = value * 10 + (str[i] - '0');
+        }
+        return true;
+    }
+
+    // Метка времени "2024-01-15 14:30:25.123456789" (или с 'T' вместо пробела);
+    // дробная часть необязательна
+    bool parse_stamp(std::string_view stamp, LogRecord& record)
+    {
+        if (!parse_log_time(stamp, record.time))
+            return false;
+
+        record.nsec = 0;
+        if (stamp.size() > 20 && stamp[19] == '.')
+        {
+            uint32_t scale = 100000000;
+            for (size_t i = 20; i < stamp.size() && scale > 0; ++i, scale /= 10)
+            {
+                if (stamp[i] < '0' || stamp[i] > '9')
+                    return false;
+                record.nsec += (stamp[i] - '0') * scale;
+            }
+        }
+        return true;
+    }
+
+    // Строка JSON Lines в порядке полей encode_json:
+    // {"time":"2024-01-15T14:30:25.123456789","level":"INFO","msg":"...",...}
+    bool parse_json_line(std::string_view line, LogRecord& record)
+    {
+        constexpr std::string_view time_key = "{\"time\":\"";
+        constexpr std::string_view level_key = "\",\"level\":\"";
+        constexpr std::string_view msg_key = "\",\"msg\":\"";
+        if (line.substr(0, time_key.size()) != time_key)
+            return false;
+
+        size_t time_end = line.find('"', time_key.size());
+        if (time_end == std::string_view::npos ||
+            !parse_stamp(line.substr(time_key.size(), time_end - time_key.size()), record) ||
+            line.substr(time_end, level_key.size()) != level_key)
+            return false;
+
+        size_t level_start = time_end + level_key.size();
+        size_t level_end = line.find('"', level_start);
+        if (level_end == std::string_view::npos ||
+            !parse_level_name(line.substr(level_start, level_end - level_start), record.level) ||
+            line.substr(level_end, msg_key.size()) != msg_key)
+            return false;
+
+        // Конец сообщения - первая неэкранированная кавычка
+        size_t msg_start = level_end + msg_key.size();
+        size_t msg_end = msg_start;
+        while (msg_end < line.size() && line[msg_end] != '"')
+            msg_end += line[msg_end] == '\\' ? 2 : 1;
+        if (msg_end >= line.size())
+            return false;
+        record.msg = line.substr(msg_start, msg_end - msg_start);
+        return true;
+    }
+}
+
+// Разбор метки времени; mktime дорогой, поэтому кэшируем последнюю секунду
+bool parse_log_time(std::string_view str, std::time_t& time)
+{
+    const size_t len = 19; // "YYYY-MM-DD HH:MM:SS"
+    if (str.size() < len)
+        return false;
+
+    thread_local char last_str[len] = {};
+    thread_local std::time_t last_time = -1;
+    if (last_time != -1 && str.compare(0, len, std::string_view(last_str, len)) == 0)
+    {
+        time = last_time;
+        return true;
+    }
+
+    const char* s = str.data();
+    std::tm tm{};
+    if (!parse_digits(s, 4, tm.tm_year) || s[4] != '-' ||
+        !parse_digits(s + 5, 2, tm.tm_mon) || s[7] != '-' ||
+        !parse_digits(s + 8, 2, tm.tm_mday) || (s[10] != ' ' && s[10] != 'T') ||
+        !parse_digits(s + 11, 2, tm.tm_hour) || s[13] != ':' ||
+        !parse_digits(s + 14, 2, tm.tm_min) || s[16] != ':' ||
+        !parse_digits(s + 17, 2, tm.tm_sec))
+        return false;
+
+    tm.tm_year -= 1900;
+    tm.tm_mon -= 1;
+    tm.tm_isdst = -1; // Записи пишутся в локальном времени
+    time = std::mktime(&tm);
+
+    std::copy(s, s + len, last_str);
+    last_time = time;
+    return true;
+}
+
+bool parse_level_name(std::string_view name, LogLevel& level)
+{
+    if (name == "DEBUG") level = LogLevel::DEBUG;
+    else if (name == "INFO") level = LogLevel::INFO;
+    else if (name == "ERROR") level = LogLevel::ERROR;
+    else return false;
+    return true;
+}
+
+bool peek_log_level(std::string_view line, LogLevel& level)
+{
+    size_t start;
+    if (!line.empty() && line[0] == '{')
+    {
+        // JSON: уровень идет сразу за меткой времени
+        constexpr std::string_view level_key = "\"level\":\"";
+        size_t key = line.substr(0, 64).find(level_key);
+        if (key == std::string_view::npos || line.size() <= key + level_key.size())
+            return false;
+        start = key + level_key.size();
+    }
+    else
+    {
+        // Метка времени не длиннее 40 символов, поэтому ищем ']' только в начале строки
+        size_t close = line.substr(0, 40).find(']');
+        if (close == std::string_view::npos || line.size() < close + 5 || line[close + 2] != '[')
+            return false;
+        start = close + 3;
+    }
+
+    // Уровень однозначно определяется первой буквой
+    switch (line[start])
+    {
+        case 'D': level = LogLevel::DEBUG; return true;
+        case 'I': level = LogLevel::INFO; return true;
+        case 'E': level = LogLevel::ERROR; return true;
+        default: return false;
+    }
+}
+
+bool parse_log_line(std::string_view line, LogRecord& record)
+{
+    if (!line.empty() && line[0] == '{')
+        return parse_json_line(line, record);
+    if (line.size() < 2 || line[0] != '[')
+        return false;
+
+    size_t close = line.find(']');
+    if (close == std::string_view::npos || !parse_stamp(line.substr(1, close - 1), record))
+        return false;
+
+    // Уровень: " [LEVEL] "
+    size_t level_start = close + 2;
+    if (level_start >= line.size() || line[close + 1] != ' ' || line[level_start] != '[')
+        return false;
+
+    size_t level_end = line.find(']', level_start);
+    if (level_end == std::string_view::npos ||
+        !parse_level_name(line.substr(level_start + 1, level_end - level_start - 1), record.level))
+        return false;
+
+    size_t msg_start = level_end + 1;
+    if (msg_start < line.size() && line[msg_start] == ' ')
+        ++msg_start;
+    record.msg = line.substr(msg_start);
+    return true;
+}
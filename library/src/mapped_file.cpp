@@ -0,0 +1,53 @@
+#include "mapped_file.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+bool MappedFile::open(const std::string& file_name)
+{
+    close();
+
+    fd = ::open(file_name.c_str(), O_RDONLY);
+    if (fd == -1)
+        return false;
+
+    struct stat st{};
+    if (fstat(fd, &st) == -1)
+    {
+        close();
+        return false;
+    }
+
+    length = static_cast<size_t>(st.st_size);
+    if (length == 0)
+        return true; // Пустой файл: отображать нечего
+
+    void* ptr = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (ptr == MAP_FAILED)
+    {
+        close();
+        return false;
+    }
+
+    madvise(ptr, length, MADV_SEQUENTIAL); // Файлы журналов читаются последовательно
+    addr = static_cast<const char*>(ptr);
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (addr)
+        munmap(const_cast<char*>(addr), length);
+    if (fd != -1)
+        ::close(fd);
+
+    addr = nullptr;
+    length = 0;
+    fd = -1;
+}
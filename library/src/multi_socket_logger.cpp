@@ -0,0 +1,236 @@
+#include "multi_socket_logger.h"
+#include <functional>
+#include <sstream>
+
+MultiSocketLogger::MultiSocketLogger(const std::vector<SocketEndpoint>& endpoints, LogLevel level,
+                                     const SocketPoolOptions& options)
+    : endpoints(endpoints), options(options), log_level(level)
+{
+    if (this->options.connections == 0)
+        this->options.connections = 1;
+
+    // Соединения чередуются по получателям, чтобы ROUND_ROBIN сразу распределял записи между ними
+    for (size_t k = 0; k < this->options.connections; k++)
+    {
+        for (size_t i = 0; i < endpoints.size(); i++)
+        {
+            auto slot = std::make_unique<Slot>();
+            slot->endpoint = i;
+            // Фильтрация по уровню выполняется здесь, соединения пропускают все
+            slot->socket = std::make_unique<SocketLogger>(endpoints[i].host, endpoints[i].port, LogLevel::DEBUG);
+            slot->socket->set_connect_timeout(options.timeout);
+            slot->socket->set_verbose(false); // О смене состояния сообщает пул
+            // Соединение, закрытое проверкой, не подключается заново в потоке записи:
+            // запись уходит в другое соединение, подключает поток проверки
+            slot->socket->set_reconnect_on_send(false);
+            slots.push_back(std::move(slot));
+        }
+    }
+}
+
+MultiSocketLogger::~MultiSocketLogger()
+{
+    if (probe_thread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(probe_mutex);
+            stop_flag = true;
+        }
+        probe_condition.notify_all();
+        probe_thread.join();
+    }
+}
+
+LoggerError MultiSocketLogger::init()
+{
+    for (auto& slot : slots)
+    {
+        if (!slot->healthy && slot->socket->init() == LoggerError::NONE)
+            slot->healthy = true;
+        else if (!slot->healthy)
+            report(*slot, "недоступен");
+    }
+
+    // Недоступные сейчас получатели подключит поток проверки
+    if (!probe_thread.joinable())
+        probe_thread = std::thread(&MultiSocketLogger::probe_task, this);
+
+    return get_healthy() > 0 ? LoggerError::NONE : LoggerError::FILE_OPEN_FAILED;
+}
+
+// Периодическая проверка: живые соединения - на разрыв получателем, исключенные -
+// попыткой переподключения
+void MultiSocketLogger::probe_task()
+{
+    std::unique_lock<std::mutex> lock(probe_mutex);
+    while (!stop_flag)
+    {
+        probe_condition.wait_for(lock, options.probe, [this] { return stop_flag; });
+        if (stop_flag)
+            break;
+
+        lock.unlock();
+        for (auto& slot : slots)
+        {
+            if (slot->healthy.load(std::memory_order_acquire))
+            {
+                if (!slot->socket->check_connection())
+                {
+                    slot->healthy.store(false, std::memory_order_release);
+                    report(*slot, "отключился");
+                }
+            }
+            else
+            {
+                LoggerError result = slot->socket->is_init() ? slot->socket->reconnect() : slot->socket->init();
+                if (result == LoggerError::NONE)
+                {
+                    slot->healthy.store(true, std::memory_order_release);
+                    report(*slot, "подключен");
+                }
+            }
+        }
+        lock.lock();
+    }
+}
+
+void MultiSocketLogger::report(const Slot& slot, const char* state) const
+{
+    const SocketEndpoint& endpoint = endpoints[slot.endpoint];
+    std::cerr << "Получатель " << endpoint.host << ":" << endpoint.port << " " << state << std::endl;
+}
+
+size_t MultiSocketLogger::thread_slot() const
+{
+    return std::hash<std::thread::id>{}(std::this_thread::get_id());
+}
+
+template<typename Send>
+LoggerError MultiSocketLogger::send(size_t first, Send send_to)
+{
+    size_t count = slots.size();
+    for (size_t i = 0; i < count; i++)
+    {
+        Slot& slot = *slots[(first + i) % count];
+        if (!slot.healthy.load(std::memory_order_acquire))
+            continue;
+
+        if (send_to(*slot.socket) == LoggerError::NONE)
+            return LoggerError::NONE;
+
+        // Соединение исключается до восстановления потоком проверки
+        if (slot.healthy.exchange(false, std::memory_order_acq_rel))
+            report(slot, "исключен после ошибки отправки");
+        failovers.fetch_add(1, std::memory_order_relaxed);
+    }
+    return LoggerError::WRITE_FAILED; // Нет ни одного исправного соединения
+}
+
+LoggerError MultiSocketLogger::log(const std::string& msg, LogLevel level)
+{
+    if (level < log_level.load(std::memory_order_relaxed)) return LoggerError::NONE; // Фильтрация по уровню
+    return log_at(msg, level, std::chrono::system_clock::now());
+}
+
+LoggerError MultiSocketLogger::log_at(const std::string& msg, LogLevel level, std::chrono::system_clock::time_point time)
+{
+    if (level < log_level.load(std::memory_order_relaxed)) return LoggerError::NONE;
+
+    size_t first = options.balance == BalanceMode::HASH ? thread_slot() : next.fetch_add(1, std::memory_order_relaxed);
+    return send(first, [&](SocketLogger& socket) { return socket.log_at(msg, level, time); });
+}
+
+LoggerError MultiSocketLogger::log_record(const StructuredRecord& record)
+{
+    if (record.get_level() < log_level.load(std::memory_order_relaxed)) return LoggerError::NONE;
+
+    size_t first = options.balance == BalanceMode::HASH ? thread_slot() : next.fetch_add(1, std::memory_order_relaxed);
+    return send(first, [&](SocketLogger& socket) { return socket.log_record(record); });
+}
+
+LoggerError MultiSocketLogger::log_keyed(const std::string& key, const std::string& msg, LogLevel level)
+{
+    if (level < log_level.load(std::memory_order_relaxed)) return LoggerError::NONE;
+
+    size_t first = options.balance == BalanceMode::HASH ? std::hash<std::string>{}(key) : next.fetch_add(1, std::memory_order_relaxed);
+    auto time = std::chrono::system_clock::now();
+    return send(first, [&](SocketLogger& socket) { return socket.log_at(msg, level, time); });
+}
+
+LoggerError MultiSocketLogger::flush()
+{
+    LoggerError result = LoggerError::NONE;
+    for (auto& slot : slots)
+    {
+        if (!slot->healthy.load(std::memory_order_acquire))
+            continue;
+        LoggerError slot_result = slot->socket->flush();
+        if (result == LoggerError::NONE)
+            result = slot_result;
+    }
+    return result;
+}
+
+void MultiSocketLogger::set_format(LogFormat value)
+{
+    for (auto& slot : slots)
+        slot->socket->set_format(value);
+}
+
+void MultiSocketLogger::set_layout(const PatternLayout& value)
+{
+    for (auto& slot : slots)
+        slot->socket->set_layout(std::make_unique<PatternLayout>(value));
+}
+
+size_t MultiSocketLogger::get_healthy() const
+{
+    size_t count = 0;
+    for (auto& slot : slots)
+        count += slot->healthy.load(std::memory_order_relaxed);
+    return count;
+}
+
+bool MultiSocketLogger::is_healthy(size_t endpoint) const
+{
+    for (auto& slot : slots)
+    {
+        if (slot->endpoint == endpoint && slot->healthy.load(std::memory_order_relaxed))
+            return true;
+    }
+    return false;
+}
+
+std::vector<SocketEndpoint> parse_endpoints(const std::string& list)
+{
+    std::vector<SocketEndpoint> result;
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ','))
+    {
+        size_t colon = item.rfind(':');
+        if (colon == std::string::npos || colon == 0)
+            return {};
+
+        SocketEndpoint endpoint;
+        endpoint.host = item.substr(0, colon);
+        endpoint.port = std::atoi(item.c_str() + colon + 1);
+        if (endpoint.port <= 0 || endpoint.port > 65535)
+            return {};
+        result.push_back(endpoint);
+    }
+    return result;
+}
+
+// Фабричный метод для создания логгера с несколькими получателями
+std::unique_ptr<MultiSocketLogger> create_multi_socket_logger(const std::vector<SocketEndpoint>& endpoints,
+                                                              LogLevel level, const SocketPoolOptions& options)
+{
+    if (endpoints.empty())
+        return nullptr;
+
+    auto logger = std::make_unique<MultiSocketLogger>(endpoints, level, options);
+    if (logger->init() != LoggerError::NONE)
+        return nullptr;
+    return logger;
+}
@@ -0,0 +1,179 @@
+#include "pattern_layout.h"
+#include <charconv>
+
+namespace layout
+{
+    void append_date(std::string& out, std::chrono::system_clock::time_point time, DateStyle style)
+    {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+        std::time_t sec = static_cast<std::time_t>(ns / 1000000000);
+        long frac = static_cast<long>(ns % 1000000000);
+        if (frac < 0)
+        {
+            frac += 1000000000;
+            --sec;
+        }
+
+        if (style == DateStyle::EPOCH)
+        {
+            char buffer[24];
+            auto result = std::to_chars(buffer, buffer + sizeof(buffer), static_cast<long long>(sec));
+            out.append(buffer, result.ptr);
+        }
+        else
+        {
+            thread_local std::time_t cached_time = -1;
+            thread_local char cached_date[20]; // 2024-01-15 14:30:25
+            if (sec != cached_time)
+            {
+                std::tm tm{};
+                localtime_r(&sec, &tm);
+                std::strftime(cached_date, sizeof(cached_date), "%Y-%m-%d %H:%M:%S", &tm);
+                cached_time = sec;
+            }
+            out.append(cached_date, 19);
+            if (style == DateStyle::ISO8601)
+                out[out.size() - 9] = 'T';
+        }
+
+        // Доли секунды - всегда 9 цифр
+        char digits[10];
+        digits[0] = '.';
+        for (int i = 9; i > 0; --i)
+        {
+            digits[i] = static_cast<char>('0' + frac % 10);
+            frac /= 10;
+        }
+        out.append(digits, sizeof(digits));
+    }
+
+    void append_level(std::string& out, LogLevel level)
+    {
+        switch (level)
+        {
+            case LogLevel::DEBUG: out.append("DEBUG", 5); break;
+            case LogLevel::INFO: out.append("INFO", 4); break;
+            case LogLevel::ERROR: out.append("ERROR", 5); break;
+            default: out.append("UNKNOWN", 7); break;
+        }
+    }
+
+    void append_thread(std::string& out)
+    {
+        char buffer[16];
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), LogContext::current().native_thread_id());
+        out.append(buffer, result.ptr);
+    }
+
+    void append_context(std::string& out)
+    {
+        LogContext::current().append_text(out);
+    }
+}
+
+std::unique_ptr<PatternLayout> PatternLayout::compile(const std::string& pattern, const std::string& name,
+                                                      std::string* error)
+{
+    std::unique_ptr<PatternLayout> result(new PatternLayout());
+    result->pattern = pattern;
+
+    auto fail = [error](const std::string& text)
+    {
+        if (error)
+            *error = text;
+        return nullptr;
+    };
+
+    // Литерал копится до следующего элемента и добавляется одним шагом
+    std::string text;
+    auto flush_text = [&]()
+    {
+        if (text.empty())
+            return;
+        result->steps.push_back(Step{StepType::TEXT, layout::DateStyle::DEFAULT,
+                                     static_cast<uint32_t>(result->literals.size()), static_cast<uint32_t>(text.size())});
+        result->literals += text;
+        text.clear();
+    };
+    auto add_step = [&](StepType type, layout::DateStyle style = layout::DateStyle::DEFAULT)
+    {
+        flush_text();
+        result->steps.push_back(Step{type, style, 0, 0});
+    };
+
+    for (size_t i = 0; i < pattern.size(); ++i)
+    {
+        if (pattern[i] != '%')
+        {
+            text += pattern[i];
+            continue;
+        }
+        if (++i == pattern.size())
+            return fail("шаблон заканчивается на %");
+
+        switch (pattern[i])
+        {
+            case '%': text += '%'; break;
+            case 'c': text += name; break; // Имя известно заранее и становится литералом
+            case 'l': add_step(StepType::LEVEL); break;
+            case 'm': add_step(StepType::MESSAGE); break;
+            case 't': add_step(StepType::THREAD); break;
+            case 'X': add_step(StepType::CONTEXT); break;
+            case 'd':
+            {
+                layout::DateStyle style = layout::DateStyle::DEFAULT;
+                if (i + 1 < pattern.size() && pattern[i + 1] == '{')
+                {
+                    size_t end = pattern.find('}', i + 2);
+                    if (end == std::string::npos)
+                        return fail("не закрыта скобка после %d");
+                    std::string spec = pattern.substr(i + 2, end - i - 2);
+                    if (spec == "ISO8601")
+                        style = layout::DateStyle::ISO8601;
+                    else if (spec == "EPOCH")
+                        style = layout::DateStyle::EPOCH;
+                    else if (spec != "DEFAULT")
+                        return fail("неизвестный формат времени " + spec);
+                    i = end;
+                }
+                add_step(StepType::DATE, style);
+                break;
+            }
+            default:
+                return fail(std::string("неизвестный элемент %") + pattern[i]);
+        }
+    }
+    flush_text();
+
+    // Распространенные шаблоны развернуты на этапе компиляции
+    if (pattern == DEFAULT_PATTERN)
+        result->specialized = &DefaultLayout::format;
+    else if (pattern == ISO_PATTERN)
+        result->specialized = &IsoLayout::format;
+    return result;
+}
+
+void PatternLayout::run_steps(const LayoutRecord& record, std::string& out) const
+{
+    for (const Step& step : steps)
+    {
+        switch (step.type)
+        {
+            case StepType::TEXT: out.append(literals.data() + step.offset, step.length); break;
+            case StepType::DATE: layout::append_date(out, record.time, step.style); break;
+            case StepType::LEVEL: layout::append_level(out, record.level); break;
+            case StepType::MESSAGE: out.append(record.msg); break;
+            case StepType::THREAD: layout::append_thread(out); break;
+            case StepType::CONTEXT: layout::Context::append(out, record); break;
+        }
+    }
+}
+
+// [2024-01-15 14:30:25.123456789] [INFO] Сообщение key=value
+std::string Logger::msg_format(LogLevel level, const std::string& msg, std::chrono::system_clock::time_point curr)
+{
+    std::string result;
+    result.reserve(msg.size() + 48);
+    DefaultLayout::format(LayoutRecord{level, msg, curr}, result);
+    return result;
+}
@@ -0,0 +1,130 @@
+#include "rate_limit.h"
+
+namespace
+{
+    const int64_t SECOND_NS = 1000000000;
+
+    std::atomic<CallSite*> call_sites{nullptr}; // Голова списка мест вызова
+
+    int64_t now_ns()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+}
+
+CallSitePolicy CallSitePolicy::rate_limit(double per_second, double burst)
+{
+    CallSitePolicy policy;
+    policy.rate = per_second;
+    policy.burst = burst < 1 ? 1 : burst;
+    return policy;
+}
+
+CallSitePolicy CallSitePolicy::sample(uint32_t every)
+{
+    CallSitePolicy policy;
+    policy.sample_every = every ? every : 1;
+    return policy;
+}
+
+CallSitePolicy CallSitePolicy::first_then_sample(uint32_t first, uint32_t every)
+{
+    CallSitePolicy policy = sample(every);
+    policy.first_per_second = first;
+    return policy;
+}
+
+CallSite::CallSite(const char* file, int line, const CallSitePolicy& policy)
+    : file(file), line(line), policy(policy)
+{
+    interval_ns = policy.rate > 0 ? static_cast<int64_t>(SECOND_NS / policy.rate) : 0;
+    tolerance_ns = static_cast<int64_t>(interval_ns * (policy.burst - 1));
+    last_report_ns.store(now_ns(), std::memory_order_relaxed); // Первая сводка - не раньше чем через секунду
+
+    // Добавление в общий список без блокировок
+    next = call_sites.load(std::memory_order_relaxed);
+    while (!call_sites.compare_exchange_weak(next, this, std::memory_order_release, std::memory_order_relaxed))
+        ;
+}
+
+bool CallSite::allow(LogLevel level)
+{
+    bool pass = true;
+    int64_t now = 0;
+
+    // Выборка: первые K в секунду, затем 1 из N
+    if (policy.first_per_second > 0)
+    {
+        now = now_ns();
+        int64_t second = now / SECOND_NS;
+        int64_t window = window_second.load(std::memory_order_relaxed);
+        if (window != second && window_second.compare_exchange_strong(window, second, std::memory_order_relaxed))
+            window_count.store(0, std::memory_order_relaxed);
+
+        uint32_t count = window_count.fetch_add(1, std::memory_order_relaxed);
+        if (count >= policy.first_per_second)
+            pass = (count - policy.first_per_second) % policy.sample_every == 0;
+    }
+    else if (policy.sample_every > 1)
+        pass = calls.fetch_add(1, std::memory_order_relaxed) % policy.sample_every == 0;
+
+    // Корзина токенов в виде GCRA: одно атомарное время вместо пары (токены, время пополнения)
+    if (pass && interval_ns > 0)
+    {
+        if (now == 0)
+            now = now_ns();
+        int64_t arrival = arrival_ns.load(std::memory_order_relaxed);
+        while (true)
+        {
+            int64_t next_arrival = std::max(arrival, now) + interval_ns;
+            if (next_arrival - now > tolerance_ns + interval_ns)
+            {
+                pass = false;
+                break;
+            }
+            if (arrival_ns.compare_exchange_weak(arrival, next_arrival, std::memory_order_relaxed))
+                break;
+        }
+    }
+
+    if (!pass)
+    {
+        last_level.store(level, std::memory_order_relaxed);
+        suppressed.fetch_add(1, std::memory_order_relaxed);
+    }
+    return pass;
+}
+
+void CallSite::report(Logger& logger, LogLevel level, bool force)
+{
+    if (owner.load(std::memory_order_relaxed) != &logger)
+        owner.store(&logger, std::memory_order_relaxed); // Запись только при смене логгера
+
+    // Сводка, отброшенная по уровню, потеряла бы счетчик: он остается до следующей попытки
+    if (suppressed.load(std::memory_order_relaxed) == 0 || level < logger.get_log_level())
+        return;
+
+    // Сводку выводит только один поток за интервал
+    int64_t now = now_ns();
+    int64_t last = last_report_ns.load(std::memory_order_relaxed);
+    if (!force && (now - last < SECOND_NS ||
+        !last_report_ns.compare_exchange_strong(last, now, std::memory_order_relaxed)))
+        return;
+
+    uint64_t count = suppressed.exchange(0, std::memory_order_relaxed);
+    if (count == 0)
+        return;
+
+    LoggerError result = logger.log("[rate limit] " + std::string(file) + ":" + std::to_string(line) +
+                                    ": подавлено сообщений: " + std::to_string(count), level);
+    if (result != LoggerError::NONE)
+        suppressed.fetch_add(count, std::memory_order_relaxed); // Сводка не записана - счетчик возвращается
+}
+
+void CallSite::report_all(Logger& logger)
+{
+    for (CallSite* site = call_sites.load(std::memory_order_acquire); site; site = site->next)
+        if (site->owner.load(std::memory_order_relaxed) == &logger)
+            site->report(logger, site->last_level.load(std::memory_order_relaxed), true);
+}
@@ -0,0 +1,350 @@
+#include "shm_ring.h"
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <thread>
+#include <unistd.h>
+
+namespace
+{
+    // Старший бит номера: ячейку заполняет производитель. У заполняемой ячейки в номере вместе
+    // с младшими POS_BITS битами позиции хранится pid владельца: захват и владелец - одна запись
+    const uint64_t WRITING = uint64_t(1) << 63;
+    const int POS_BITS = 40;
+    const uint64_t POS_MASK = (uint64_t(1) << POS_BITS) - 1;
+    const uint64_t PID_MASK = (uint64_t(1) << (63 - POS_BITS)) - 1; // pid_max в Linux не больше 2^22
+    const uint16_t FLAG_TRUNCATED = 1;
+
+    // Номер заполняемой ячейки позиции pos процессом pid
+    uint64_t writing_seq(uint64_t pos, uint32_t pid)
+    {
+        return WRITING | (static_cast<uint64_t>(pid) & PID_MASK) << POS_BITS | (pos & POS_MASK);
+    }
+
+    uint32_t writing_pid(uint64_t seq)
+    {
+        return static_cast<uint32_t>(seq >> POS_BITS & PID_MASK);
+    }
+
+    // Разность позиции из номера и pos; у заполняемой ячейки позиция известна по модулю 2^POS_BITS
+    // (ячейки одного круга отличаются от pos гораздо меньше)
+    int64_t seq_diff(uint64_t seq, uint64_t pos)
+    {
+        if (!(seq & WRITING))
+            return static_cast<int64_t>(seq - pos);
+        uint64_t diff = ((seq & POS_MASK) - pos) & POS_MASK;
+        return static_cast<int64_t>(diff << (64 - POS_BITS)) >> (64 - POS_BITS);
+    }
+
+    // Заголовок ячейки. Номер seq по схеме Вьюкова: pos - свободна для позиции pos,
+    // writing_seq(pos, pid) - заполняется, pos + 1 - готова к чтению.
+    // pid - копия владельца для читателя записи
+    struct SlotHeader
+    {
+        std::atomic<uint64_t> seq;
+        int64_t time_ns;
+        uint32_t pid;
+        uint16_t level;
+        uint16_t flags;
+        uint32_t len;
+        uint32_t reserved;
+    };
+    static_assert(sizeof(SlotHeader) == 32, "SlotHeader layout");
+
+    // Межпроцессный futex (без FUTEX_PRIVATE_FLAG)
+    long futex(std::atomic<uint32_t>* addr, int op, uint32_t val, const timespec* timeout)
+    {
+        return syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr), op, val, timeout, nullptr, 0);
+    }
+
+    size_t header_size()
+    {
+        return (sizeof(ShmRingHeader) + 63) & ~size_t(63);
+    }
+}
+
+ShmRing::ShmRing(const std::string& name, ShmRingHeader* header, size_t mapped)
+    : name(name), header(header), mapped(mapped), mask(header->slots - 1)
+{}
+
+ShmRing::~ShmRing()
+{
+    munmap(header, mapped);
+}
+
+// Создание с O_EXCL определяет единственного инициализатора; остальные ждут сигнатуру
+std::unique_ptr<ShmRing> ShmRing::open(const std::string& name, size_t slots, size_t slot_size)
+{
+    int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0660);
+    bool creator = fd != -1;
+    if (!creator && errno == EEXIST)
+        fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd == -1)
+        return nullptr;
+
+    void* ptr = MAP_FAILED;
+    size_t total = 0;
+    if (creator)
+    {
+        // Число ячеек - степень двойки, размер ячейки кратен строке кэша
+        size_t count = 2;
+        while (count < slots)
+            count <<= 1;
+        slot_size = std::max<size_t>((slot_size + 63) & ~size_t(63), 64);
+        total = header_size() + count * slot_size;
+
+        if (ftruncate(fd, total) == 0)
+            ptr = mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (ptr != MAP_FAILED)
+        {
+            auto* header = new (ptr) ShmRingHeader{};
+            header->slots = count;
+            header->slot_size = slot_size;
+            for (uint64_t i = 0; i < count; ++i)
+            {
+                auto* slot = new (static_cast<char*>(ptr) + header_size() + i * slot_size) SlotHeader{};
+                slot->seq.store(i, std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_release);
+            std::memcpy(header->magic, SHM_RING_MAGIC, sizeof(SHM_RING_MAGIC));
+        }
+    }
+    else
+    {
+        // Ожидание инициализации кольца создателем (не дольше секунды)
+        for (int attempt = 0; attempt < 1000 && ptr == MAP_FAILED; ++attempt)
+        {
+            struct stat st{};
+            if (fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= header_size())
+            {
+                auto* header = static_cast<ShmRingHeader*>(
+                    mmap(nullptr, header_size(), PROT_READ, MAP_SHARED, fd, 0));
+                if (header != MAP_FAILED)
+                {
+                    bool ready = std::memcmp(header->magic, SHM_RING_MAGIC, sizeof(SHM_RING_MAGIC)) == 0;
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    total = header_size() + header->slots * header->slot_size;
+                    munmap(header, header_size());
+                    if (ready && static_cast<size_t>(st.st_size) >= total)
+                        ptr = mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                    if (ready)
+                        break;
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    ::close(fd);
+    if (ptr == MAP_FAILED)
+    {
+        if (creator)
+            shm_unlink(name.c_str());
+        return nullptr;
+    }
+    return std::unique_ptr<ShmRing>(new ShmRing(name, static_cast<ShmRingHeader*>(ptr), total));
+}
+
+bool ShmRing::unlink(const std::string& name)
+{
+    return shm_unlink(name.c_str()) == 0;
+}
+
+char* ShmRing::slot(uint64_t pos) const
+{
+    return reinterpret_cast<char*>(header) + header_size() + (pos & mask) * header->slot_size;
+}
+
+size_t ShmRing::size() const
+{
+    uint64_t tail = header->tail.load(std::memory_order_relaxed);
+    uint64_t head = header->head.load(std::memory_order_relaxed);
+    return head > tail ? head - tail : 0;
+}
+
+bool ShmRing::push(const char* msg, size_t len, LogLevel level, int64_t time_ns)
+{
+    // Резервирование позиции: ячейка свободна, если ее номер равен позиции
+    uint64_t pos = header->head.load(std::memory_order_relaxed);
+    SlotHeader* slot_header;
+    while (true)
+    {
+        slot_header = reinterpret_cast<SlotHeader*>(slot(pos));
+        uint64_t seq = slot_header->seq.load(std::memory_order_acquire);
+        int64_t diff = seq_diff(seq, pos);
+        if (diff == 0 && !(seq & WRITING))
+        {
+            if (header->head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (diff < 0)
+        {
+            header->dropped.fetch_add(1, std::memory_order_relaxed); // Кольцо заполнено
+            return false;
+        }
+        else
+            pos = header->head.load(std::memory_order_relaxed); // Позицию уже занял другой производитель
+    }
+
+    // Захват ячейки вместе с pid владельца одной CAS: читатель не увидит заполняемую ячейку
+    // без владельца. Неудача означает, что читатель уже пропустил ячейку по таймауту
+    uint32_t pid = static_cast<uint32_t>(getpid());
+    uint64_t claimed = writing_seq(pos, pid);
+    uint64_t expected = pos;
+    if (!slot_header->seq.compare_exchange_strong(expected, claimed, std::memory_order_acq_rel))
+    {
+        header->dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    size_t capacity = header->slot_size - sizeof(SlotHeader);
+    slot_header->pid = pid;
+    slot_header->time_ns = time_ns;
+    slot_header->level = static_cast<uint16_t>(level);
+    slot_header->flags = len > capacity ? FLAG_TRUNCATED : 0;
+    slot_header->len = static_cast<uint32_t>(std::min(len, capacity));
+    std::memcpy(reinterpret_cast<char*>(slot_header) + sizeof(SlotHeader), msg, slot_header->len);
+
+    expected = claimed;
+    if (!slot_header->seq.compare_exchange_strong(expected, pos + 1, std::memory_order_release))
+    {
+        header->dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // Пробуждение читателя, только если он спит
+    header->futex.fetch_add(1, std::memory_order_seq_cst);
+    if (header->waiting.load(std::memory_order_seq_cst))
+        futex(&header->futex, FUTEX_WAKE, 1, nullptr);
+    return true;
+}
+
+// Производитель жив, если процесс с pid из номера заполняемой ячейки существует
+bool ShmRing::producer_alive(uint64_t seq) const
+{
+    pid_t pid = static_cast<pid_t>(writing_pid(seq));
+    return pid > 0 && (kill(pid, 0) == 0 || errno == EPERM);
+}
+
+size_t ShmRing::drain(const std::function<void(const ShmRecord&)>& handler, size_t max)
+{
+    size_t count = 0;
+    while (count < max)
+    {
+        uint64_t pos = header->tail.load(std::memory_order_relaxed);
+        auto* slot_header = reinterpret_cast<SlotHeader*>(slot(pos));
+        uint64_t seq = slot_header->seq.load(std::memory_order_acquire);
+
+        if (seq == pos + 1)
+        {
+            ShmRecord record{slot_header->time_ns, static_cast<LogLevel>(slot_header->level), slot_header->pid,
+                             (slot_header->flags & FLAG_TRUNCATED) != 0,
+                             std::string_view(reinterpret_cast<const char*>(slot_header) + sizeof(SlotHeader),
+                                              slot_header->len)};
+            handler(record);
+
+            slot_header->seq.store(pos + header->slots, std::memory_order_release); // Свободна для следующего круга
+            header->tail.store(pos + 1, std::memory_order_release);
+            stall_pos = UINT64_MAX;
+            ++count;
+            continue;
+        }
+
+        if (header->head.load(std::memory_order_acquire) <= pos)
+            break; // Кольцо пусто
+
+        // Позиция зарезервирована, но запись не завершена
+        auto now = std::chrono::steady_clock::now();
+        if (stall_pos != pos)
+        {
+            stall_pos = pos;
+            stall_start = now;
+            break;
+        }
+        if (now - stall_start < stall_timeout)
+            break;
+
+        // Незахваченную ячейку пропустить безопасно: опоздавший производитель не сможет ее захватить.
+        // Заполняемую - только если процесс-владелец из ее номера завершился
+        uint64_t expected = seq;
+        bool writing = (seq & WRITING) && seq_diff(seq, pos) == 0;
+        if ((seq == pos || (writing && !producer_alive(seq))) &&
+            slot_header->seq.compare_exchange_strong(expected, pos + header->slots, std::memory_order_acq_rel))
+        {
+            header->skipped.fetch_add(1, std::memory_order_relaxed);
+            header->tail.store(pos + 1, std::memory_order_release);
+            stall_pos = UINT64_MAX;
+            continue;
+        }
+        if (expected == pos + 1)
+            continue; // Запись завершилась во время проверки
+        break;
+    }
+    return count;
+}
+
+bool ShmRing::wait(std::chrono::milliseconds timeout)
+{
+    auto ready = [this]
+    {
+        uint64_t pos = header->tail.load(std::memory_order_relaxed);
+        return reinterpret_cast<SlotHeader*>(slot(pos))->seq.load(std::memory_order_acquire) == pos + 1;
+    };
+
+    uint32_t value = header->futex.load(std::memory_order_seq_cst);
+    if (ready())
+        return true;
+
+    header->waiting.store(1, std::memory_order_seq_cst);
+    if (!ready())
+    {
+        timespec ts{static_cast<time_t>(timeout.count() / 1000), static_cast<long>(timeout.count() % 1000) * 1000000};
+        futex(&header->futex, FUTEX_WAIT, value, &ts);
+    }
+    header->waiting.store(0, std::memory_order_relaxed);
+    return ready();
+}
+
+ShmLogger::ShmLogger(std::unique_ptr<ShmRing> ring, LogLevel level)
+    : ring(std::move(ring)), log_level(level)
+{}
+
+LoggerError ShmLogger::log(const std::string& msg, LogLevel level)
+{
+    if (level < log_level.load(std::memory_order_relaxed)) return LoggerError::NONE; // Фильтрация по уровню
+    return log_at(msg, level, std::chrono::system_clock::now());
+}
+
+// Переполнение кольца не блокирует производителя: запись отбрасывается и учитывается
+LoggerError ShmLogger::log_at(const std::string& msg, LogLevel level, std::chrono::system_clock::time_point time)
+{
+    if (level < log_level.load(std::memory_order_relaxed)) return LoggerError::NONE; // Фильтрация по уровню
+
+    int64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+
+    // Демон форматирует запись в своем потоке, поэтому контекст передается в тексте сообщения
+    const LogContext& context = LogContext::current();
+    if (context.has_fields())
+    {
+        std::string text = msg;
+        context.append_text(text);
+        return ring->push(text.data(), text.size(), level, ns) ? LoggerError::NONE : LoggerError::WRITE_FAILED;
+    }
+    return ring->push(msg.data(), msg.size(), level, ns) ? LoggerError::NONE : LoggerError::WRITE_FAILED;
+}
+
+// Фабричная функция для создания логгера разделяемой памяти
+std::unique_ptr<Logger> create_shm_logger(const std::string& name, LogLevel level)
+{
+    auto ring = ShmRing::open(name);
+    if (!ring)
+        return nullptr;
+    return std::make_unique<ShmLogger>(std::move(ring), level);
+}
@@ -1,4 +1,7 @@
 #include "socket_logger.h"
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
 
 // Конструктор сокетного логгера
 SocketLogger::SocketLogger(const std::string& host, int port, LogLevel level)
@@ -8,20 +11,71 @@ SocketLogger::SocketLogger(const std::string& host, int port, LogLevel level)
 // Деструктор 
 SocketLogger::~SocketLogger()
 {
-    std::lock_guard<std::mutex> lock(log_mutex);
+    if (connect_thread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(async_mutex);
+            stop_flag = true;
+        }
+        async_condition.notify_all();
+        connect_thread.join();
+    }
+
+    compressor.reset(); // Отправка накопленных блоков
+
+    if (!pending.empty())
+        std::cerr << "Не отправлено сообщений: " << pending.size() << " (нет соединения)" << std::endl;
+
+    std::lock_guard<LogMutex> lock(log_mutex);
     close_socket(); // Закрытие соединения
 }
 
 // Подключение к серверу
 LoggerError SocketLogger::connect_to_server()
 {
-    sockfd = socket(AF_INET, SOCK_STREAM, 0); // Создание TCP сокета
-    if (sockfd == -1)
+    sockfd = open_connection(verbose);
+    return sockfd == -1 ? LoggerError::FILE_OPEN_FAILED : LoggerError::NONE;
+}
+
+// Неблокирующий connect с ожиданием не дольше timeout
+int connect_with_timeout(const sockaddr* addr, socklen_t len, std::chrono::milliseconds timeout)
+{
+    int fd = socket(addr->sa_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd == -1)
+        return -1;
+
+    int result = connect(fd, addr, len);
+    if (result == -1 && (errno == EINPROGRESS || errno == EAGAIN))
     {
-        std::cerr << "Ошибка создания" << std::endl;
-        return LoggerError::FILE_OPEN_FAILED;
+        pollfd pfd{fd, POLLOUT, 0};
+        int error = 0;
+        socklen_t error_len = sizeof(error);
+        result = poll(&pfd, 1, static_cast<int>(timeout.count()));
+        if (result == 1 && getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &error_len) == 0 && error == 0)
+            result = 0;
+        else
+        {
+            errno = result == 0 ? ETIMEDOUT : (error != 0 ? error : errno);
+            result = -1;
+        }
+    }
+
+    if (result == -1)
+    {
+        int saved = errno;
+        close(fd);
+        errno = saved;
+        return -1;
     }
 
+    // Дальше сокет используется в блокирующем режиме
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_NONBLOCK);
+    return fd;
+}
+
+// Подключение к серверу с таймаутом connect_timeout
+int SocketLogger::open_connection(bool verbose)
+{
     sockaddr_in server_addr{};
     server_addr.sin_family = AF_INET;          // IPv4
     server_addr.sin_port = htons(port);        // Порт в сетевом порядке байт
@@ -30,22 +84,118 @@ LoggerError SocketLogger::connect_to_server()
     if (inet_pton(AF_INET, host.c_str(), &server_addr.sin_addr) <= 0)
     {
         std::cerr << "Некорретный адрес: " << host << std::endl;
-        close_socket();
-        return LoggerError::FILE_OPEN_FAILED;
+        return -1;
     }
 
     // Установка соединения с сервером
-    if (connect(sockfd, (sockaddr*)&server_addr, sizeof(server_addr)) == -1)
+    int fd = connect_with_timeout((sockaddr*)&server_addr, sizeof(server_addr), connect_timeout);
+    if (fd == -1)
     {
-        std::cerr << "Не удалось подключится к " << host << ":" << port << std::endl;
-        close_socket();
+        if (verbose)
+            std::cerr << "Не удалось подключится к " << host << ":" << port << std::endl;
+        return -1;
+    }
+
+    if (verbose)
+        std::cout << "Подключение к серверу по " << host << ":" << port << std::endl;
+    return fd;
+}
+
+// Запуск фонового подключения
+LoggerError SocketLogger::start_async(const ConnectOptions& options)
+{
+    std::lock_guard<LogMutex> lock(log_mutex);
+    if (init_flag)
+        return LoggerError::NONE;
+
+    sockaddr_in check{};
+    if (inet_pton(AF_INET, host.c_str(), &check.sin_addr) <= 0)
+    {
+        std::cerr << "Некорретный адрес: " << host << std::endl;
         return LoggerError::FILE_OPEN_FAILED;
     }
 
-    std::cout << "Подключение к серверу по " << host << ":" << port << std::endl;
+    async_options = options;
+    connect_timeout = options.timeout;
+    async_flag = true;
+    init_flag = true; // Логгер принимает сообщения сразу
+    connect_thread = std::thread(&SocketLogger::connect_task, this);
     return LoggerError::NONE;
 }
 
+// Поток подключения: попытки с паузой retry; после подключения отправляет буфер
+// и ждет сигнала о разрыве соединения
+void SocketLogger::connect_task()
+{
+    bool reported = false;
+    std::unique_lock<std::mutex> lock(async_mutex);
+    while (!stop_flag)
+    {
+        if (sockfd != -1)
+        {
+            async_condition.wait(lock, [this] { return stop_flag || sockfd == -1; });
+            continue;
+        }
+
+        lock.unlock();
+        int fd = open_connection(!reported); // Об ошибке сообщается один раз до успешного подключения
+        if (fd != -1)
+        {
+            // send выполняется под log_mutex: зависший получатель задерживает записи
+            // не дольше таймаута, после чего соединение закрывается, а хвост ждет в буфере
+            timeval tv{static_cast<time_t>(async_options.timeout.count() / 1000),
+                       static_cast<suseconds_t>(async_options.timeout.count() % 1000 * 1000)};
+            setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+
+            std::lock_guard<LogMutex> log_lock(log_mutex);
+            sockfd = fd;
+            reported = false;
+            send_pending(); // При ошибке сокет закрывается, и попытки продолжаются
+        }
+        else
+            reported = true;
+        lock.lock();
+
+        if (sockfd == -1)
+            async_condition.wait_for(lock, async_options.retry, [this] { return stop_flag; });
+    }
+}
+
+bool SocketLogger::wait_connected(std::chrono::milliseconds timeout)
+{
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (sockfd == -1 && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    return sockfd != -1;
+}
+
+// Буфер ожидания ограничен по объему: при переполнении вытесняются самые старые сообщения
+void SocketLogger::buffer_line(const std::string& line)
+{
+    pending.push_back(line);
+    pending_bytes += line.size();
+    while (pending_bytes > async_options.buffer_limit && pending.size() > 1)
+    {
+        pending_bytes -= pending.front().size();
+        pending.pop_front();
+        dropped++;
+    }
+}
+
+// Записи (и блоки сжатия) отправляются целиком: после обрыва посреди записи она повторяется
+// с начала по новому соединению, и получатель видит поток, выровненный по строкам и кадрам
+bool SocketLogger::send_pending()
+{
+    while (!pending.empty())
+    {
+        if (send_all(pending.front().data(), pending.front().size()) != LoggerError::NONE)
+            return false;
+        pending_bytes -= pending.front().size();
+        pending.pop_front();
+    }
+    return true;
+}
+
 // Закрытие сокета
 void SocketLogger::close_socket()
 {
@@ -59,7 +209,7 @@ void SocketLogger::close_socket()
 // Инициализация соединения
 LoggerError SocketLogger::init()
 {
-    std::lock_guard<std::mutex> lock(log_mutex);
+    std::lock_guard<LogMutex> lock(log_mutex);
     if (init_flag) 
         return LoggerError::NONE; // Уже инициализирован
     
@@ -73,43 +223,167 @@ LoggerError SocketLogger::init()
 // Повторное подключение при разрыве соединения
 LoggerError SocketLogger::reconnect()
 {
-    std::lock_guard<std::mutex> lock(log_mutex);
+    std::lock_guard<LogMutex> lock(log_mutex);
     close_socket();
+    if (async_flag)
+    {
+        wake_connect(); // Подключением занимается фоновый поток
+        return LoggerError::NONE;
+    }
     return connect_to_server(); // Попытка переподключения
 }
 
+// Получатель журнала ничего не присылает, поэтому готовность сокета на чтение
+// означает EOF или ошибку
+bool SocketLogger::check_connection()
+{
+    std::lock_guard<LogMutex> lock(log_mutex);
+    if (sockfd == -1)
+        return false;
+
+    pollfd pfd{sockfd, POLLIN | POLLRDHUP, 0};
+    if (poll(&pfd, 1, 0) == 0)
+        return true;
+
+    char byte;
+    if ((pfd.revents & (POLLERR | POLLHUP | POLLRDHUP)) == 0 &&
+        recv(sockfd, &byte, 1, MSG_PEEK | MSG_DONTWAIT) > 0)
+        return true; // Получатель что-то прислал: соединение живо
+
+    close_socket();
+    return false;
+}
+
+// Отправка с учетом частичной записи; при ошибке соединение закрывается
+LoggerError SocketLogger::send_all(const char* data, size_t size)
+{
+    if (sockfd == -1 && !async_flag)
+    {
+        if (!reconnect_on_send)
+            return LoggerError::WRITE_FAILED;
+        LoggerError result = connect_to_server();
+        if (result != LoggerError::NONE)
+            return result;
+    }
+
+    while (size > 0)
+    {
+        ssize_t bytes_sent = send(sockfd, data, size, MSG_NOSIGNAL);
+        if (bytes_sent == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            std::cerr << "Не удалось отправить сообщение" << std::endl;
+            close_socket();
+            return LoggerError::WRITE_FAILED;
+        }
+        data += bytes_sent;
+        size -= bytes_sent;
+    }
+    return LoggerError::NONE;
+}
+
+// Включение сжатия: отправку выполняет фоновый поток компрессора
+LoggerError SocketLogger::enable_compression(size_t block_size)
+{
+    if (!init_flag)
+        return LoggerError::FILE_OPEN_FAILED;
+    if (compressor)
+        return LoggerError::NONE;
+
+    compressor = std::make_unique<BlockCompressor>([this](const char* data, size_t size)
+    {
+        std::lock_guard<LogMutex> lock(log_mutex);
+        return send_or_buffer(data, size) == LoggerError::NONE;
+    }, block_size);
+    return LoggerError::NONE;
+}
+
 // Метод логирования через сокет
 LoggerError SocketLogger::log(const std::string& msg, LogLevel level)
 {
-    if (level < log_level) return LoggerError::NONE; // Фильтрация по уровню
+    if (level < log_level.load(std::memory_order_relaxed)) return LoggerError::NONE; // Фильтрация по уровню
+    return log_at(msg, level, std::chrono::system_clock::now());
+}
+
+// Запись с заданным временем
+LoggerError SocketLogger::log_at(const std::string& msg, LogLevel level, std::chrono::system_clock::time_point time)
+{
+    if (level < log_level.load(std::memory_order_relaxed)) return LoggerError::NONE; // Фильтрация по уровню
+    return log_record(StructuredRecord(msg, level, time));
+}
+
+// Структурированная запись: поля в JSON или в виде key=value в тексте
+LoggerError SocketLogger::log_record(const StructuredRecord& record)
+{
+    if (record.get_level() < log_level.load(std::memory_order_relaxed)) return LoggerError::NONE;
 
+    thread_local std::string line;
+    line.clear();
+    format_line(record, get_format(), layout.get(), line);
+    return send_line(line);
+}
+
+LoggerError SocketLogger::send_line(const std::string& curr_msg)
+{
     if (!init_flag) 
     {
         std::cerr << "Логгер сокетов не инициализирован" << std::endl;
         return LoggerError::FILE_OPEN_FAILED;
     }
 
-    std::string curr_msg = msg_format(level, msg) + "\n"; // Форматирование сообщения
-    std::lock_guard<std::mutex> lock(log_mutex);
-    
-    // Проверка соединения и переподключение при необходимости
-    if (sockfd == -1) 
+    if (compressor)
     {
-        LoggerError result = reconnect();
-        if (result != LoggerError::NONE) 
-            return result;
+        compressor->append(curr_msg.data(), curr_msg.size());
+        return compressor->failed() ? LoggerError::WRITE_FAILED : LoggerError::NONE;
     }
 
-    // Отправка сообщения через сокет
-    ssize_t bytes_sent = send(sockfd, curr_msg.c_str(), curr_msg.size(), 0);
-    if (bytes_sent == -1) 
+    std::lock_guard<LogMutex> lock(log_mutex);
+    return send_or_buffer(curr_msg.data(), curr_msg.size());
+}
+
+// Отправка под log_mutex. В фоновом режиме сообщение без соединения (или за еще
+// не отправленным буфером) ждет в буфере, и вызывающий поток не блокируется на connect
+LoggerError SocketLogger::send_or_buffer(const char* data, size_t size)
+{
+    if (async_flag && (sockfd == -1 || !pending.empty()))
     {
-        std::cerr << "Не удалось отправить сообщение" << std::endl;
-        close_socket();
-        return LoggerError::WRITE_FAILED;
+        buffer_line(std::string(data, size));
+        wake_connect();
+        return LoggerError::NONE;
     }
 
-    return LoggerError::NONE;
+    // Отправка сообщения через сокет (при необходимости с переподключением).
+    // После частичной отправки в буфер идет вся запись: новое соединение может вести к другому
+    // получателю и должно начинаться с целой строки или кадра. Принятое send начало разорванного
+    // соединения не обязательно доставлено, поэтому доставка - не менее одного раза
+    LoggerError result = send_all(data, size);
+    if (result != LoggerError::NONE && async_flag)
+    {
+        buffer_line(std::string(data, size));
+        wake_connect();
+        return LoggerError::NONE;
+    }
+    return result;
+}
+
+// Пробуждение потока подключения. Захват async_mutex исключает потерю сигнала
+// между проверкой условия и засыпанием потока
+void SocketLogger::wake_connect()
+{
+    {
+        std::lock_guard<std::mutex> lock(async_mutex);
+    }
+    async_condition.notify_all();
+}
+
+LoggerError SocketLogger::flush()
+{
+    if (!compressor)
+        return LoggerError::NONE; // Без сжатия каждая запись отправляется сразу
+
+    compressor->flush();
+    return compressor->failed() ? LoggerError::WRITE_FAILED : LoggerError::NONE;
 }
 
 // Фабричный метод для создания сокетного логгера
@@ -121,4 +395,14 @@ std::unique_ptr<Logger> create_socket_logger(const std::string& host, int port,
         return nullptr; // Возврат nullptr при ошибке инициализации
     
     return logger;
+}
+
+// Фабричный метод для сокетного логгера с фоновым подключением (nullptr только при неверном адресе)
+std::unique_ptr<SocketLogger> create_async_socket_logger(const std::string& host, int port, LogLevel level,
+                                                         const ConnectOptions& options)
+{
+    auto logger = std::make_unique<SocketLogger>(host, port, level);
+    if (logger->start_async(options) != LoggerError::NONE)
+        return nullptr;
+    return logger;
 }
\ No newline at end of file
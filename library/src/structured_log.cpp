@@ -0,0 +1,295 @@
+#include "structured_log.h"
+#include "pattern_layout.h"
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    const char* level_name(LogLevel level)
+    {
+        switch (level)
+        {
+            case LogLevel::DEBUG: return "DEBUG";
+            case LogLevel::INFO: return "INFO";
+            case LogLevel::ERROR: return "ERROR";
+            default: return "UNKNOWN";
+        }
+    }
+
+    // Длина корректной последовательности UTF-8, начинающейся в p (0 - некорректная):
+    // без избыточных форм, суррогатов и значений больше U+10FFFF
+    size_t utf8_sequence(const unsigned char* p, const unsigned char* end)
+    {
+        size_t avail = end - p;
+        auto cont = [](unsigned char c) { return (c & 0xC0) == 0x80; };
+
+        if (p[0] >= 0xC2 && p[0] <= 0xDF)
+            return avail >= 2 && cont(p[1]) ? 2 : 0;
+        if (p[0] >= 0xE0 && p[0] <= 0xEF)
+        {
+            if (avail < 3 || !cont(p[1]) || !cont(p[2]))
+                return 0;
+            if ((p[0] == 0xE0 && p[1] < 0xA0) || (p[0] == 0xED && p[1] >= 0xA0))
+                return 0;
+            return 3;
+        }
+        if (p[0] >= 0xF0 && p[0] <= 0xF4)
+        {
+            if (avail < 4 || !cont(p[1]) || !cont(p[2]) || !cont(p[3]))
+                return 0;
+            if ((p[0] == 0xF0 && p[1] < 0x90) || (p[0] == 0xF4 && p[1] >= 0x90))
+                return 0;
+            return 4;
+        }
+        return 0;
+    }
+
+    template<typename T>
+    void append_number(std::string& out, T value)
+    {
+        char buffer[32];
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        out.append(buffer, result.ptr);
+    }
+
+    // Значение поля в JSON; NaN и бесконечность не представимы и выводятся как null
+    void append_json_value(const LogField& field, std::string& out)
+    {
+        switch (field.type)
+        {
+            case LogField::Type::INT: append_number(out, field.i); break;
+            case LogField::Type::UINT: append_number(out, field.u); break;
+            case LogField::Type::DOUBLE:
+                if (std::isfinite(field.d))
+                    append_number(out, field.d);
+                else
+                    out += "null";
+                break;
+            case LogField::Type::BOOL: out += field.b ? "true" : "false"; break;
+            case LogField::Type::STRING:
+                out += '"';
+                json_escape(field.str, out);
+                out += '"';
+                break;
+        }
+    }
+
+    // Ключи, которые encode_json выводит сам
+    bool is_reserved_key(std::string_view key)
+    {
+        return key == "time" || key == "level" || key == "msg" || key == "fields_truncated" || key == "tid";
+    }
+
+    bool has_field(const StructuredRecord& record, std::string_view key)
+    {
+        for (const LogField& field : record)
+            if (field.key == key)
+                return true;
+        return false;
+    }
+
+    // Метка времени ISO 8601 (местное время, наносекунды)
+    void append_time(std::chrono::system_clock::time_point time, std::string& out)
+    {
+        layout::append_date(out, time, layout::DateStyle::ISO8601);
+    }
+}
+
+void json_escape(std::string_view str, std::string& out)
+{
+    static const char hex[] = "0123456789abcdef";
+    const auto* p = reinterpret_cast<const unsigned char*>(str.data());
+    const auto* end = p + str.size();
+    out.reserve(out.size() + str.size() + 2);
+
+    while (p < end)
+    {
+#ifdef __SSE2__
+        // Поиск первого байта, требующего обработки: '"', '\\', управляющие (< 0x20)
+        // и не-ASCII (>= 0x80, проверка UTF-8). Знаковое сравнение с 0x20 ловит оба диапазона
+        const __m128i quote = _mm_set1_epi8('"');
+        const __m128i backslash = _mm_set1_epi8('\\');
+        const __m128i space = _mm_set1_epi8(0x20);
+        while (end - p >= 16)
+        {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote),
+                                                        _mm_cmpeq_epi8(chunk, backslash)),
+                                           _mm_cmplt_epi8(chunk, space));
+            int mask = _mm_movemask_epi8(special);
+            if (mask == 0)
+            {
+                out.append(reinterpret_cast<const char*>(p), 16);
+                p += 16;
+                continue;
+            }
+
+            int skip = __builtin_ctz(mask);
+            out.append(reinterpret_cast<const char*>(p), skip);
+            p += skip;
+            break;
+        }
+        if (p == end)
+            break;
+#endif
+        unsigned char c = *p;
+        if (c >= 0x80)
+        {
+            // Серия не-ASCII символов: корректные последовательности копируются одним куском
+            const unsigned char* run = p;
+            while (p < end && *p >= 0x80)
+            {
+                size_t len = utf8_sequence(p, end);
+                if (len > 0)
+                {
+                    p += len;
+                    continue;
+                }
+                out.append(reinterpret_cast<const char*>(run), p - run);
+                out += "\\ufffd";
+                run = ++p;
+            }
+            out.append(reinterpret_cast<const char*>(run), p - run);
+            continue;
+        }
+        if (c >= 0x20 && c != '"' && c != '\\')
+        {
+            // Серия обычных символов (хвост короче 16 байт или сборка без SSE2)
+            const unsigned char* run = p;
+            while (p < end && *p >= 0x20 && *p < 0x80 && *p != '"' && *p != '\\')
+                ++p;
+            out.append(reinterpret_cast<const char*>(run), p - run);
+            continue;
+        }
+
+        switch (c)
+        {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            case '\b': out += "\\b"; break;
+            case '\f': out += "\\f"; break;
+            default:
+            {
+                char escape[6] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF]};
+                out.append(escape, 6);
+            }
+        }
+        ++p;
+    }
+}
+
+void encode_json(const StructuredRecord& record, std::string& out)
+{
+    out += "{\"time\":\"";
+    append_time(record.get_time(), out);
+    out += "\",\"level\":\"";
+    out += level_name(record.get_level());
+    out += "\",\"msg\":\"";
+    json_escape(record.get_msg(), out);
+    out += '"';
+
+    for (const LogField& field : record)
+    {
+        out += ",\"";
+        json_escape(field.key, out);
+        out += "\":";
+        append_json_value(field, out);
+    }
+    if (record.is_truncated())
+        out += ",\"fields_truncated\":true";
+
+    // Поля контекста не повторяют ключи записи: поле записи и служебные ключи важнее
+    const LogContext& context = LogContext::current();
+    if (context.has_fields())
+    {
+        context.for_each([&](const ContextField& field)
+        {
+            if (is_reserved_key(field.key) || has_field(record, field.key))
+                return;
+            out += ",\"";
+            json_escape(field.key, out);
+            out += "\":\"";
+            json_escape(field.value, out);
+            out += '"';
+        });
+
+        uint32_t id = context.thread_id();
+        if (id != 0 && !has_field(record, "tid"))
+        {
+            out += ",\"tid\":";
+            append_number(out, id);
+        }
+    }
+    out += "}\n";
+}
+
+void format_text_fields(const StructuredRecord& record, std::string& out)
+{
+    out += record.get_msg();
+    for (const LogField& field : record)
+    {
+        out += ' ';
+        out += field.key;
+        out += '=';
+        if (field.type != LogField::Type::STRING)
+        {
+            append_json_value(field, out);
+            continue;
+        }
+
+        // Строки с пробелами и кавычками берутся в кавычки, чтобы пары разбирались однозначно
+        bool quote = field.str.empty() || field.str.find_first_of(" \"=\n\t") != std::string_view::npos;
+        if (quote)
+        {
+            out += '"';
+            json_escape(field.str, out);
+            out += '"';
+        }
+        else
+            out += field.str;
+    }
+}
+
+void format_line(const StructuredRecord& record, LogFormat format, const PatternLayout* layout, std::string& out)
+{
+    if (format == LogFormat::JSON)
+    {
+        encode_json(record, out);
+        return;
+    }
+
+    // Запись без полей форматируется без промежуточной копии сообщения
+    thread_local std::string text;
+    std::string_view msg = record.get_msg();
+    if (record.size() != 0)
+    {
+        text.clear();
+        format_text_fields(record, text);
+        msg = text;
+    }
+
+    LayoutRecord line{record.get_level(), msg, record.get_time()};
+    if (layout)
+        layout->format(line, out);
+    else
+        DefaultLayout::format(line, out);
+    out.push_back('\n');
+}
+
+// Запись по умолчанию: поля дописываются к тексту сообщения
+LoggerError Logger::log_record(const StructuredRecord& record)
+{
+    if (record.get_level() < get_log_level())
+        return LoggerError::NONE;
+
+    std::string text;
+    format_text_fields(record, text);
+    return log_at(text, record.get_level(), record.get_time());
+}
@@ -0,0 +1,136 @@
+#include "tsc_clock.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+namespace
+{
+    // Инвариантный TSC идет с постоянной частотой независимо от состояния ядра
+    bool has_invariant_tsc()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        unsigned eax, ebx, ecx, edx;
+        if (__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) && eax >= 0x80000007 &&
+            __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx))
+            return edx & (1u << 8);
+#endif
+        return false;
+    }
+
+    int64_t system_ns()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    // Начало измерения частоты. Снимается при загрузке библиотеки: к первому переводу
+    // тактов интервал для начальной оценки обычно уже набран и ждать не нужно
+    struct StartPoint
+    {
+        uint64_t ticks;
+        int64_t ns;
+    };
+    const StartPoint start_point{TscClock::now(), system_ns()};
+    StartPoint origin{}; // Начало, принятое калибровкой (запись - в call_once)
+
+    // Параметры перевода под seqlock: читатели не блокируются и повторяют чтение,
+    // если версия нечетная (идет обновление) или изменилась за время чтения.
+    // Обновляет один поток - тот, кто захватил update_mutex через try_lock
+    struct Calibration
+    {
+        std::atomic<uint32_t> version{0};
+        std::atomic<uint64_t> base_ticks{0};   // Опорная точка для перевода
+        std::atomic<int64_t> base_ns{0};
+        std::atomic<double> ns_per_tick{1.0};
+    };
+
+    Calibration calibration;
+    std::once_flag calibration_once;
+    std::mutex update_mutex;
+
+    void publish(uint64_t base_ticks, int64_t base_ns, double ns_per_tick)
+    {
+        uint32_t version = calibration.version.load(std::memory_order_relaxed);
+        calibration.version.store(version + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        calibration.base_ticks.store(base_ticks, std::memory_order_relaxed);
+        calibration.base_ns.store(base_ns, std::memory_order_relaxed);
+        calibration.ns_per_tick.store(ns_per_tick, std::memory_order_relaxed);
+        calibration.version.store(version + 2, std::memory_order_release);
+    }
+
+    // Коэффициент по всему интервалу от начальной точки
+    double measure(uint64_t ticks, int64_t ns)
+    {
+        if (!TscClock::is_tsc() || ticks <= origin.ticks)
+            return 1.0;
+        return double(ns - origin.ns) / double(ticks - origin.ticks);
+    }
+
+    // Начальная калибровка (один раз): оценка частоты по интервалу не короче 10 мс.
+    // Вызов из статического конструктора другой единицы трансляции может опередить
+    // инициализацию start_point (она еще нулевая) - тогда интервал отсчитывается от вызова
+    void calibrate()
+    {
+        uint64_t ticks = TscClock::now();
+        int64_t ns = system_ns();
+        origin = start_point.ns != 0 ? start_point : StartPoint{ticks, ns};
+        if (TscClock::is_tsc() && ns - origin.ns < 10000000)
+        {
+            std::this_thread::sleep_for(std::chrono::nanoseconds(10000000 - (ns - origin.ns)));
+            ticks = TscClock::now();
+            ns = system_ns();
+        }
+        publish(ticks, ns, measure(ticks, ns));
+    }
+}
+
+bool TscClock::detect_tsc()
+{
+    return has_invariant_tsc();
+}
+
+std::chrono::system_clock::time_point TscClock::to_time_point(uint64_t ticks)
+{
+    std::call_once(calibration_once, calibrate);
+
+    uint64_t base_ticks;
+    int64_t base_ns;
+    double ns_per_tick;
+    while (true)
+    {
+        uint32_t version = calibration.version.load(std::memory_order_acquire);
+        base_ticks = calibration.base_ticks.load(std::memory_order_relaxed);
+        base_ns = calibration.base_ns.load(std::memory_order_relaxed);
+        ns_per_tick = calibration.ns_per_tick.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (!(version & 1) && calibration.version.load(std::memory_order_relaxed) == version)
+            break;
+    }
+
+    // Раз в секунду: уточнение частоты по всему интервалу и новая опорная точка,
+    // чтобы учесть коррекцию системных часов. Остальные потоки не ждут обновления
+    uint64_t now_ticks = now();
+    if (now_ticks > base_ticks && double(now_ticks - base_ticks) * ns_per_tick >= 1e9 && update_mutex.try_lock())
+    {
+        if (calibration.base_ticks.load(std::memory_order_relaxed) == base_ticks)
+        {
+            int64_t now_ns = system_ns();
+            base_ticks = now_ticks;
+            base_ns = now_ns;
+            ns_per_tick = measure(now_ticks, now_ns);
+            publish(base_ticks, base_ns, ns_per_tick);
+        }
+        update_mutex.unlock();
+    }
+
+    // Такты могут быть как до, так и после опорной точки
+    double delta = ticks >= base_ticks ? double(ticks - base_ticks) : -double(base_ticks - ticks);
+    int64_t ns = base_ns + static_cast<int64_t>(delta * ns_per_tick);
+    return std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(ns)));
+}
@@ -0,0 +1,506 @@
+#include "uring_file_logger.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#if __has_include(<linux/io_uring.h>) && defined(__NR_io_uring_setup)
+#include <linux/io_uring.h>
+#define LOGGING_HAS_IO_URING 1
+#endif
+
+// Кольца io_uring: очередь отправки (SQ) и очередь завершений (CQ) в памяти, общей с ядром.
+// Используется только фоновым потоком логгера
+class UringRing
+{
+public:
+#ifdef LOGGING_HAS_IO_URING
+    // nullptr, если ядро не поддерживает io_uring (ENOSYS, запрет seccomp, io_uring_disabled)
+    // или старее 5.4 (нет IORING_FEAT_SINGLE_MMAP и связанных операций)
+    static std::unique_ptr<UringRing> create(unsigned entries)
+    {
+        io_uring_params params{};
+        int fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+        if (fd < 0)
+            return nullptr;
+
+        std::unique_ptr<UringRing> ring(new UringRing());
+        ring->fd = fd;
+        if (!(params.features & IORING_FEAT_SINGLE_MMAP))
+            return nullptr;
+
+        // SQ и CQ отображаются одним участком
+        size_t sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        size_t cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        ring->ring_size = sq_size > cq_size ? sq_size : cq_size;
+        void* ptr = ::mmap(nullptr, ring->ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                           IORING_OFF_SQ_RING);
+        if (ptr == MAP_FAILED)
+            return nullptr;
+        ring->ring_ptr = static_cast<char*>(ptr);
+
+        ring->sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+        ptr = ::mmap(nullptr, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                     IORING_OFF_SQES);
+        if (ptr == MAP_FAILED)
+            return nullptr;
+        ring->sqes = static_cast<io_uring_sqe*>(ptr);
+
+        char* base = ring->ring_ptr;
+        ring->sq_tail = reinterpret_cast<unsigned*>(base + params.sq_off.tail);
+        ring->sq_mask = *reinterpret_cast<unsigned*>(base + params.sq_off.ring_mask);
+        ring->sq_array = reinterpret_cast<unsigned*>(base + params.sq_off.array);
+        ring->cq_head = reinterpret_cast<unsigned*>(base + params.cq_off.head);
+        ring->cq_tail = reinterpret_cast<unsigned*>(base + params.cq_off.tail);
+        ring->cq_mask = *reinterpret_cast<unsigned*>(base + params.cq_off.ring_mask);
+        ring->cqes = reinterpret_cast<io_uring_cqe*>(base + params.cq_off.cqes);
+        return ring;
+    }
+
+    ~UringRing()
+    {
+        if (sqes)
+            ::munmap(sqes, sqes_size);
+        if (ring_ptr)
+            ::munmap(ring_ptr, ring_size);
+        if (fd != -1)
+            ::close(fd);
+    }
+
+    // Запись iov по смещению; link - следующая операция начнется только после успешной записи
+    void add_write(int file, const iovec* iov, uint64_t offset, uint64_t user_data, bool link)
+    {
+        io_uring_sqe* sqe = next_sqe();
+        sqe->opcode = IORING_OP_WRITEV;
+        sqe->fd = file;
+        sqe->addr = reinterpret_cast<uintptr_t>(iov);
+        sqe->len = 1;
+        sqe->off = offset;
+        sqe->user_data = user_data;
+        if (link)
+            sqe->flags = IOSQE_IO_LINK;
+        push();
+    }
+
+    void add_datasync(int file, uint64_t user_data)
+    {
+        io_uring_sqe* sqe = next_sqe();
+        sqe->opcode = IORING_OP_FSYNC;
+        sqe->fd = file;
+        sqe->fsync_flags = IORING_FSYNC_DATASYNC;
+        sqe->user_data = user_data;
+        push();
+    }
+
+    // Отправка подготовленных операций одним системным вызовом; wait - ждать хотя бы одно завершение.
+    // Возвращает false при ошибке io_uring_enter
+    bool enter(bool wait)
+    {
+        if (pending == 0 && !wait)
+            return true;
+
+        while (true)
+        {
+            long result = ::syscall(__NR_io_uring_enter, fd, pending, wait ? 1 : 0,
+                                    wait ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+            if (result >= 0)
+            {
+                pending -= static_cast<unsigned>(result);
+                return true;
+            }
+            if (errno == EINTR)
+                continue;
+            // Очередь завершений переполнена или не хватает памяти: сначала разобрать завершения
+            return errno == EAGAIN || errno == EBUSY;
+        }
+    }
+
+    // Обход готовых завершений: f(user_data, res)
+    template<typename F>
+    void reap(F f)
+    {
+        unsigned head = *cq_head;
+        unsigned tail = __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE);
+        for (; head != tail; ++head)
+        {
+            const io_uring_cqe& cqe = cqes[head & cq_mask];
+            uint64_t user_data = cqe.user_data;
+            int res = cqe.res;
+            __atomic_store_n(cq_head, head + 1, __ATOMIC_RELEASE); // Место в CQ освобождается до вызова f
+            f(user_data, res);
+        }
+    }
+
+private:
+    UringRing() = default;
+
+    // Следующий свободный SQE; места хватает всегда - на буфер не больше двух операций
+    io_uring_sqe* next_sqe()
+    {
+        unsigned index = *sq_tail & sq_mask;
+        io_uring_sqe* sqe = &sqes[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sq_array[index] = index;
+        return sqe;
+    }
+
+    // Публикация SQE для ядра
+    void push()
+    {
+        __atomic_store_n(sq_tail, *sq_tail + 1, __ATOMIC_RELEASE);
+        pending++;
+    }
+
+    int fd = -1;
+    char* ring_ptr = nullptr;
+    size_t ring_size = 0;
+    io_uring_sqe* sqes = nullptr;
+    size_t sqes_size = 0;
+    unsigned *sq_tail = nullptr, *sq_array = nullptr;
+    unsigned sq_mask = 0;
+    unsigned *cq_head = nullptr, *cq_tail = nullptr;
+    unsigned cq_mask = 0;
+    io_uring_cqe* cqes = nullptr;
+    unsigned pending = 0; // Подготовлено, но не отправлено
+#else
+    // Заголовков io_uring нет: всегда запись через pwrite
+    static std::unique_ptr<UringRing> create(unsigned) { return nullptr; }
+    void add_write(int, const iovec*, uint64_t, uint64_t, bool) {}
+    void add_datasync(int, uint64_t) {}
+    bool enter(bool) { return false; }
+    template<typename F>
+    void reap(F) {}
+#endif
+};
+
+// Признак операции fdatasync в user_data (адрес буфера выровнен)
+static constexpr uint64_t SYNC_TAG = 1;
+
+UringFileLogger::UringFileLogger(const std::string& file_name, LogLevel level, UringOptions options)
+    : name(file_name), options(options), log_level(level)
+{
+    if (this->options.buffers < 2)
+        this->options.buffers = 2;
+    if (this->options.buffer_size == 0)
+        this->options.buffer_size = 1 << 20;
+}
+
+// Деструктор: запись накопленного и остановка фонового потока
+UringFileLogger::~UringFileLogger()
+{
+    if (writer.joinable())
+    {
+        flush();
+        {
+            std::lock_guard<LogMutex> lock(log_mutex);
+            stop = true;
+        }
+        ready_condition.notify_one();
+        writer.join();
+    }
+    ring.reset();
+    if (fd != -1)
+        ::close(fd);
+}
+
+LoggerError UringFileLogger::init()
+{
+    if (fd != -1)
+        return LoggerError::NONE;
+
+    // Без O_APPEND: смещение каждого буфера назначается при постановке в очередь
+    fd = ::open(name.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0666);
+    if (fd == -1)
+        return LoggerError::FILE_OPEN_FAILED;
+    off_t end = ::lseek(fd, 0, SEEK_END);
+    file_end = end > 0 ? static_cast<uint64_t>(end) : 0;
+
+    for (size_t i = 0; i < options.buffers; ++i)
+    {
+        storage.push_back(std::make_unique<Buffer>());
+        storage.back()->data.reserve(options.buffer_size);
+        free_buffers.push_back(storage.back().get());
+    }
+    current = free_buffers.back();
+    free_buffers.pop_back();
+
+    // Записей в полете не больше buffers - 1, на каждую - запись и fdatasync
+    if (options.use_uring)
+    {
+        unsigned entries = 1;
+        while (entries < 2 * options.buffers)
+            entries <<= 1;
+        ring = UringRing::create(entries);
+        uring_active.store(ring != nullptr, std::memory_order_relaxed);
+    }
+
+    writer = std::thread(&UringFileLogger::writer_loop, this);
+    return LoggerError::NONE;
+}
+
+bool UringFileLogger::uring_supported()
+{
+    return UringRing::create(2) != nullptr;
+}
+
+std::string UringFileLogger::get_backend() const
+{
+    return uring_active.load(std::memory_order_relaxed) ? "io_uring" : "pwrite";
+}
+
+LoggerError UringFileLogger::log(const std::string& msg, LogLevel level)
+{
+    if (level < log_level.load(std::memory_order_relaxed)) return LoggerError::NONE;
+    return log_at(msg, level, std::chrono::system_clock::now());
+}
+
+LoggerError UringFileLogger::log_at(const std::string& msg, LogLevel level, std::chrono::system_clock::time_point time)
+{
+    if (level < log_level.load(std::memory_order_relaxed)) return LoggerError::NONE;
+    return log_record(StructuredRecord(msg, level, time));
+}
+
+// Форматирование вне мьютекса в буфер потока, который переиспользуется между записями
+LoggerError UringFileLogger::log_record(const StructuredRecord& record)
+{
+    if (record.get_level() < log_level.load(std::memory_order_relaxed)) return LoggerError::NONE;
+
+    thread_local std::string line;
+    line.clear();
+    format_line(record, get_format(), layout.get(), line);
+    return write_line(line);
+}
+
+// Копирование строки в текущий буфер; заполненный буфер уходит фоновому потоку
+LoggerError UringFileLogger::write_line(const std::string& line)
+{
+    LogUniqueLock lock(log_mutex);
+    if (fd == -1)
+        return LoggerError::FILE_OPEN_FAILED;
+
+    while (!current->data.empty() && current->data.size() + line.size() > options.buffer_size)
+    {
+        if (free_buffers.empty())
+        {
+            stalls.fetch_add(1, std::memory_order_relaxed);
+            free_condition.wait(lock);
+            continue;
+        }
+        rotate();
+    }
+    current->data.append(line); // Строка длиннее buffer_size занимает буфер целиком
+    return LoggerError::NONE;
+}
+
+void UringFileLogger::rotate()
+{
+    Buffer* buffer = current;
+    buffer->seq = next_seq++;
+    buffer->offset = file_end;
+    buffer->done = 0;
+    buffer->failed = false;
+    file_end += buffer->data.size();
+    outstanding.insert(buffer->seq);
+    ready.push_back(buffer);
+
+    current = free_buffers.back();
+    free_buffers.pop_back();
+
+    // Пока фоновый поток занят записью, вызывающий поток обходится без системных вызовов
+    if (writer_waiting)
+        ready_condition.notify_one();
+}
+
+LoggerError UringFileLogger::flush()
+{
+    LogUniqueLock lock(log_mutex);
+    if (fd == -1)
+        return LoggerError::FILE_OPEN_FAILED;
+
+    while (!current->data.empty() && free_buffers.empty())
+        free_condition.wait(lock);
+    if (!current->data.empty())
+        rotate();
+
+    uint64_t target = next_seq - 1;
+    free_condition.wait(lock, [&] { return outstanding.empty() || *outstanding.begin() > target; });
+
+    bool failed = failed_since_flush;
+    failed_since_flush = false;
+    return failed ? LoggerError::WRITE_FAILED : LoggerError::NONE;
+}
+
+LoggerError UringFileLogger::sync()
+{
+    LoggerError result = flush();
+    if (result != LoggerError::NONE || options.sync)
+        return result; // С options.sync каждый буфер уже записан на диск
+    return ::fdatasync(fd) == 0 ? LoggerError::NONE : LoggerError::WRITE_FAILED;
+}
+
+void UringFileLogger::writer_loop()
+{
+    std::vector<Buffer*> batch;
+    while (true)
+    {
+        {
+            LogUniqueLock lock(log_mutex);
+            if (in_flight == 0)
+            {
+                if (ready.empty() && !stop)
+                {
+                    writer_waiting = true;
+                    ready_condition.wait_for(lock, options.flush_interval, [this] { return stop || !ready.empty(); });
+                    writer_waiting = false;
+                }
+
+                // Пауза в потоке записей: неполный буфер тоже уходит в запись
+                if (ready.empty() && !current->data.empty() && !free_buffers.empty())
+                    rotate();
+            }
+
+            batch.assign(ready.begin(), ready.end());
+            ready.clear();
+            if (stop && batch.empty() && in_flight == 0 && current->data.empty())
+                break;
+        }
+
+        if (!ring)
+        {
+            for (Buffer* buffer : batch)
+                write_direct(buffer);
+            continue;
+        }
+
+        // Вся пачка отправляется одним io_uring_enter; без новых буферов - ожидание завершений
+        for (Buffer* buffer : batch)
+            submit_ring(buffer);
+        if (in_flight > 0)
+            reap_ring(batch.empty());
+    }
+}
+
+void UringFileLogger::submit_ring(Buffer* buffer)
+{
+    buffer->in_ring = true;
+    buffer->iov.iov_base = buffer->data.data() + buffer->done;
+    buffer->iov.iov_len = buffer->data.size() - buffer->done;
+    uint64_t user_data = reinterpret_cast<uintptr_t>(buffer);
+
+    // fdatasync связан с записью: выполняется только после нее и отменяется при ошибке
+    ring->add_write(fd, &buffer->iov, buffer->offset + buffer->done, user_data, options.sync);
+    in_flight++;
+    if (options.sync)
+    {
+        ring->add_datasync(fd, user_data | SYNC_TAG);
+        in_flight++;
+    }
+}
+
+void UringFileLogger::reap_ring(bool wait)
+{
+    bool submitted = ring->enter(wait);
+    submits.fetch_add(1, std::memory_order_relaxed);
+    if (!submitted)
+    {
+        // Не должно происходить; после нескольких неудач подряд - переход на pwrite,
+        // иначе буферы в полете не завершились бы никогда и flush ждал бы вечно
+        std::cerr << "Ошибка io_uring_enter: " << std::strerror(errno) << std::endl;
+        if (++enter_failures >= MAX_ENTER_FAILURES)
+        {
+            fall_back();
+            return;
+        }
+        std::this_thread::sleep_for(options.flush_interval);
+    }
+    else
+        enter_failures = 0;
+
+    ring->reap([this](uint64_t user_data, int res)
+    {
+        in_flight--;
+        Buffer* buffer = reinterpret_cast<Buffer*>(user_data & ~SYNC_TAG);
+        if (!(user_data & SYNC_TAG))
+        {
+            // EAGAIN и EINTR - остаток отправляется повторно; 0 байт - ошибка, как в write_direct
+            // (иначе тот же остаток отправлялся бы без конца)
+            if (res > 0)
+                buffer->done += static_cast<size_t>(res);
+            else if (res == 0 || (res != -EAGAIN && res != -EINTR))
+                buffer->failed = true;
+
+            if (options.sync)
+                return; // Итог по завершению fdatasync
+        }
+        else if (res < 0 && res != -ECANCELED)
+            buffer->failed = true;
+
+        // Неполная запись: связанный fdatasync отменен (ECANCELED), остаток - заново
+        if (!buffer->failed && buffer->done < buffer->data.size())
+            submit_ring(buffer);
+        else
+            complete(buffer);
+    });
+}
+
+// Отказ от io_uring: незавершенные буферы дописываются через pwrite с подтвержденного места.
+// Повторная запись уже записанного ядром участка безопасна - смещения фиксированы
+void UringFileLogger::fall_back()
+{
+    std::cerr << "Запись " << name << " переведена на pwrite" << std::endl;
+    ring.reset();
+    uring_active.store(false, std::memory_order_relaxed);
+    in_flight = 0;
+    for (auto& buffer : storage)
+    {
+        if (buffer->in_ring)
+            write_direct(buffer.get());
+    }
+}
+
+void UringFileLogger::write_direct(Buffer* buffer)
+{
+    submits.fetch_add(1, std::memory_order_relaxed);
+    while (buffer->done < buffer->data.size())
+    {
+        ssize_t result = ::pwrite(fd, buffer->data.data() + buffer->done, buffer->data.size() - buffer->done,
+                                  static_cast<off_t>(buffer->offset + buffer->done));
+        if (result < 0 && errno == EINTR)
+            continue;
+        if (result <= 0)
+        {
+            buffer->failed = true;
+            break;
+        }
+        buffer->done += static_cast<size_t>(result);
+    }
+    if (!buffer->failed && options.sync && ::fdatasync(fd) != 0)
+        buffer->failed = true;
+    complete(buffer);
+}
+
+void UringFileLogger::complete(Buffer* buffer)
+{
+    std::lock_guard<LogMutex> lock(log_mutex);
+    if (buffer->failed)
+    {
+        errors.fetch_add(1, std::memory_order_relaxed);
+        failed_since_flush = true;
+    }
+    writes.fetch_add(1, std::memory_order_relaxed);
+    buffer->in_ring = false;
+    outstanding.erase(buffer->seq);
+    buffer->data.clear(); // Емкость сохраняется
+    free_buffers.push_back(buffer);
+    free_condition.notify_all();
+}
+
+std::unique_ptr<Logger> create_uring_file_logger(const std::string& file_name, LogLevel level, UringOptions options)
+{
+    auto logger = std::make_unique<UringFileLogger>(file_name, level, options);
+    if (logger->init() != LoggerError::NONE)
+        return nullptr;
+    return logger;
+}
@@ -1,9 +1,32 @@
 #include "logger.h"
 #include "file_logger.h"
 #include "socket_logger.h"
+#include "multi_socket_logger.h"
+#include "log_index.h"
+#include "log_parser.h"
+#include "binary_file_logger.h"
+#include "block_codec.h"
+#include "rate_limit.h"
+#include "dedup_logger.h"
+#include "flight_recorder.h"
+#include "tsc_clock.h"
+#include "log_category.h"
+#include "log_config.h"
+#include "shm_ring.h"
+#include "structured_log.h"
+#include "lock_profiler.h"
+#include "uring_file_logger.h"
+#include "log_forwarder.h"
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <poll.h>
+#include <sys/stat.h>
 #include <filesystem>
 #include <thread>
 #include <vector>
+#include <set>
+#include <algorithm>
 
 namespace fs = std::filesystem; 
 
@@ -22,7 +45,29 @@ void clean()
         "test_create.log",
         "test_level.log",
         "test_format.log",
-        "test_multithreaded.log"
+        "test_multithreaded.log",
+        "test_index.log",
+        "test_index.log.idx",
+        "test_index_gap.log",
+        "test_index_gap.log.idx",
+        "test_binary.bin",
+        "test_compressed.log",
+        "test_dedup.log",
+        "test_dedup.json",
+        "test_flight.ring",
+        "test_config.conf",
+        "test_config_a.log",
+        "test_config_b.log",
+        "test_config_c.log",
+        "test_structured.log",
+        "test_context.log",
+        "test_layout.log",
+        "test_uring.log",
+        "test_staging.log",
+        "test_staging.log.idx",
+        "test_forward.log",
+        "test_forward.log.1",
+        "test_forward.log.fwd"
     };   
 
     // Удаляем каждый тестовый файл, если он существует
@@ -129,6 +174,562 @@ bool test_file_multithreaded()
     return lines == thread_cnt * msg_cnt;
 }
 
+// Тест: Разреженный индекс по времени и уровням
+bool test_file_index()
+{
+    {
+        FileLogger logger("test_index.log", LogLevel::DEBUG);
+        if (logger.enable_index(2, 3600) != LoggerError::NONE)
+            return false;
+
+        logger.log("first", LogLevel::DEBUG);
+        logger.log("second", LogLevel::INFO);
+        logger.log("third", LogLevel::ERROR);
+        logger.log("fourth", LogLevel::INFO);
+        logger.log("fifth", LogLevel::ERROR);
+    }
+
+    LogIndex index;
+    if (!index.open("test_index.log.idx") || index.size() != 3)
+        return false;
+
+    // Каждый блок должен начинаться с корректной строки журнала
+    std::ifstream file("test_index.log", std::ios::binary);
+    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    uint64_t expected = 0;
+    for (const auto& entry : index)
+    {
+        LogRecord record;
+        std::string_view block(content.data() + entry.offset, entry.length);
+        if (entry.offset != expected || !parse_log_line(block.substr(0, block.find('\n')), record))
+            return false;
+        expected += entry.length;
+    }
+
+    const LogIndexEntry& first = index.begin()[0];
+    auto [from, to] = index.find_range(first.first_time, first.first_time + 1);
+    if (expected != content.size() || first.counts[0] != 1 || first.counts[1] != 1 ||
+        LogIndex::has_level(first, LogLevel::ERROR) || from != 0 || to != 3 ||
+        !index.uncovered(content.size()).empty())
+        return false;
+
+    // Записи до включения индекса и запуска без индекса - участки вне индекса
+    std::vector<uint64_t> sizes;
+    for (int run = 0; run < 4; ++run)
+    {
+        FileLogger logger("test_index_gap.log", LogLevel::DEBUG);
+        if (run % 2 == 1 && logger.enable_index(1, 3600) != LoggerError::NONE)
+            return false;
+        logger.log("run " + std::to_string(run), LogLevel::INFO);
+        logger.flush();
+        sizes.push_back(std::filesystem::file_size("test_index_gap.log"));
+    }
+
+    LogIndex gaps;
+    if (!gaps.open("test_index_gap.log.idx") || gaps.size() != 2)
+        return false;
+    auto uncovered = gaps.uncovered(sizes[3]);
+    return uncovered.size() == 2 && uncovered[0] == std::pair<uint64_t, uint64_t>(0, sizes[0]) &&
+           uncovered[1] == std::pair<uint64_t, uint64_t>(sizes[1], sizes[2]);
+}
+
+// Тест: Двоичный формат (запись и декодирование с шаблонами)
+bool test_file_binary()
+{
+    std::vector<std::string> msgs =
+    {
+        "user 15 login",
+        "user 16 login",                 // Ссылка на шаблон
+        "code 007 and 0",                // Ведущие нули сохраняются текстом
+        "id 1234567890123456789012345",  // Слишком длинное число
+        std::string("zero\0byte", 9),   // Литерал
+        "user 18446744073709551615 login"
+    };
+
+    {
+        BinaryFileLogger logger("test_binary.bin", LogLevel::DEBUG);
+        for (size_t i = 0; i < msgs.size(); ++i)
+            logger.log(msgs[i], i % 2 ? LogLevel::ERROR : LogLevel::DEBUG);
+    }
+    {
+        // Второе открытие дописывает новый сегмент
+        BinaryFileLogger logger("test_binary.bin", LogLevel::INFO);
+        logger.log("debug skipped", LogLevel::DEBUG);
+        logger.log("user 17 login", LogLevel::INFO);
+    }
+    msgs.push_back("user 17 login");
+
+    std::ifstream file("test_binary.bin", std::ios::binary);
+    BinaryLogDecoder decoder(file);
+    BinaryLogRecord record;
+    size_t i = 0;
+    int64_t last = 0;
+    while (decoder.next(record))
+    {
+        if (i >= msgs.size() || record.msg != msgs[i] || record.time_ns < last)
+            return false;
+        if (i < 6 && record.level != (i % 2 ? LogLevel::ERROR : LogLevel::DEBUG))
+            return false;
+        last = record.time_ns;
+        ++i;
+    }
+
+    return !decoder.failed() && i == msgs.size();
+}
+
+// Тест: Блочное сжатие (кодек и сжатый FileLogger)
+bool test_file_compression()
+{
+    // Кодек: повторяющиеся, случайные и пустые данные
+    std::string repeated;
+    for (int i = 0; i < 1000; ++i)
+        repeated += "[2024-01-15 14:30:25] [INFO] request " + std::to_string(i % 7) + " done\n";
+    std::string random_data;
+    for (int i = 0; i < 5000; ++i)
+        random_data.push_back(static_cast<char>((i * 7919) ^ (i >> 3)));
+
+    for (const std::string* data : {&repeated, &random_data})
+    {
+        std::string packed, unpacked;
+        compress_block(data->data(), data->size(), packed);
+        size_t pos = 0;
+        if (!decompress_block(packed.data(), packed.size(), pos, unpacked) || unpacked != *data)
+            return false;
+    }
+
+    {
+        FileLogger logger("test_compressed.log", LogLevel::INFO);
+        if (logger.enable_compression(4096) != LoggerError::NONE ||
+            logger.enable_index() != LoggerError::FILE_OPEN_FAILED)
+            return false;
+        for (int i = 0; i < 500; ++i)
+            logger.log("compressed msg " + std::to_string(i), LogLevel::INFO);
+    }
+
+    std::ifstream file("test_compressed.log", std::ios::binary);
+    std::string packed((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    std::string text;
+    size_t pos = 0, blocks = 0;
+    while (pos < packed.size() && decompress_block(packed.data(), packed.size(), pos, text))
+        blocks++;
+
+    // Чтение с середины файла: переход к следующему независимому блоку
+    size_t middle = find_block(packed.data(), packed.size(), packed.size() / 2);
+    std::string tail;
+    bool seek_ok = middle < packed.size() && decompress_block(packed.data(), packed.size(), middle, tail);
+
+    return pos == packed.size() && blocks > 1 && seek_ok && packed.size() < text.size() &&
+           std::count(text.begin(), text.end(), '\n') == 500 &&
+           text.find("compressed msg 499") != std::string::npos;
+}
+
+// Тест: Структурированные записи в JSON и в тексте
+bool test_file_structured()
+{
+    std::string path = "/api/\"v1\"\n";
+    std::string invalid = "bad \xC3\x28 utf8 \xD0\xBE\xD0\xBA"; // Оборванная последовательность и "ок"
+    {
+        FileLogger logger("test_structured.log", LogLevel::INFO);
+        logger.set_format(LogFormat::JSON);
+        logger.log_record(StructuredRecord("request done", LogLevel::INFO)
+            .add("status", 200).add("bytes", uint64_t(1) << 40).add("ms", 1.5)
+            .add("ok", true).add("path", path).add("note", invalid));
+        logger.log_record(StructuredRecord("filtered", LogLevel::DEBUG).add("x", 1));
+        {
+            // Поле контекста с ключом поля записи или служебным ключом не повторяется
+            ContextScope status("status", "ctx");
+            ContextScope msg("msg", "ctx");
+            ContextScope request("req", "7");
+            logger.log_record(StructuredRecord("ctx", LogLevel::INFO).add("status", 1));
+        }
+        logger.error("plain \t msg");
+
+        logger.set_format(LogFormat::TEXT);
+        logger.log_record(StructuredRecord("request done", LogLevel::INFO)
+            .add("status", -1).add("user", "root").add("path", "a b"));
+    }
+
+    std::ifstream file("test_structured.log");
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(file, line))
+        lines.push_back(line);
+
+    // Строки JSON разбираются теми же функциями, что и текст (logquery, logsearch)
+    LogRecord parsed, escaped;
+    LogLevel level = LogLevel::DEBUG;
+    bool tools = lines.size() == 4 && parse_log_line(lines[0], parsed) && parsed.level == LogLevel::INFO &&
+                 parsed.msg == "request done" && parse_log_line(lines[2], escaped) &&
+                 escaped.msg == "plain \\t msg" && peek_log_level(lines[2], level) && level == LogLevel::ERROR;
+
+    return lines.size() == 4 && tools &&
+           lines[0].compare(0, 9, "{\"time\":\"") == 0 &&
+           lines[0].find("\"level\":\"INFO\",\"msg\":\"request done\",\"status\":200,\"bytes\":1099511627776,"
+                         "\"ms\":1.5,\"ok\":true,\"path\":\"/api/\\\"v1\\\"\\n\","
+                         "\"note\":\"bad \\ufffd( utf8 \xD0\xBE\xD0\xBA\"}") != std::string::npos &&
+           lines[1].find("\"msg\":\"ctx\",\"status\":1,\"req\":\"7\"}") != std::string::npos &&
+           lines[2].find("\"level\":\"ERROR\",\"msg\":\"plain \\t msg\"}") != std::string::npos &&
+           lines[3].find("[INFO] request done status=-1 user=root path=\"a b\"") != std::string::npos;
+}
+
+// Тест: Контекст потока - вложенные области, JSON, передача снимка в другой поток
+bool test_file_context()
+{
+    ContextSnapshot snapshot;
+    {
+        FileLogger logger("test_context.log", LogLevel::INFO);
+        ContextScope trace("trace", std::to_string(42)); // Значение копируется, временная строка допустима
+        {
+            ContextScope tenant("tenant", "acme corp");
+            logger.info("inner");
+            logger.set_format(LogFormat::JSON);
+            logger.info("json");
+            logger.set_format(LogFormat::TEXT);
+        }
+        logger.info("outer");
+
+        // Снимок, как при постановке в очередь; поток записи выводит поля источника
+        LogContext::set_thread_ids(true);
+        snapshot.capture();
+        LogContext::set_thread_ids(false);
+        std::thread([&]
+        {
+            logger.info("own");
+            ContextRestore restore(snapshot);
+            logger.info("restored");
+        }).join();
+    }
+    {
+        FileLogger logger("test_context.log", LogLevel::INFO);
+        logger.info("plain");
+    }
+
+    std::ifstream file("test_context.log");
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(file, line))
+        lines.push_back(line);
+
+    std::string tid = " tid=" + std::to_string(snapshot.get_thread_id());
+    auto ends_with = [](const std::string& str, const std::string& end)
+    {
+        return str.size() >= end.size() && str.compare(str.size() - end.size(), end.size(), end) == 0;
+    };
+    // Контекст больше встроенного буфера переносится целиком, сверх CAPACITY - отбрасывается
+    ContextSnapshot large;
+    std::string value(40, 'v'), joined;
+    size_t fields = 0;
+    while (large.append("key", value))
+        fields++;
+    large.for_each([&joined](const ContextField& field) { joined += std::string(field.key) + "=" + std::string(field.value) + ";"; });
+    bool spilled = fields == ContextSnapshot::CAPACITY / (2 + 3 + value.size()) &&
+                   fields * (2 + 3 + value.size()) > ContextSnapshot::INLINE_CAPACITY &&
+                   joined.size() == fields * (5 + value.size());
+
+    return lines.size() == 6 && snapshot.get_thread_id() != 0 && spilled &&
+           ends_with(lines[0], "] inner trace=42 tenant=\"acme corp\"") &&
+           ends_with(lines[1], "\"msg\":\"json\",\"trace\":\"42\",\"tenant\":\"acme corp\"}") &&
+           ends_with(lines[2], "] outer trace=42") && ends_with(lines[3], "] own") &&
+           ends_with(lines[4], "] restored trace=42" + tid) && ends_with(lines[5], "] plain");
+}
+
+// Тест: Шаблоны строк - элементы шаблона, специализация стандартного макета, ошибки разбора
+bool test_file_layout()
+{
+    std::string error;
+    if (PatternLayout::compile("%d %q", "", &error) || error.empty() || PatternLayout::compile("%d{HH:mm}"))
+        return false;
+
+    auto time = std::chrono::system_clock::now();
+    std::unique_ptr<PatternLayout> standard = PatternLayout::compile(PatternLayout::DEFAULT_PATTERN);
+    std::string line;
+    standard->format(LayoutRecord{LogLevel::ERROR, "same", time}, line);
+    if (!standard->is_specialized() || line != Logger::msg_format(LogLevel::ERROR, "same", time))
+        return false;
+
+    std::string epoch = std::to_string(std::chrono::system_clock::to_time_t(time));
+    {
+        FileLogger logger("test_layout.log", LogLevel::INFO);
+        logger.set_layout(PatternLayout::compile("%d{EPOCH} %t %l %c: %m 100%%%X", "svc"));
+        ContextScope trace("trace", "7");
+        logger.log_at("started", LogLevel::INFO, time);
+        logger.log_record(StructuredRecord("done", LogLevel::ERROR, time).add("ms", 5));
+    }
+
+    std::ifstream file("test_layout.log");
+    std::vector<std::string> lines;
+    while (std::getline(file, line))
+        lines.push_back(line);
+
+    std::string prefix = epoch + ".";
+    std::string tid = " " + std::to_string(LogContext::current().native_thread_id()) + " ";
+    return lines.size() == 2 && lines[0].compare(0, prefix.size(), prefix) == 0 &&
+           lines[0].find(tid + "INFO svc: started 100% trace=7") == prefix.size() + 9 &&
+           lines[1].find(" ERROR svc: done ms=5 100% trace=7") != std::string::npos;
+}
+
+// Тест: Асинхронная запись через io_uring и запасной путь pwrite.
+// Маленькие буферы: запись упирается в свободные буферы, строки идут через несколько пачек
+bool test_file_uring()
+{
+    {
+        std::ofstream file("test_uring.log");
+        file << "old\n";
+    }
+
+    // io_uring без fdatasync, io_uring со связанным fdatasync, pwrite с fdatasync
+    struct Case
+    {
+        const char* tag;
+        bool sync, use_uring;
+    };
+    const Case cases[] = {{"uring", false, true}, {"linked", true, true}, {"pwrite", true, false}};
+    const int case_cnt = 3, thread_cnt = 4, msg_cnt = 2000;
+    std::string expected_backend = UringFileLogger::uring_supported() ? "io_uring" : "pwrite";
+    for (const Case& test : cases)
+    {
+        UringFileLogger logger("test_uring.log", LogLevel::INFO,
+                               UringOptions{4096, 4, std::chrono::milliseconds(5), test.sync, test.use_uring});
+        if (logger.init() != LoggerError::NONE ||
+            logger.get_backend() != (test.use_uring ? expected_backend : "pwrite"))
+            return false;
+
+        std::vector<std::thread> threads;
+        for (int i = 0; i < thread_cnt; ++i)
+            threads.emplace_back([&logger, i, &test]()
+            {
+                for (int j = 0; j < msg_cnt; ++j)
+                    logger.info(std::string(test.tag) + " " + std::to_string(i) + " " + std::to_string(j));
+            });
+        for (auto& t : threads)
+            t.join();
+
+        if (logger.sync() != LoggerError::NONE || logger.get_errors() != 0 || logger.get_writes() < 2)
+            return false;
+    }
+
+    // Все строки целы, по порядку внутри каждого потока, после прежнего содержимого
+    std::ifstream file("test_uring.log");
+    std::string line;
+    std::getline(file, line);
+    if (line != "old")
+        return false;
+
+    std::vector<int> next(case_cnt * thread_cnt, 0);
+    int lines = 0;
+    while (std::getline(file, line))
+    {
+        size_t pos = line.find("] [INFO] ");
+        if (pos == std::string::npos)
+            return false;
+        std::istringstream fields(line.substr(pos + 9));
+        std::string backend;
+        int thread = -1, msg = -1;
+        fields >> backend >> thread >> msg;
+        int index = 0;
+        while (index < case_cnt && backend != cases[index].tag)
+            index++;
+        if (thread < 0 || thread >= thread_cnt || index == case_cnt)
+            return false;
+        int& expected = next[index * thread_cnt + thread];
+        if (msg != expected++)
+            return false;
+        lines++;
+    }
+    return lines == case_cnt * thread_cnt * msg_cnt;
+}
+
+// Тест: Буферы потоков - слияние по времени записей, порядок внутри потока, индекс
+bool test_file_staging()
+{
+    // Два потока с чередующимися временами: слияние восстанавливает общий порядок
+    auto base = std::chrono::system_clock::now();
+    {
+        FileLogger logger("test_staging.log", LogLevel::INFO);
+        logger.enable_staging(1 << 20, std::chrono::milliseconds(60000));
+        for (int part : {0, 1})
+            std::thread([&logger, base, part]()
+            {
+                for (int i = part; i < 6; i += 2)
+                    logger.log_at("t" + std::to_string(i), LogLevel::INFO, base + std::chrono::seconds(i));
+            }).join();
+        if (logger.flush() != LoggerError::NONE)
+            return false;
+    }
+
+    // Много потоков и маленькие буферы: слияние и фоновым потоком, и в потоке записи
+    const int thread_cnt = 4, msg_cnt = 5000;
+    {
+        FileLogger logger("test_staging.log", LogLevel::INFO);
+        if (logger.enable_index(1000, 3600) != LoggerError::NONE || logger.enable_staging(4096) != LoggerError::NONE)
+            return false;
+        std::vector<std::thread> threads;
+        for (int i = 0; i < thread_cnt; ++i)
+            threads.emplace_back([&logger, i]()
+            {
+                for (int j = 0; j < msg_cnt; ++j)
+                    logger.info("thread " + std::to_string(i) + " " + std::to_string(j));
+            });
+        for (auto& t : threads)
+            t.join();
+    }
+
+    std::ifstream file("test_staging.log");
+    std::string line;
+    for (int i = 0; i < 6; ++i)
+        if (!std::getline(file, line) || line.find("] t" + std::to_string(i)) == std::string::npos)
+            return false;
+
+    std::vector<int> next(thread_cnt, 0);
+    int lines = 0;
+    while (std::getline(file, line))
+    {
+        int thread = -1, msg = -1;
+        if (std::sscanf(line.c_str() + line.find("] thread ") + 9, "%d %d", &thread, &msg) != 2 ||
+            thread < 0 || thread >= thread_cnt || msg != next[thread]++)
+            return false;
+        lines++;
+    }
+
+    LogIndex index;
+    uint64_t indexed = 0;
+    if (!index.open("test_staging.log.idx"))
+        return false;
+    for (const auto& entry : index)
+        indexed += entry.counts[1];
+    return lines == thread_cnt * msg_cnt && indexed == static_cast<uint64_t>(lines);
+}
+
+// Тест: Подавление повторяющихся сообщений
+bool test_file_dedup()
+{
+    {
+        auto logger = create_dedup_logger(create_file_logger("test_dedup.log", LogLevel::INFO),
+                                          std::chrono::milliseconds(10000), 2);
+        for (int i = 0; i < 1000; ++i)
+            logger->error("disk full");
+        logger->info("recovered");
+        for (int i = 0; i < 10; ++i)
+            logger->error("disk full");   // Повтор в пределах окна из 2 сообщений
+        logger->info("other");            // Вытесняет "disk full" из окна
+        logger->info("other");
+    }
+    {
+        // Структурированные записи сравниваются вместе с полями и доходят до логгера с полями
+        auto sink = std::make_unique<FileLogger>("test_dedup.json", LogLevel::INFO);
+        sink->set_format(LogFormat::JSON);
+        DedupLogger logger(std::move(sink), std::chrono::milliseconds(10000));
+        for (int i = 0; i < 3; ++i)
+            logger.log_record(StructuredRecord("slow query", LogLevel::INFO).add("ms", 250));
+        logger.log_record(StructuredRecord("slow query", LogLevel::INFO).add("ms", 900));
+    }
+
+    std::ifstream file("test_dedup.log");
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(file, line))
+        lines.push_back(line);
+
+    std::ifstream json_file("test_dedup.json");
+    std::vector<std::string> json;
+    while (std::getline(json_file, line))
+        json.push_back(line);
+
+    return lines.size() == 5 &&
+           lines[0].find("[ERROR] disk full") != std::string::npos &&
+           lines[1].find("[INFO] recovered") != std::string::npos &&
+           lines[2].find("сообщение повторено 1009 раз") != std::string::npos &&
+           lines[2].find("последнее") == std::string::npos && lines[2].find("): disk full") != std::string::npos &&
+           lines[3].find("[INFO] other") != std::string::npos &&
+           lines[4].find("повторено 1 раз") != std::string::npos && lines[4].find("): other") != std::string::npos &&
+           json.size() == 3 && json[0].find("\"msg\":\"slow query\",\"ms\":250}") != std::string::npos &&
+           json[1].find("повторено 2 раз") != std::string::npos &&
+           json[2].find("\"msg\":\"slow query\",\"ms\":900}") != std::string::npos;
+}
+
+// Тест: Самописец переживает аварийное завершение процесса
+bool test_flight_recorder()
+{
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        // Дочерний процесс: кольцо 1 МБ переполняется несколько раз, затем abort()
+        auto recorder = create_flight_recorder("test_flight.ring", 1, LogLevel::DEBUG);
+        if (!recorder) _exit(1);
+        FlightRecorder::install_signal_handlers(recorder.get());
+        std::string padding(200, 'x');
+        for (int i = 0; i < 20000; ++i)
+            recorder->info("record " + std::to_string(i) + " " + padding);
+        abort();
+    }
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    if (!WIFSIGNALED(status) || WTERMSIG(status) != SIGABRT)
+        return false;
+
+    std::vector<RecoveredRecord> records;
+    if (!FlightRecorder::recover("test_flight.ring", records) || records.size() < 100)
+        return false;
+
+    // Последние записи идут подряд, последней стоит отметка о сигнале
+    for (size_t i = 1; i < records.size(); ++i)
+        if (records[i].seq != records[i - 1].seq + 1)
+            return false;
+
+    const auto& crash = records.back();
+    const auto& last = records[records.size() - 2];
+    if (crash.level != LogLevel::ERROR || crash.msg.find("сигнал 6") == std::string::npos ||
+        last.msg.find("record 19999 ") != 0)
+        return false;
+
+    // SIGTERM откладывается: процесс продолжает работу до finish_termination
+    pid = fork();
+    if (pid == 0)
+    {
+        auto recorder = create_flight_recorder("test_flight.ring", 1, LogLevel::DEBUG);
+        if (!recorder) _exit(1);
+        FlightRecorder::install_signal_handlers(recorder.get());
+        raise(SIGTERM);
+        pollfd wake{FlightRecorder::termination_fd(), POLLIN, 0};
+        if (FlightRecorder::termination_signal() != SIGTERM || poll(&wake, 1, 0) != 1)
+            _exit(2);
+        recorder->info("после SIGTERM");
+        FlightRecorder::finish_termination();
+        _exit(3);
+    }
+
+    waitpid(pid, &status, 0);
+    records.clear();
+    return WIFSIGNALED(status) && WTERMSIG(status) == SIGTERM &&
+           FlightRecorder::recover("test_flight.ring", records) && records.size() >= 2 &&
+           records[records.size() - 2].msg.find("сигналу 15") != std::string::npos &&
+           records.back().msg == "после SIGTERM";
+}
+
+// Тест: Такты TscClock переводятся в системное время с наносекундным разрешением
+bool test_tsc_clock()
+{
+    auto before = std::chrono::system_clock::now();
+    uint64_t first = TscClock::now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    uint64_t second = TscClock::now();
+
+    auto first_time = TscClock::to_time_point(first);
+    auto second_time = TscClock::to_time_point(second);
+    auto drift = first_time > before ? first_time - before : before - first_time;
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(second_time - first_time).count();
+
+    // Метка времени в тексте содержит наносекунды и разбирается обратно
+    LogRecord record;
+    auto stamp = std::chrono::system_clock::time_point(std::chrono::seconds(1700000000)) +
+                 std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(123456789));
+    std::string line = Logger::msg_format(LogLevel::INFO, "ns", stamp);
+
+    return drift < std::chrono::milliseconds(50) && elapsed >= 4000 && elapsed < 100000 &&
+           parse_log_line(line, record) && record.nsec == 123456789 && record.time == 1700000000;
+}
+
 // SocketLogger tests 
 
 // Тест: Создание объекта SocketLogger (без реального подключения)
@@ -160,6 +761,683 @@ bool test_socket_invalid_connection()
     return logger == nullptr;
 }
 
+// Тест: Фоновое подключение - запуск без сервера, буфер до подключения, отправка после
+bool test_socket_async()
+{
+    // Порт занят, но не слушает: подключения отклоняются, пока не вызван listen
+    int server = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len = sizeof(addr);
+    if (server == -1 || bind(server, (sockaddr*)&addr, sizeof(addr)) != 0 ||
+        getsockname(server, (sockaddr*)&addr, &len) != 0)
+        return false;
+
+    ConnectOptions options;
+    options.timeout = std::chrono::milliseconds(200);
+    options.retry = std::chrono::milliseconds(20);
+
+    auto start = std::chrono::steady_clock::now();
+    auto logger = create_async_socket_logger("127.0.0.1", ntohs(addr.sin_port), LogLevel::INFO, options);
+    bool fast = logger && std::chrono::steady_clock::now() - start < std::chrono::milliseconds(100);
+    if (!logger)
+        return false;
+
+    for (int i = 0; i < 5; i++)
+        logger->log("async " + std::to_string(i), LogLevel::INFO);
+    bool waiting = !logger->wait_connected(std::chrono::milliseconds(50));
+
+    listen(server, 1);
+    int client = accept(server, nullptr, nullptr);
+    bool connected = logger->wait_connected(std::chrono::seconds(2));
+    logger->log("async 5", LogLevel::INFO);
+
+    std::string data;
+    char buffer[1024];
+    timeval tv{2, 0};
+    setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    while (std::count(data.begin(), data.end(), '\n') < 6)
+    {
+        ssize_t n = recv(client, buffer, sizeof(buffer), 0);
+        if (n <= 0)
+            break;
+        data.append(buffer, n);
+    }
+    logger.reset();
+    close(client);
+    close(server);
+
+    return fast && waiting && connected && data.find("async 0") < data.find("async 4") &&
+           data.find("async 4") < data.find("async 5") && std::count(data.begin(), data.end(), '\n') == 6;
+}
+
+// Локальный получатель: слушающий сокет на свободном порту
+int open_listener(int& port)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len = sizeof(addr);
+    if (fd == -1 || bind(fd, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(fd, 4) != 0 ||
+        getsockname(fd, (sockaddr*)&addr, &len) != 0)
+        return -1;
+    port = ntohs(addr.sin_port);
+    return fd;
+}
+
+// Чтение строк из соединения, пока их не станет count (или до таймаута)
+size_t read_lines(int fd, size_t count)
+{
+    std::string data;
+    char buffer[4096];
+    timeval tv{1, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    while (static_cast<size_t>(std::count(data.begin(), data.end(), '\n')) < count)
+    {
+        ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        if (n <= 0)
+            break;
+        data.append(buffer, n);
+    }
+    return std::count(data.begin(), data.end(), '\n');
+}
+
+// Тест: Несколько получателей - распределение по кругу, исключение отключившегося, ключи
+bool test_socket_multi()
+{
+    int ports[3], listeners[3], clients[3];
+    std::vector<SocketEndpoint> endpoints;
+    for (int i = 0; i < 3; i++)
+    {
+        listeners[i] = open_listener(ports[i]);
+        if (listeners[i] == -1)
+            return false;
+        endpoints.push_back({"127.0.0.1", ports[i]});
+    }
+
+    SocketPoolOptions options;
+    options.probe = std::chrono::milliseconds(20);
+    auto logger = create_multi_socket_logger(endpoints, LogLevel::INFO, options);
+    if (!logger)
+        return false;
+    for (int i = 0; i < 3; i++)
+        clients[i] = accept(listeners[i], nullptr, nullptr);
+
+    // По кругу: каждому получателю поровну
+    for (int i = 0; i < 30; i++)
+        logger->log("round " + std::to_string(i), LogLevel::INFO);
+    bool balanced = read_lines(clients[0], 10) == 10 && read_lines(clients[1], 10) == 10 &&
+                    read_lines(clients[2], 10) == 10;
+
+    // Получатель 2 отключается: поток проверки исключает его, записи уходят остальным
+    close(clients[2]);
+    close(listeners[2]);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (logger->is_healthy(2) && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    bool excluded = !logger->is_healthy(2) && logger->get_healthy() == 2;
+
+    for (int i = 0; i < 20; i++)
+        logger->log("failover " + std::to_string(i), LogLevel::INFO);
+    bool delivered = read_lines(clients[0], 10) + read_lines(clients[1], 10) == 20;
+
+    logger.reset();
+    for (int i = 0; i < 2; i++)
+    {
+        close(clients[i]);
+        close(listeners[i]);
+    }
+
+    // Режим HASH: записи одного ключа приходят одному получателю
+    int port0, port1;
+    int listener0 = open_listener(port0), listener1 = open_listener(port1);
+    options.balance = BalanceMode::HASH;
+    auto keyed = create_multi_socket_logger({{"127.0.0.1", port0}, {"127.0.0.1", port1}}, LogLevel::INFO, options);
+    if (!keyed)
+        return false;
+    int client0 = accept(listener0, nullptr, nullptr), client1 = accept(listener1, nullptr, nullptr);
+    for (int i = 0; i < 10; i++)
+        keyed->log_keyed("user-42", "keyed " + std::to_string(i), LogLevel::INFO);
+    keyed->log("debug", LogLevel::DEBUG); // Ниже уровня логгера
+    size_t first = std::hash<std::string>{}("user-42") % 2;
+    size_t lines0 = read_lines(client0, first == 0 ? 10 : 1), lines1 = read_lines(client1, first == 1 ? 10 : 1);
+    keyed.reset();
+    close(client0); close(client1); close(listener0); close(listener1);
+
+    bool same = (first == 0 ? lines0 == 10 && lines1 == 0 : lines1 == 10 && lines0 == 0);
+
+    // Соединение пула, закрытое проверкой, не подключается заново в потоке записи
+    int port2;
+    int listener2 = open_listener(port2);
+    SocketLogger single("127.0.0.1", port2, LogLevel::INFO);
+    single.set_verbose(false);
+    single.set_reconnect_on_send(false);
+    bool no_connect = single.init() == LoggerError::NONE;
+    int client2 = accept(listener2, nullptr, nullptr);
+    close(client2);
+    auto closed_by = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (single.check_connection() && std::chrono::steady_clock::now() < closed_by)
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    pollfd pending{listener2, POLLIN, 0};
+    no_connect = no_connect && single.log("lost", LogLevel::INFO) == LoggerError::WRITE_FAILED &&
+                 !single.is_connected() && poll(&pending, 1, 50) == 0;
+    close(listener2);
+
+    return balanced && excluded && delivered && same && no_connect;
+}
+
+// Тест: Разрыв соединения посреди строки - по новому соединению строка уходит целиком
+bool test_socket_partial()
+{
+    int port;
+    int listener = open_listener(port);
+    if (listener == -1)
+        return false;
+
+    ConnectOptions options;
+    options.timeout = std::chrono::milliseconds(200); // Зависший получатель держит send не дольше
+    options.retry = std::chrono::milliseconds(20);
+    options.buffer_limit = 64 << 20;
+    auto logger = create_async_socket_logger("127.0.0.1", port, LogLevel::INFO, options);
+    if (!logger)
+        return false;
+    logger->set_verbose(false);
+    int first = accept(listener, nullptr, nullptr);
+    int small = 256 << 10; // Без автонастройки окна: сообщения не помещаются в буферы сокетов
+    setsockopt(first, SOL_SOCKET, SO_RCVBUF, &small, sizeof(small));
+    bool connected = logger->wait_connected(std::chrono::seconds(2));
+
+    // Получатель не читает: одна из строк уходит частично, и send прерывается по таймауту.
+    // Пишет отдельный поток: повторная отправка идет под log_mutex и ждет чтения получателем
+    const size_t count = 4, size = 4 << 20;
+    std::thread writer([&]
+    {
+        for (size_t i = 0; i < count; i++)
+            logger->log(std::string(size, static_cast<char>('a' + i)), LogLevel::INFO);
+    });
+
+    auto read_all = [](int fd, std::string& data)
+    {
+        char buffer[1 << 16];
+        timeval tv{2, 0};
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        while (true)
+        {
+            ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+            if (n <= 0)
+                break;
+            data.append(buffer, n);
+        }
+    };
+
+    // После разрыва логгер подключается заново: первое соединение читается до EOF,
+    // второе - пока логгер не отправит буфер
+    pollfd reconnect{listener, POLLIN, 0};
+    poll(&reconnect, 1, 5000);
+    std::string head, tail;
+    read_all(first, head);
+    int second = accept(listener, nullptr, nullptr);
+    read_all(second, tail);
+
+    writer.join();
+    logger.reset();
+    close(first);
+    close(second);
+    close(listener);
+
+    // Целая строка: "[дата] [INFO] " и size одинаковых букв; возвращает букву или 0
+    size_t line_size = Logger::msg_format(LogLevel::INFO, std::string(size, 'a')).size();
+    auto whole = [&](const std::string& line) -> char
+    {
+        if (line.size() != line_size || line[0] != '[' ||
+            line.find_first_not_of(line.back(), line.size() - size) != std::string::npos)
+            return 0;
+        return line.back();
+    };
+
+    // Второе соединение начинается с начала строки и содержит только целые строки;
+    // вместе с целыми строками первого они покрывают все сообщения
+    std::set<char> seen;
+    size_t start = 0, end;
+    while ((end = head.find('\n', start)) != std::string::npos)
+    {
+        seen.insert(whole(head.substr(start, end - start)));
+        start = end + 1;
+    }
+    bool broken = start < head.size(); // Первое соединение оборвалось посреди строки
+    bool aligned = !tail.empty() && tail.back() == '\n';
+    for (start = 0; aligned && (end = tail.find('\n', start)) != std::string::npos; start = end + 1)
+    {
+        char letter = whole(tail.substr(start, end - start));
+        aligned = letter != 0;
+        seen.insert(letter);
+    }
+
+    return connected && broken && aligned && seen.count(0) == 0 && seen.size() == count;
+}
+
+// Чтение из соединения, пока не придет count строк (или до таймаута)
+std::string read_text(int fd, size_t count)
+{
+    std::string data;
+    char buffer[4096];
+    timeval tv{1, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    while (static_cast<size_t>(std::count(data.begin(), data.end(), '\n')) < count)
+    {
+        ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        if (n <= 0)
+            break;
+        data.append(buffer, n);
+    }
+    return data;
+}
+
+// Тест: Пересылка журнала - продолжение с сохраненной позиции после перезапуска
+bool test_forward_resume()
+{
+    std::ofstream("test_forward.log") << "a1\na2\n";
+    int port;
+    int listener = open_listener(port);
+    if (listener == -1)
+        return false;
+    std::string target = "127.0.0.1:" + std::to_string(port);
+    ForwardOptions options;
+    options.connect_timeout = std::chrono::milliseconds(500);
+
+    std::string first, second;
+    {
+        LogForwarder forwarder("test_forward.log", target, options);
+        if (forwarder.init() != LoggerError::NONE || forwarder.step() != LoggerError::NONE)
+            return false;
+        forwarder.save();
+        int client = accept(listener, nullptr, nullptr);
+        first = read_text(client, 2);
+        close(client);
+    }
+
+    // Дописанное при остановленной пересылке уходит без повтора уже отправленного
+    std::ofstream("test_forward.log", std::ios::app) << "a3\n";
+    {
+        LogForwarder forwarder("test_forward.log", target, options);
+        if (forwarder.init() != LoggerError::NONE || forwarder.step() != LoggerError::NONE)
+            return false;
+        int client = accept(listener, nullptr, nullptr);
+        second = read_text(client, 1);
+        close(client);
+    }
+    close(listener);
+
+    return first == "a1\na2\n" && second == "a3\n";
+}
+
+// Тест: Пересылка журнала - ротация и сбой во время дочитывания старого файла
+bool test_forward_rotation()
+{
+    fs::remove("test_forward.log.fwd");
+    std::ofstream("test_forward.log") << "b1\n";
+    int port;
+    int listener = open_listener(port);
+    if (listener == -1)
+        return false;
+    std::string target = "127.0.0.1:" + std::to_string(port);
+    ForwardOptions options;
+    options.connect_timeout = std::chrono::milliseconds(500);
+
+    std::string before, tail;
+    bool saved_old = false;
+    {
+        LogForwarder forwarder("test_forward.log", target, options);
+        if (forwarder.init() != LoggerError::NONE || forwarder.step() != LoggerError::NONE)
+            return false;
+        int client = accept(listener, nullptr, nullptr);
+
+        // Ротация: процесс успевает дописать в старый файл, новый создается под тем же именем
+        std::ofstream("test_forward.log", std::ios::app) << "b2\n";
+        fs::rename("test_forward.log", "test_forward.log.1");
+        std::ofstream("test_forward.log") << "c1\n";
+        forwarder.step();
+        before = read_text(client, 2);
+
+        // Пока старый файл дочитывается, в позиции хранятся его inode и смещение
+        struct stat st{};
+        unsigned long long ino = 0, old_ino = 0;
+        long long offset = 0, old_offset = 0;
+        std::ifstream checkpoint("test_forward.log.fwd");
+        saved_old = stat("test_forward.log.1", &st) == 0 && (checkpoint >> ino >> offset >> old_ino >> old_offset) &&
+                    old_ino == st.st_ino && old_offset == 6 && forwarder.has_rotated() && forwarder.is_draining();
+        close(client);
+    } // Остановка без сохранения - как при сбое
+
+    // Процесс еще писал в старый файл: после перезапуска дочитывается его хвост, затем новый файл
+    std::ofstream("test_forward.log.1", std::ios::app) << "b3\n";
+    {
+        LogForwarder forwarder("test_forward.log", target, options);
+        if (forwarder.init() != LoggerError::NONE || forwarder.step(true) != LoggerError::NONE)
+            return false;
+        int client = accept(listener, nullptr, nullptr);
+        tail = read_text(client, 2);
+        close(client);
+        saved_old = saved_old && !forwarder.is_draining();
+    }
+    close(listener);
+
+    return before == "b1\nb2\n" && saved_old && tail == "b3\nc1\n";
+}
+
+// Rate limiting tests
+
+// Логгер в памяти для проверки числа сообщений
+class MemoryLogger : public Logger
+{
+public:
+    LoggerError log(const std::string& msg, LogLevel level) override
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (level >= log_level)
+            msgs.push_back(msg);
+        return LoggerError::NONE;
+    }
+    void set_log_level(LogLevel level) override { log_level = level; }
+    LogLevel get_log_level() const override { return log_level; }
+    std::string get_type() const override { return "memory"; }
+
+    LoggerError log_record(const StructuredRecord& record) override
+    {
+        records++;
+        return Logger::log_record(record);
+    }
+
+    std::vector<std::string> msgs;
+    std::atomic<int> records{0}; // Вызовов log_record
+    std::mutex mutex;
+    LogLevel log_level = LogLevel::DEBUG;
+};
+
+// Тест: Выборка 1 из N и корзина токенов по месту вызова
+bool test_rate_limit()
+{
+    MemoryLogger logger;
+    int evaluated = 0;
+    auto make_msg = [&evaluated]() { evaluated++; return std::string("hot path"); };
+
+    for (int i = 0; i < 100; ++i)
+        LOG_SAMPLED(logger, LogLevel::DEBUG, 10, make_msg());
+    bool sampled = logger.msgs.size() == 10 && evaluated == 10; // Сообщение не вычисляется при подавлении
+
+    logger.msgs.clear();
+    for (int i = 0; i < 100; ++i)
+        LOG_RATE_LIMITED(logger, LogLevel::ERROR, 0.001, 5, "error path");
+    bool limited = logger.msgs.size() == 5;
+
+    // Фильтр по уровню логгера срабатывает раньше ограничения и не считается подавлением
+    logger.set_log_level(LogLevel::ERROR);
+    for (int i = 0; i < 10; ++i)
+        LOG_FIRST_THEN_SAMPLED(logger, LogLevel::DEBUG, 1, 2, "filtered");
+
+    // Сводки идут только в логгер, который подавил сообщения
+    MemoryLogger other;
+    CallSite::report_all(other);
+    bool foreign = other.msgs.empty();
+
+    // Сводка DEBUG не проходит уровень логгера: ее счетчик сохраняется до следующей сводки
+    logger.msgs.clear();
+    CallSite::report_all(logger);
+    bool summary = logger.msgs.size() == 1 &&
+                   logger.msgs[0].find("подавлено сообщений: 95") != std::string::npos;
+
+    logger.set_log_level(LogLevel::DEBUG);
+    logger.msgs.clear();
+    CallSite::report_all(logger);
+    bool kept = logger.msgs.size() == 1 && logger.msgs[0].find("подавлено сообщений: 90") != std::string::npos;
+
+    // Структурированная запись проходит через log_record, а не склеивается в строку
+    logger.msgs.clear();
+    for (int i = 0; i < 4; ++i)
+        LOG_SAMPLED(logger, LogLevel::INFO, 2, StructuredRecord("sampled", LogLevel::INFO).add("i", i));
+    bool records = logger.records == 2 &&
+                   std::find(logger.msgs.begin(), logger.msgs.end(), "sampled i=2") != logger.msgs.end();
+
+    return sampled && limited && foreign && summary && kept && records;
+}
+
+// Category tests
+
+// Тест: Наследование уровней категорий и общий логгер
+bool test_categories()
+{
+    // Уровень общего логгера реестр не меняет
+    auto shared = std::make_shared<MemoryLogger>();
+    shared->set_log_level(LogLevel::ERROR);
+    CategoryRegistry shared_registry(shared);
+    bool untouched = shared->get_log_level() == LogLevel::ERROR;
+
+    auto sink = std::make_shared<MemoryLogger>(); // Приемник только для реестра, уровень DEBUG
+    CategoryRegistry registry(sink, LogLevel::INFO);
+
+    LogCategory& http = registry.get("net.http");
+    LogCategory& db = registry.get("db");
+    LogCategory& net = registry.get("net");
+
+    bool inherited = !http.is_enabled(LogLevel::DEBUG) && http.get_log_level() == LogLevel::INFO;
+
+    // DEBUG только для подсистемы net и ее потомков
+    net.set_log_level(LogLevel::DEBUG);
+    LOG_CATEGORY(http, LogLevel::DEBUG, "http debug");
+    LOG_CATEGORY(db, LogLevel::DEBUG, "db debug");
+    db.info("db info");
+
+    // Явный уровень потомка не перезаписывается родителем
+    http.set_log_level(LogLevel::ERROR);
+    net.set_log_level(LogLevel::INFO);
+    registry.root().set_log_level(LogLevel::ERROR);
+    bool explicit_kept = http.get_log_level() == LogLevel::ERROR && net.get_log_level() == LogLevel::INFO &&
+                         db.get_log_level() == LogLevel::ERROR;
+
+    http.reset_log_level();
+    bool reset = http.get_log_level() == LogLevel::INFO && &registry.get("net.http") == &http;
+
+    return untouched && inherited && explicit_kept && reset && sink->msgs.size() == 2 &&
+           sink->msgs[0] == "[net.http] http debug" && sink->msgs[1] == "[db] db info";
+}
+
+// Тест: Перезагрузка конфигурации при изменении файла
+bool test_config_reload()
+{
+    auto write_config = [](const std::string& text)
+    {
+        // Запись через переименование, как это делают редакторы
+        std::ofstream("test_config.conf.tmp") << text;
+        fs::rename("test_config.conf.tmp", "test_config.conf");
+    };
+
+    write_config("level = INFO\n[sink main]\ntype = file\npath = test_config_a.log\n");
+
+    bool reloaded = false, invalid_kept = false, deferred = false, released = false;
+    {
+        auto logger = create_config_logger("test_config.conf");
+        if (!logger)
+            return false;
+
+        logger->info("first");
+        logger->debug("hidden");
+
+        // Пишущий поток, удерживающий снимок во время перезагрузки, не удаляет старый приемник
+        auto held = logger->snapshot();
+        std::weak_ptr<Logger> old_sink = held->sinks[0];
+
+        write_config("level = DEBUG\n[sink main]\ntype = file\npath = test_config_b.log\nlevel = DEBUG\n");
+        for (int i = 0; i < 200 && logger->get_version() < 2; ++i)
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        reloaded = logger->get_version() == 2;
+        logger->debug("second");
+
+        held.reset();
+        deferred = !old_sink.expired();
+        for (int i = 0; i < 200 && !old_sink.expired(); ++i)
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        released = old_sink.expired(); // Удален потоком слежения
+
+        // Ошибка в файле не меняет действующую конфигурацию
+        std::ofstream("test_config.conf") << "[sink broken]\ntype = pipe\n";
+        invalid_kept = logger->load() != LoggerError::NONE && logger->get_version() == 2;
+    }
+
+    // Категории пишут через category_sink(): их уровни не снижают общий уровень конфигурации
+    write_config("level = INFO\n[sink main]\ntype = file\npath = test_config_c.log\nlevel = DEBUG\n"
+                 "[category net]\nlevel = DEBUG\n");
+    bool separate = false;
+    {
+        auto logger = create_config_logger("test_config.conf", false);
+        if (!logger)
+            return false;
+        CategoryRegistry registry(logger->category_sink());
+        logger->attach_categories(&registry);
+        registry.get("net").debug("net debug");
+        registry.get("db").debug("db debug");
+        logger->debug("direct debug");
+        separate = logger->get_log_level() == LogLevel::INFO;
+    }
+
+    std::ifstream a("test_config_a.log"), b("test_config_b.log"), c("test_config_c.log");
+    std::string text_a((std::istreambuf_iterator<char>(a)), std::istreambuf_iterator<char>());
+    std::string text_b((std::istreambuf_iterator<char>(b)), std::istreambuf_iterator<char>());
+    std::string text_c((std::istreambuf_iterator<char>(c)), std::istreambuf_iterator<char>());
+
+    return reloaded && invalid_kept && deferred && released && separate &&
+           text_a.find("first") != std::string::npos && text_a.find("hidden") == std::string::npos &&
+           text_a.find("second") == std::string::npos && text_b.find("[DEBUG] second") != std::string::npos &&
+           text_c.find("[DEBUG] [net] net debug") != std::string::npos &&
+           text_c.find("db debug") == std::string::npos && text_c.find("direct debug") == std::string::npos;
+}
+
+// Shared memory tests
+
+// Тест: Запись из другого процесса и пропуск ячеек (незахваченной и заполняемой), брошенных завершившимся производителем
+bool test_shm_ring()
+{
+    std::string name = "/logging_test_" + std::to_string(getpid());
+    ShmRing::unlink(name);
+    auto ring = ShmRing::open(name, 8, 128);
+    if (!ring)
+        return false;
+    ring->set_stall_timeout(std::chrono::milliseconds(20));
+
+    // Захват ячейки в обход push, как при сбое или остановке посреди записи:
+    // номер seq = WRITING | pid << 40 | позиция
+    auto claim_slot = [&name]()
+    {
+        int fd = shm_open(name.c_str(), O_RDWR, 0);
+        struct stat st{};
+        fstat(fd, &st);
+        char* base = static_cast<char*>(mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0));
+        close(fd);
+        auto* header = reinterpret_cast<ShmRingHeader*>(base);
+        uint64_t pos = header->head.fetch_add(1);
+        char* slot = base + ((sizeof(ShmRingHeader) + 63) & ~size_t(63)) + (pos % header->slots) * header->slot_size;
+        auto* seq = reinterpret_cast<std::atomic<uint64_t>*>(slot);
+        seq->store(uint64_t(1) << 63 | static_cast<uint64_t>(getpid()) << 40 | pos);
+        return std::make_pair(seq, pos);
+    };
+
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        auto logger = create_shm_logger(name);
+        logger->info("child msg");
+
+        // Резервирование ячейки без захвата, как при сбое посреди push
+        int fd = shm_open(name.c_str(), O_RDWR, 0);
+        struct stat st{};
+        fstat(fd, &st);
+        auto* header = static_cast<ShmRingHeader*>(mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0));
+        header->head.fetch_add(1);
+
+        claim_slot(); // Захват следующей ячейки и сбой до публикации
+        _exit(0);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+
+    ShmLogger logger(ShmRing::open(name), LogLevel::INFO);
+    logger.error("parent msg");
+    logger.debug("filtered");
+
+    std::vector<std::string> msgs;
+    auto handler = [&msgs](const ShmRecord& record) { msgs.emplace_back(record.msg); };
+    size_t before_stall = ring->drain(handler);
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    size_t after_stall = ring->drain(handler); // Незахваченная пропущена, заполняемая только замечена
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    size_t after_dead = ring->drain(handler);  // Заполняемая процессом, которого уже нет
+
+    // Заполняемая живым процессом не пропускается, сколько бы ни длилась запись
+    auto [live_seq, live_pos] = claim_slot();
+    size_t live_stall = ring->drain(handler);
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    live_stall += ring->drain(handler);
+    live_seq->store(live_pos + 1); // Публикация (пустая запись)
+    size_t live_done = ring->drain(handler);
+
+    // Переполнение не блокирует производителя
+    std::string long_msg(300, 'x');
+    size_t accepted = 0;
+    for (int i = 0; i < 10; ++i)
+        accepted += logger.log(long_msg, LogLevel::INFO) == LoggerError::NONE;
+    size_t truncated = 0;
+    ring->drain([&truncated](const ShmRecord& record) { truncated += record.truncated; });
+
+    ShmRing::unlink(name);
+    return before_stall == 1 && after_stall == 0 && after_dead == 1 && live_stall == 0 && live_done == 1 &&
+           msgs.size() == 3 && msgs[0] == "child msg" && msgs[1] == "parent msg" && msgs[2].empty() &&
+           ring->get_skipped() == 2 && accepted == 8 &&
+           ring->get_dropped() == 2 && truncated == 8;
+}
+
+// Lock profiling tests
+
+// Тест: Учет захватов и ожиданий мьютекса
+bool test_lock_profiler()
+{
+    ProfiledMutex first("test::mutex"), second("test::mutex"); // Одно место - общая статистика
+    lock_profile_reset();
+
+    const int thread_cnt = 4, iterations = 2000;
+    uint64_t counter = 0;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < thread_cnt; ++i)
+    {
+        threads.emplace_back([&]()
+        {
+            for (int j = 0; j < iterations; ++j)
+            {
+                std::lock_guard<ProfiledMutex> lock(first);
+                ++counter;
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    second.lock();
+    bool busy = !second.try_lock(); // Неудачная попытка не считается захватом
+    second.unlock();
+
+    const LockStats* stats = lock_profile_find("test::mutex");
+    uint64_t in_histogram = 0;
+    for (const auto& count : stats->histogram)
+        in_histogram += count;
+
+    std::stringstream report;
+    lock_profile_report(report);
+
+    return busy && counter == thread_cnt * iterations && stats == &first.get_stats() &&
+           stats->acquisitions == thread_cnt * iterations + 1 && in_histogram == stats->contended &&
+           report.str().find("test::mutex: захватов 8001") != std::string::npos;
+}
+
 // Главная функция тестирования
 int main()
 {
@@ -169,11 +1447,40 @@ int main()
     print("Фильтрация по уровню", test_file_level());
     print("Формат сообщения", test_file_format());
     print("Многопоточность", test_file_multithreaded());
+    print("Индекс журнала", test_file_index());
+    print("Двоичный формат", test_file_binary());
+    print("Блочное сжатие", test_file_compression());
+    print("Структурированные записи", test_file_structured());
+    print("Контекст потока", test_file_context());
+    print("Шаблоны строк", test_file_layout());
+    print("Запись через io_uring", test_file_uring());
+    print("Буферы потоков", test_file_staging());
+    print("Подавление повторов", test_file_dedup());
+    print("Самописец", test_flight_recorder());
+    print("Такты TscClock", test_tsc_clock());
 
     std::cout << "\nТесты SocketLogger: " << std::endl;
     print("Создание объекта", test_socket_create());
     print("Фильтрация по уровню", test_socket_level());
     print("Неверное подключение", test_socket_invalid_connection());
+    print("Фоновое подключение", test_socket_async());
+    print("Несколько получателей", test_socket_multi());
+    print("Разрыв посреди отправки", test_socket_partial());
+    print("Пересылка с сохраненной позиции", test_forward_resume());
+    print("Пересылка при ротации", test_forward_rotation());
+
+    std::cout << "\nТесты ограничения частоты: " << std::endl;
+    print("Выборка и корзина токенов", test_rate_limit());
+
+    std::cout << "\nТесты категорий: " << std::endl;
+    print("Наследование уровней", test_categories());
+    print("Перезагрузка конфигурации", test_config_reload());
+
+    std::cout << "\nТесты разделяемой памяти: " << std::endl;
+    print("Кольцо ShmRing", test_shm_ring());
+
+    std::cout << "\nТесты профилирования блокировок: " << std::endl;
+    print("Статистика мьютекса", test_lock_profiler());
 
     clean(); // Очищаем тестовые файлы
     return 0;
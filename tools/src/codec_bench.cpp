@@ -0,0 +1,73 @@
+#include "block_codec.h"
+#include "logger.h"
+#include <random>
+#include <vector>
+
+// Реалистичные данные журнала: типичные шаблоны с переменными числами и идентификаторами
+std::string make_log_data(size_t size)
+{
+    static const char* templates[] =
+    {
+        "GET /api/v1/users/%u HTTP/1.1 200 %ums",
+        "connection from 10.0.%u.%u accepted",
+        "request %u processed in %u us",
+        "cache miss for key session:%u:%u",
+        "retrying upstream call, attempt %u of %u",
+        "user %u logged in from 192.168.%u.1"
+    };
+    const LogLevel levels[] = {LogLevel::DEBUG, LogLevel::INFO, LogLevel::INFO, LogLevel::ERROR};
+
+    std::mt19937 rng(7);
+    std::string data;
+    char msg[256];
+    auto time = std::chrono::system_clock::now();
+    while (data.size() < size)
+    {
+        const char* pattern = templates[rng() % 6];
+        std::snprintf(msg, sizeof(msg), pattern, static_cast<unsigned>(rng() % 100000), static_cast<unsigned>(rng() % 1000));
+        data += Logger::msg_format(levels[rng() % 4], msg, time);
+        data.push_back('\n');
+        time += std::chrono::milliseconds(rng() % 50);
+    }
+    data.resize(size);
+    return data;
+}
+
+int main()
+{
+    const size_t total = 64 << 20; // 64 МБ входных данных
+    std::string data = make_log_data(total);
+
+    std::cout << "Блок     Сжатие   Сжатие МБ/с   Распаковка МБ/с" << std::endl;
+    for (size_t block_size : {16 << 10, 64 << 10, 256 << 10, 1 << 20})
+    {
+        std::string compressed;
+        compressed.reserve(total);
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t pos = 0; pos < total; pos += block_size)
+            compress_block(data.data() + pos, std::min(block_size, total - pos), compressed);
+        double compress_sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::string restored;
+        restored.reserve(total);
+        start = std::chrono::steady_clock::now();
+        size_t pos = 0;
+        while (pos < compressed.size() && decompress_block(compressed.data(), compressed.size(), pos, restored))
+            ;
+        double decompress_sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        if (restored != data)
+        {
+            std::cerr << "Ошибка: данные после распаковки не совпадают" << std::endl;
+            return 1;
+        }
+
+        double mb = total / (1024.0 * 1024.0);
+        std::cout << std::setw(6) << (block_size >> 10) << "K  "
+                  << std::fixed << std::setprecision(2) << std::setw(6) << double(total) / compressed.size() << "x  "
+                  << std::setw(12) << mb / compress_sec << "  "
+                  << std::setw(16) << mb / decompress_sec << std::endl;
+    }
+    return 0;
+}
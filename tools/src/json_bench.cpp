@@ -0,0 +1,169 @@
+#include "structured_log.h"
+#include <random>
+#include <vector>
+
+// Длина корректной последовательности UTF-8 (0 - некорректная)
+size_t utf8_length(std::string_view str, size_t i)
+{
+    auto byte = [&](size_t k) { return i + k < str.size() ? static_cast<unsigned char>(str[i + k]) : 0; };
+    auto cont = [&](size_t k) { return (byte(k) & 0xC0) == 0x80; };
+    unsigned char c = byte(0);
+
+    if (c >= 0xC2 && c <= 0xDF)
+        return cont(1) ? 2 : 0;
+    if (c >= 0xE0 && c <= 0xEF)
+        return cont(1) && cont(2) && !(c == 0xE0 && byte(1) < 0xA0) && !(c == 0xED && byte(1) >= 0xA0) ? 3 : 0;
+    if (c >= 0xF0 && c <= 0xF4)
+        return cont(1) && cont(2) && cont(3) && !(c == 0xF0 && byte(1) < 0x90) &&
+               !(c == 0xF4 && byte(1) >= 0x90) ? 4 : 0;
+    return 0;
+}
+
+// Побайтовое экранирование без SIMD: эталон для проверки и сравнения скорости
+void json_escape_scalar(std::string_view str, std::string& out)
+{
+    static const char hex[] = "0123456789abcdef";
+    for (size_t i = 0; i < str.size(); ++i)
+    {
+        unsigned char c = str[i];
+        if (c >= 0x80)
+        {
+            size_t len = utf8_length(str, i);
+            if (len == 0)
+                out += "\\ufffd";
+            else
+            {
+                out.append(str.substr(i, len));
+                i += len - 1;
+            }
+            continue;
+        }
+        switch (c)
+        {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            case '\b': out += "\\b"; break;
+            case '\f': out += "\\f"; break;
+            default:
+                if (c < 0x20)
+                {
+                    out += "\\u00";
+                    out += hex[c >> 4];
+                    out += hex[c & 0xF];
+                }
+                else
+                    out += static_cast<char>(c);
+        }
+    }
+}
+
+// Сообщения разного вида: ASCII, с кавычками и управляющими символами, кириллица
+std::vector<std::string> make_messages(size_t count)
+{
+    static const char* templates[] =
+    {
+        "GET /api/v1/users/%u HTTP/1.1 200 %ums",
+        "request %u failed: upstream returned \"%u Service Unavailable\"\n\tat handler",
+        "пользователь %u вошел в систему с адреса 192.168.%u.1",
+        "cache miss for key session:%u:%u, falling back to database lookup after timeout"
+    };
+
+    std::mt19937 rng(7);
+    std::vector<std::string> msgs;
+    char msg[256];
+    for (size_t i = 0; i < count; ++i)
+    {
+        std::snprintf(msg, sizeof(msg), templates[i % 4], static_cast<unsigned>(rng() % 100000),
+                      static_cast<unsigned>(rng() % 1000));
+        msgs.emplace_back(msg);
+    }
+    return msgs;
+}
+
+template<typename Func>
+double measure(size_t rounds, Func func)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < rounds; ++i)
+        func();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main()
+{
+    const size_t count = 1 << 16, rounds = 20;
+    std::vector<std::string> msgs = make_messages(count);
+    size_t bytes = 0;
+    for (const auto& msg : msgs)
+        bytes += msg.size();
+
+    // Проверка совпадения результатов перед замером
+    for (const auto& msg : msgs)
+    {
+        std::string fast, slow;
+        json_escape(msg, fast);
+        json_escape_scalar(msg, slow);
+        if (fast != slow)
+        {
+            std::cerr << "Ошибка: результаты экранирования различаются для " << msg << std::endl;
+            return 1;
+        }
+    }
+
+    std::string out;
+    out.reserve(bytes * 2);
+    auto time = std::chrono::system_clock::now();
+    size_t sink = 0; // Не дает компилятору выбросить вычисления
+
+    double escape_scalar = measure(rounds, [&]
+    {
+        for (const auto& msg : msgs) { out.clear(); json_escape_scalar(msg, out); sink += out.size(); }
+    });
+    double escape_fast = measure(rounds, [&]
+    {
+        for (const auto& msg : msgs) { out.clear(); json_escape(msg, out); sink += out.size(); }
+    });
+    double text = measure(rounds, [&]
+    {
+        for (const auto& msg : msgs) { sink += Logger::msg_format(LogLevel::INFO, msg, time).size(); }
+    });
+    double text_fields = measure(rounds, [&]
+    {
+        for (const auto& msg : msgs)
+        {
+            out.clear();
+            format_text_fields(StructuredRecord(msg, LogLevel::INFO, time)
+                .add("status", 200).add("ms", 12.5).add("user", "root"), out);
+            sink += Logger::msg_format(LogLevel::INFO, out, time).size();
+        }
+    });
+    double json = measure(rounds, [&]
+    {
+        for (const auto& msg : msgs)
+        {
+            out.clear();
+            encode_json(StructuredRecord(msg, LogLevel::INFO, time)
+                .add("status", 200).add("ms", 12.5).add("user", "root"), out);
+            sink += out.size();
+        }
+    });
+
+    double records = static_cast<double>(count * rounds);
+    double mb = static_cast<double>(bytes * rounds) / (1 << 20);
+    auto report = [&](const char* name, double sec)
+    {
+        std::cout << std::fixed << std::setprecision(1) << std::setw(8) << records / sec / 1e6 << " млн/с"
+                  << std::setw(10) << mb / sec << " МБ/с   " << name << std::defaultfloat << std::endl;
+    };
+
+    report("json_escape (побайтово)", escape_scalar);
+    report("json_escape (SSE2)", escape_fast);
+    report("msg_format (текст)", text);
+    report("msg_format + поля key=value", text_fields);
+    report("encode_json (3 поля)", json);
+    std::cerr << "(" << sink << ")" << std::endl;
+    return 0;
+}
@@ -0,0 +1,67 @@
+#include "pattern_layout.h"
+#include <iomanip>
+#include <vector>
+
+template<typename Func>
+double measure(size_t rounds, Func func)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < rounds; ++i)
+        func();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main()
+{
+    const size_t count = 1 << 16, rounds = 20;
+    std::vector<std::string> msgs;
+    for (size_t i = 0; i < count; ++i)
+        msgs.push_back("GET /api/v1/users/" + std::to_string(i * 7919 % 100000) + " HTTP/1.1 200");
+
+    std::unique_ptr<PatternLayout> standard = PatternLayout::compile(PatternLayout::DEFAULT_PATTERN);
+    std::unique_ptr<PatternLayout> custom = PatternLayout::compile("%d{ISO8601} %t %l %c: %m%X", "bench");
+
+    // Стандартный макет должен давать ту же строку, что и msg_format
+    auto time = std::chrono::system_clock::now();
+    std::string out;
+    standard->format(LayoutRecord{LogLevel::INFO, msgs[0], time}, out);
+    if (out != Logger::msg_format(LogLevel::INFO, msgs[0], time))
+    {
+        std::cerr << "Ошибка: DefaultLayout и msg_format различаются: " << out << std::endl;
+        return 1;
+    }
+
+    out.reserve(256);
+    size_t sink = 0; // Не дает компилятору выбросить вычисления
+
+    double fixed = measure(rounds, [&]
+    {
+        for (const auto& msg : msgs) { sink += Logger::msg_format(LogLevel::INFO, msg, time).size(); }
+    });
+    double specialized = measure(rounds, [&]
+    {
+        for (const auto& msg : msgs) { out.clear(); standard->format(LayoutRecord{LogLevel::INFO, msg, time}, out); sink += out.size(); }
+    });
+    double steps = measure(rounds, [&]
+    {
+        for (const auto& msg : msgs) { out.clear(); custom->format(LayoutRecord{LogLevel::INFO, msg, time}, out); sink += out.size(); }
+    });
+    double direct = measure(rounds, [&]
+    {
+        for (const auto& msg : msgs) { out.clear(); IsoLayout::format(LayoutRecord{LogLevel::INFO, msg, time}, out); sink += out.size(); }
+    });
+
+    double records = static_cast<double>(count * rounds);
+    auto report = [&](const char* name, double sec)
+    {
+        std::cout << std::fixed << std::setprecision(1) << std::setw(8) << records / sec / 1e6 << " млн/с"
+                  << std::setw(8) << sec * 1e9 / records << " нс   " << name << std::defaultfloat << std::endl;
+    };
+
+    report("msg_format", fixed);
+    report("PatternLayout \"[%d] [%l] %m%X\" (DefaultLayout)", specialized);
+    report("PatternLayout \"%d{ISO8601} %t %l %c: %m%X\" (шаги)", steps);
+    report("IsoLayout (без PatternLayout)", direct);
+    std::cerr << "(" << sink << ")" << std::endl;
+    return 0;
+}
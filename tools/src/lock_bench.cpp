@@ -0,0 +1,121 @@
+#include "file_logger.h"
+#include "lock_profiler.h"
+#include "lane_queue.h"
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+// Сценарий: threads потоков выполняют по per_thread операций; возвращает время в секундах
+template<typename Func>
+double run_threads(int threads, Func func)
+{
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; ++t)
+        workers.emplace_back(func, t);
+    for (auto& worker : workers)
+        worker.join();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Строка таблицы: пропускная способность и данные профиля мьютекса
+void print_row(int threads, size_t ops, double sec, const char* lock_name)
+{
+    std::cout << std::setw(7) << threads << std::setw(14) << static_cast<size_t>(ops / sec);
+
+    const LockStats* stats = lock_profile_find(lock_name);
+    if (stats && stats->acquisitions > 0)
+    {
+        uint64_t total = stats->acquisitions, contended = stats->contended;
+        std::cout << std::fixed << std::setprecision(1) << std::setw(12) << 100.0 * contended / total << "%"
+                  << std::setw(14) << (contended ? stats->wait_ns / contended / 1000.0 : 0.0)
+                  << std::setw(14) << stats->max_wait_ns / 1000.0 << std::defaultfloat;
+    }
+    std::cout << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    const size_t total = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000; // Операций на точку
+    const int counts[] = {1, 2, 4, 8, 16, 32, 64};
+    const char* file_name = "lock_bench.log";
+
+#ifndef LOGGING_LOCK_PROFILING
+    std::cout << "Профилирование выключено (соберите с -DLOGGING_LOCK_PROFILING=ON), "
+                 "выводится только пропускная способность" << std::endl;
+#endif
+
+    std::cout << "\nFileLogger::log_mutex: запись из нескольких потоков" << std::endl;
+    std::cout << "Потоки    Записей/с   С ожиданием  Среднее, мкс    Макс, мкс" << std::endl;
+    for (int threads : counts)
+    {
+        std::remove(file_name);
+        FileLogger logger(file_name, LogLevel::INFO);
+        lock_profile_reset();
+
+        size_t per_thread = total / threads;
+        double sec = run_threads(threads, [&](int t)
+        {
+            std::string msg = "thread " + std::to_string(t) + " message";
+            for (size_t i = 0; i < per_thread; ++i)
+                logger.info(msg);
+        });
+        print_row(threads, per_thread * threads, sec, "FileLogger::log_mutex");
+    }
+    std::remove(file_name);
+
+    // Буферы потоков (enable_staging): общий мьютекс берется только при слиянии
+    std::cout << "\nFileLogger с буферами потоков: запись из нескольких потоков" << std::endl;
+    std::cout << "Потоки    Записей/с   С ожиданием  Среднее, мкс    Макс, мкс" << std::endl;
+    for (int threads : counts)
+    {
+        std::remove(file_name);
+        lock_profile_reset();
+
+        size_t per_thread = total / threads;
+        double sec = 0;
+        {
+            FileLogger logger(file_name, LogLevel::INFO);
+            logger.enable_staging();
+            sec = run_threads(threads, [&](int t)
+            {
+                std::string msg = "thread " + std::to_string(t) + " message";
+                for (size_t i = 0; i < per_thread; ++i)
+                    logger.info(msg);
+            });
+        }
+        print_row(threads, per_thread * threads, sec, "FileLogger::staging");
+    }
+    std::remove(file_name);
+
+    std::cout << "\nLaneQueue::curr_mutex: производители и один потребитель" << std::endl;
+    std::cout << "Потоки  Сообщений/с   С ожиданием  Среднее, мкс    Макс, мкс" << std::endl;
+    for (int threads : counts)
+    {
+        LaneQueue<std::string, 3> queue;
+        lock_profile_reset();
+
+        size_t per_thread = total / threads;
+        std::thread consumer([&queue]
+        {
+            std::string value;
+            size_t lane;
+            while (queue.pop_with_wait(value, lane) || !queue.empty())
+                ;
+        });
+        double sec = run_threads(threads, [&](int t)
+        {
+            for (size_t i = 0; i < per_thread; ++i)
+                queue.push(i % 3, "thread " + std::to_string(t));
+        });
+        queue.stop();
+        consumer.join();
+        print_row(threads, per_thread * threads, sec, "LaneQueue::curr_mutex");
+    }
+
+#ifdef LOGGING_LOCK_PROFILING
+    std::cout << "\nПолный отчет (последняя точка):" << std::endl;
+    lock_profile_report(std::cout);
+#endif
+    return 0;
+}
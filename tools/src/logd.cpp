@@ -0,0 +1,150 @@
+#include "shm_ring.h"
+#include "file_logger.h"
+#include "log_config.h"
+#include <csignal>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    std::atomic<bool> stop_flag{false};
+
+    void on_signal(int)
+    {
+        stop_flag = true;
+    }
+}
+
+// Вывод правил использования
+void print_rules()
+{
+    std::cerr << "Использование: logd [опции] (--file=<log.txt> | --config=<file.conf>) <ring>..." << std::endl;
+    std::cerr << "  --slots=N       - число ячеек нового кольца (по умолчанию 16384)" << std::endl;
+    std::cerr << "  --slot-size=B   - размер ячейки в байтах (по умолчанию 512)" << std::endl;
+    std::cerr << "  --stall=MS      - ожидание незавершенной записи (по умолчанию 500)" << std::endl;
+    std::cerr << "Кольца (\"/app\") создаются, если их нет; процессы пишут в них через ShmLogger" << std::endl;
+}
+
+// Разбор опции вида --name=value
+bool parse_option(const std::string& arg, const std::string& name, std::string& value)
+{
+    std::string prefix = "--" + name + "=";
+    if (arg.compare(0, prefix.size(), prefix) != 0)
+        return false;
+
+    value = arg.substr(prefix.size());
+    return true;
+}
+
+// Поток одного кольца: чтение пачками, сон на futex при пустом кольце
+void drain_ring(ShmRing& ring, Logger& sink)
+{
+    uint64_t dropped = ring.get_dropped(), skipped = ring.get_skipped();
+    auto handler = [&sink](const ShmRecord& record)
+    {
+        std::chrono::system_clock::time_point time{std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            std::chrono::nanoseconds(record.time_ns))};
+        std::string msg(record.msg);
+        if (record.truncated)
+            msg += "...";
+        sink.log_at(msg, record.level, time);
+    };
+
+    while (true)
+    {
+        bool stopping = stop_flag;
+        size_t count = ring.drain(handler, 4096);
+
+        // Потери видны в самом журнале
+        uint64_t curr_dropped = ring.get_dropped(), curr_skipped = ring.get_skipped();
+        if (curr_dropped != dropped || curr_skipped != skipped)
+        {
+            sink.error("logd: кольцо " + ring.get_name() + ": отброшено записей " +
+                       std::to_string(curr_dropped - dropped) + ", пропущено незавершенных " +
+                       std::to_string(curr_skipped - skipped));
+            dropped = curr_dropped;
+            skipped = curr_skipped;
+        }
+
+        if (stopping && count == 0)
+            break;
+        if (count == 0)
+            ring.wait(std::chrono::milliseconds(100));
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    size_t slots = 16384, slot_size = 512;
+    std::chrono::milliseconds stall(500);
+    std::string file, config;
+    std::vector<std::string> names;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i], value;
+        if (parse_option(arg, "slots", value))
+            slots = std::strtoull(value.c_str(), nullptr, 10);
+        else if (parse_option(arg, "slot-size", value))
+            slot_size = std::strtoull(value.c_str(), nullptr, 10);
+        else if (parse_option(arg, "stall", value))
+            stall = std::chrono::milliseconds(std::atoi(value.c_str()));
+        else if (parse_option(arg, "file", value))
+            file = value;
+        else if (parse_option(arg, "config", value))
+            config = value;
+        else if (arg.compare(0, 2, "--") == 0)
+        {
+            std::cerr << "Ошибка: неизвестная опция " << arg << std::endl;
+            print_rules();
+            return 1;
+        }
+        else
+            names.push_back(arg);
+    }
+
+    if (names.empty() || file.empty() == config.empty())
+    {
+        print_rules();
+        return 1;
+    }
+
+    // Приемник: файл или логгер по конфигурации (с перечитыванием при изменении)
+    std::unique_ptr<Logger> sink;
+    if (!config.empty())
+        sink = create_config_logger(config);
+    else
+        sink = create_file_logger(file, LogLevel::DEBUG);
+    if (!sink)
+    {
+        std::cerr << "Ошибка: не удалось создать приемник" << std::endl;
+        return 1;
+    }
+
+    std::vector<std::unique_ptr<ShmRing>> rings;
+    for (const auto& name : names)
+    {
+        auto ring = ShmRing::open(name, slots, slot_size);
+        if (!ring)
+        {
+            std::cerr << "Ошибка: не удалось открыть кольцо " << name << std::endl;
+            return 1;
+        }
+        ring->set_stall_timeout(stall);
+        rings.push_back(std::move(ring));
+    }
+
+    std::signal(SIGINT, on_signal);
+    std::signal(SIGTERM, on_signal);
+
+    std::vector<std::thread> threads;
+    for (auto& ring : rings)
+        threads.emplace_back(drain_ring, std::ref(*ring), std::ref(*sink));
+    for (auto& thread : threads)
+        thread.join();
+
+    for (const auto& ring : rings)
+        std::cerr << ring->get_name() << ": отброшено " << ring->get_dropped()
+                  << ", пропущено " << ring->get_skipped() << std::endl;
+    return 0;
+}
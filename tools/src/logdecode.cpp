@@ -0,0 +1,56 @@
+#include "binary_log.h"
+#include <cstdio>
+
+// Вывод правил использования
+void print_rules()
+{
+    std::cerr << "Использование: logdecode <log.bin> [out.txt]" << std::endl;
+    std::cerr << "Преобразует журнал BinaryFileLogger в текстовый формат FileLogger" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        print_rules();
+        return 1;
+    }
+
+    std::ifstream in(argv[1], std::ios::binary);
+    if (!in.is_open())
+    {
+        std::cerr << "Ошибка: не удалось открыть " << argv[1] << std::endl;
+        return 1;
+    }
+
+    std::ofstream out_file;
+    if (argc >= 3)
+    {
+        out_file.open(argv[2], std::ios::out | std::ios::trunc);
+        if (!out_file.is_open())
+        {
+            std::cerr << "Ошибка: не удалось открыть " << argv[2] << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = argc >= 3 ? out_file : std::cout;
+
+    BinaryLogDecoder decoder(in);
+    BinaryLogRecord record;
+    size_t count = 0;
+    while (decoder.next(record))
+    {
+        std::chrono::system_clock::time_point time{
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(record.time_ns))};
+        out << Logger::msg_format(record.level, record.msg, time) << '\n';
+        ++count;
+    }
+    out.flush();
+
+    if (decoder.failed())
+    {
+        std::cerr << "Ошибка: поврежденные данные после записи " << count << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,112 @@
+#include "log_forwarder.h"
+#include <csignal>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    LogForwarder* active = nullptr; // Для обработчика сигнала
+
+    void on_signal(int)
+    {
+        if (active)
+            active->stop();
+    }
+}
+
+// Вывод правил использования
+void print_rules()
+{
+    std::cerr << "Использование: logforward [опции] <log.txt> (<host>:<port> | unix:<path>)" << std::endl;
+    std::cerr << "  --checkpoint=<file> - файл позиции (по умолчанию <log.txt>.fwd)" << std::endl;
+    std::cerr << "  --tail              - без сохраненной позиции начинать с конца файла" << std::endl;
+    std::cerr << "  --retry=MS          - пауза перед повторным подключением (по умолчанию 1000)" << std::endl;
+    std::cerr << "  --timeout=MS        - ожидание одной попытки подключения (по умолчанию 3000)" << std::endl;
+    std::cerr << "  --once              - переслать имеющиеся данные и завершиться" << std::endl;
+    std::cerr << "Дописываемые байты пересылаются через sendfile; позиция переживает перезапуск и ротацию" << std::endl;
+}
+
+// Разбор опции вида --name=value
+bool parse_option(const std::string& arg, const std::string& name, std::string& value)
+{
+    std::string prefix = "--" + name + "=";
+    if (arg.compare(0, prefix.size(), prefix) != 0)
+        return false;
+
+    value = arg.substr(prefix.size());
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    ForwardOptions options;
+    std::chrono::milliseconds retry(1000);
+    bool once = false;
+    std::vector<std::string> args;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i], value;
+        if (parse_option(arg, "checkpoint", value))
+            options.checkpoint = value;
+        else if (parse_option(arg, "retry", value))
+            retry = std::chrono::milliseconds(std::atoi(value.c_str()));
+        else if (parse_option(arg, "timeout", value))
+            options.connect_timeout = std::chrono::milliseconds(std::atoi(value.c_str()));
+        else if (arg == "--tail")
+            options.tail = true;
+        else if (arg == "--once")
+            once = true;
+        else if (arg.compare(0, 2, "--") == 0)
+        {
+            std::cerr << "Ошибка: неизвестная опция " << arg << std::endl;
+            print_rules();
+            return 1;
+        }
+        else
+            args.push_back(arg);
+    }
+
+    if (args.size() != 2)
+    {
+        print_rules();
+        return 1;
+    }
+
+    LogForwarder forwarder(args[0], args[1], options);
+    if (forwarder.init() != LoggerError::NONE)
+        return 1;
+
+    // Сигналы прерывают ожидание poll и sendfile (без SA_RESTART)
+    active = &forwarder;
+    struct sigaction action{};
+    action.sa_handler = on_signal;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+    std::signal(SIGPIPE, SIG_IGN); // Разрыв соединения - ошибка sendfile, а не завершение процесса
+
+    while (!forwarder.stopped())
+    {
+        if (forwarder.step(once) == LoggerError::WRITE_FAILED)
+        {
+            std::cerr << "Повтор через " << retry.count() << " мс" << std::endl;
+            for (auto end = std::chrono::steady_clock::now() + retry;
+                 !forwarder.stopped() && std::chrono::steady_clock::now() < end;)
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            continue;
+        }
+
+        // После ротации новый файл открывается сразу, без ожидания событий
+        if (forwarder.has_rotated())
+            continue;
+        if (once && !forwarder.is_draining())
+            break;
+        if (!once)
+            forwarder.wait(std::chrono::milliseconds(1000));
+    }
+
+    forwarder.save();
+    active = nullptr;
+    std::cerr << "Переслано байт: " << forwarder.get_sent() << std::endl;
+    return 0;
+}
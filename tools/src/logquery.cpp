@@ -0,0 +1,102 @@
+#include "log_index.h"
+#include "log_parser.h"
+#include "mapped_file.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+// Вывод правил использования
+void print_rules()
+{
+    std::cerr << "Использование: logquery <log.txt> <from> <to> [level]" << std::endl;
+    std::cerr << "  from, to - время в формате \"YYYY-MM-DD HH:MM:SS\"" << std::endl;
+    std::cerr << "  level    - минимальный уровень: DEBUG, INFO, ERROR" << std::endl;
+    std::cerr << "Журнал - в текстовом формате или JSON Lines (LogFormat::JSON)" << std::endl;
+    std::cerr << "Индекс <log.txt>.idx создается FileLogger::enable_index" << std::endl;
+}
+
+// Вывод подходящих строк из участка журнала [begin, end)
+size_t scan(const char* begin, const char* end, std::time_t from, std::time_t to, LogLevel level)
+{
+    size_t found = 0;
+    LogRecord record;
+    while (begin < end)
+    {
+        const char* nl = static_cast<const char*>(std::memchr(begin, '\n', end - begin));
+        const char* line_end = nl ? nl : end;
+
+        std::string_view line(begin, line_end - begin);
+        if (parse_log_line(line, record) && record.time >= from && record.time <= to && record.level >= level)
+        {
+            std::fwrite(line.data(), 1, line.size(), stdout);
+            std::fputc('\n', stdout);
+            ++found;
+        }
+        begin = line_end + 1;
+    }
+    return found;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 4)
+    {
+        print_rules();
+        return 1;
+    }
+
+    std::string log_name = argv[1];
+    std::time_t from, to;
+    if (!parse_log_time(argv[2], from) || !parse_log_time(argv[3], to))
+    {
+        std::cerr << "Ошибка: некорректное время" << std::endl;
+        print_rules();
+        return 1;
+    }
+
+    LogLevel level = LogLevel::DEBUG;
+    if (argc >= 5 && !parse_level_name(argv[4], level))
+    {
+        std::cerr << "Ошибка: некорректный уровень" << std::endl;
+        return 1;
+    }
+
+    MappedFile log;
+    if (!log.open(log_name))
+    {
+        std::cerr << "Ошибка: не удалось открыть " << log_name << std::endl;
+        return 1;
+    }
+
+    LogIndex index;
+    bool has_index = index.open(log_name + ".idx");
+    if (!has_index)
+        std::cerr << "Индекс не найден, выполняется полный просмотр" << std::endl;
+
+    // Участки для просмотра: подходящие блоки индекса и части журнала вне индекса
+    // (до его включения, запуски без индекса, хвост). Просмотр - в порядке файла
+    std::vector<std::pair<uint64_t, uint64_t>> ranges = index.uncovered(log.size());
+    auto [first, last] = index.find_range(from, to);
+    for (size_t i = first; i < last; ++i)
+    {
+        const LogIndexEntry& entry = index.begin()[i];
+        if (entry.offset + entry.length > log.size())
+            break; // Индекс не соответствует файлу (журнал усечен)
+        if (LogIndex::has_level(entry, level))
+            ranges.emplace_back(entry.offset, entry.offset + entry.length);
+    }
+    std::sort(ranges.begin(), ranges.end());
+
+    const char* data = log.data();
+    size_t found = 0, scanned = 0;
+    for (auto [begin, end] : ranges)
+    {
+        found += scan(data + begin, data + end, from, to, level);
+        scanned += end - begin;
+    }
+
+    std::fflush(stdout);
+    std::cerr << "Найдено записей: " << found << ", просмотрено байт: " << scanned
+              << " из " << log.size() << std::endl;
+    return 0;
+}
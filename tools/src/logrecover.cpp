@@ -0,0 +1,52 @@
+#include "flight_recorder.h"
+
+// Вывод правил использования
+void print_rules()
+{
+    std::cerr << "Использование: logrecover <ring file> [out.txt]" << std::endl;
+    std::cerr << "Извлекает записи самописца (--flight) в порядке их поступления" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        print_rules();
+        return 1;
+    }
+
+    std::vector<RecoveredRecord> records;
+    if (!FlightRecorder::recover(argv[1], records))
+    {
+        std::cerr << "Ошибка: " << argv[1] << " не является файлом самописца" << std::endl;
+        return 1;
+    }
+
+    std::ofstream out_file;
+    if (argc >= 3)
+    {
+        out_file.open(argv[2], std::ios::out | std::ios::trunc);
+        if (!out_file.is_open())
+        {
+            std::cerr << "Ошибка: не удалось открыть " << argv[2] << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = argc >= 3 ? out_file : std::cout;
+
+    // Пропуски в номерах означают записи, перезаписанные кольцом или не завершенные при сбое
+    uint64_t gaps = 0;
+    for (size_t i = 0; i < records.size(); ++i)
+    {
+        if (i > 0 && records[i].seq != records[i - 1].seq + 1)
+            gaps++;
+
+        std::chrono::system_clock::time_point time{std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            std::chrono::nanoseconds(records[i].time_ns))};
+        out << Logger::msg_format(records[i].level, records[i].msg, time) << '\n';
+    }
+    out.flush();
+
+    std::cerr << "Восстановлено записей: " << records.size() << ", разрывов: " << gaps << std::endl;
+    return 0;
+}
@@ -0,0 +1,247 @@
+#include "log_parser.h"
+#include "mapped_file.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+// Параметры поиска
+struct SearchOptions
+{
+    std::string pattern;      // Подстрока (пустая - любая строка)
+    std::string time_prefix;  // Префикс метки времени, например "2024-01-15 14:3"
+    LogLevel level = LogLevel::DEBUG; // Минимальный уровень
+    bool has_level = false;
+    bool count_only = false;  // Выводить только количество совпадений
+};
+
+// Участок файла, выровненный по границам строк
+struct Chunk
+{
+    const char* begin;
+    const char* end;
+    std::string output{}; // Найденные строки
+    size_t found = 0;
+    bool done = false;
+};
+
+// Вывод правил использования
+void print_rules()
+{
+    std::cerr << "Использование: logsearch [опции] <pattern> <file>..." << std::endl;
+    std::cerr << "  --level=LEVEL   - минимальный уровень (DEBUG, INFO, ERROR)" << std::endl;
+    std::cerr << "  --time=PREFIX   - префикс времени, например \"2024-01-15 14:3\"" << std::endl;
+    std::cerr << "  --threads=N     - число потоков (по умолчанию - все ядра)" << std::endl;
+    std::cerr << "  --count         - только число совпадений" << std::endl;
+    std::cerr << "Пустой pattern (\"\") выбирает все строки, прошедшие фильтры" << std::endl;
+    std::cerr << "Журналы - в текстовом формате или JSON Lines (LogFormat::JSON)" << std::endl;
+}
+
+// Префикс метки времени в тексте ("[2024-01-15 14:3") или в JSON ({"time":"2024-01-15T14:3");
+// пробел префикса между датой и временем совпадает и с 'T'
+bool match_time_prefix(std::string_view line, std::string_view prefix)
+{
+    constexpr std::string_view json_key = "{\"time\":\"";
+    size_t start = 1;
+    if (!line.empty() && line[0] == '{' && line.substr(0, json_key.size()) == json_key)
+        start = json_key.size();
+    else if (line.empty() || line[0] != '[')
+        return false;
+    if (line.size() <= start + prefix.size())
+        return false;
+
+    for (size_t i = 0; i < prefix.size(); ++i)
+    {
+        char c = line[start + i];
+        if (c != prefix[i] && !(i == 10 && prefix[i] == ' ' && c == 'T'))
+            return false;
+    }
+    return true;
+}
+
+// Проверка фильтров по времени и уровню: фиксированный формат позволяет обойтись без regex
+bool match_filters(std::string_view line, const SearchOptions& options)
+{
+    if (!options.time_prefix.empty() && !match_time_prefix(line, options.time_prefix))
+        return false;
+
+    if (options.has_level)
+    {
+        LogLevel level;
+        if (!peek_log_level(line, level) || level < options.level)
+            return false;
+    }
+    return true;
+}
+
+void add_line(Chunk& chunk, std::string_view line, const SearchOptions& options)
+{
+    chunk.found++;
+    if (!options.count_only)
+    {
+        chunk.output.append(line.data(), line.size());
+        chunk.output.push_back('\n');
+    }
+}
+
+// Поиск в участке: при заданной подстроке ищем ее по всему участку через memmem
+// (векторизован в libc) и только затем определяем границы строки
+void search_chunk(Chunk& chunk, const SearchOptions& options)
+{
+    const char* curr = chunk.begin;
+    const char* end = chunk.end;
+
+    if (options.pattern.empty())
+    {
+        while (curr < end)
+        {
+            const char* nl = static_cast<const char*>(std::memchr(curr, '\n', end - curr));
+            const char* line_end = nl ? nl : end;
+            std::string_view line(curr, line_end - curr);
+            if (match_filters(line, options))
+                add_line(chunk, line, options);
+            curr = line_end + 1;
+        }
+        return;
+    }
+
+    while (curr < end)
+    {
+        const char* hit = static_cast<const char*>(
+            memmem(curr, end - curr, options.pattern.data(), options.pattern.size()));
+        if (!hit)
+            break;
+
+        // Границы строки, содержащей совпадение
+        const char* line_begin = hit;
+        while (line_begin > curr && line_begin[-1] != '\n')
+            --line_begin;
+        const char* nl = static_cast<const char*>(std::memchr(hit, '\n', end - hit));
+        const char* line_end = nl ? nl : end;
+
+        std::string_view line(line_begin, line_end - line_begin);
+        if (match_filters(line, options))
+            add_line(chunk, line, options);
+        curr = line_end + 1;
+    }
+}
+
+// Разбиение файла на участки, выровненные по '\n'
+void split_file(const MappedFile& file, size_t chunk_size, std::vector<Chunk>& chunks)
+{
+    const char* curr = file.data();
+    const char* end = file.data() + file.size();
+    while (curr < end)
+    {
+        const char* chunk_end = curr + std::min<size_t>(chunk_size, end - curr);
+        if (chunk_end < end)
+        {
+            const char* nl = static_cast<const char*>(std::memchr(chunk_end, '\n', end - chunk_end));
+            chunk_end = nl ? nl + 1 : end;
+        }
+        chunks.push_back(Chunk{curr, chunk_end});
+        curr = chunk_end;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    SearchOptions options;
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    int pos = 1;
+
+    for (; pos < argc && std::strncmp(argv[pos], "--", 2) == 0; ++pos)
+    {
+        std::string arg = argv[pos];
+        if (arg.compare(0, 8, "--level=") == 0)
+        {
+            if (!parse_level_name(arg.substr(8), options.level))
+            {
+                std::cerr << "Ошибка: некорректный уровень" << std::endl;
+                return 1;
+            }
+            options.has_level = true;
+        }
+        else if (arg.compare(0, 7, "--time=") == 0)
+            options.time_prefix = arg.substr(7);
+        else if (arg.compare(0, 10, "--threads=") == 0)
+            threads = std::max(1, std::atoi(arg.c_str() + 10));
+        else if (arg == "--count")
+            options.count_only = true;
+        else
+        {
+            print_rules();
+            return 1;
+        }
+    }
+
+    if (argc - pos < 2)
+    {
+        print_rules();
+        return 1;
+    }
+
+    options.pattern = argv[pos++];
+
+    // Отображение всех файлов и разбиение на участки
+    std::vector<MappedFile> files(argc - pos);
+    size_t total = 0;
+    for (size_t i = 0; i < files.size(); ++i)
+    {
+        if (!files[i].open(argv[pos + i]))
+        {
+            std::cerr << "Ошибка: не удалось открыть " << argv[pos + i] << std::endl;
+            return 1;
+        }
+        total += files[i].size();
+    }
+
+    // Участков в несколько раз больше, чем потоков, для балансировки нагрузки
+    size_t chunk_size = std::max<size_t>(1 << 20, total / (threads * 8) + 1);
+    std::vector<Chunk> chunks;
+    for (const auto& file : files)
+        split_file(file, chunk_size, chunks);
+
+    std::atomic<size_t> next{0};
+    std::mutex done_mutex;
+    std::condition_variable done_condition;
+    std::vector<std::thread> workers;
+
+    for (unsigned t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&]()
+        {
+            for (size_t i = next++; i < chunks.size(); i = next++)
+            {
+                search_chunk(chunks[i], options);
+                std::lock_guard<std::mutex> lock(done_mutex);
+                chunks[i].done = true;
+                done_condition.notify_all();
+            }
+        });
+    }
+
+    // Вывод результатов в порядке файлов по мере готовности участков
+    size_t found = 0;
+    for (auto& chunk : chunks)
+    {
+        {
+            std::unique_lock<std::mutex> lock(done_mutex);
+            done_condition.wait(lock, [&chunk] { return chunk.done; });
+        }
+        std::fwrite(chunk.output.data(), 1, chunk.output.size(), stdout);
+        found += chunk.found;
+        std::string().swap(chunk.output); // Освобождаем память сразу после вывода
+    }
+
+    for (auto& worker : workers)
+        worker.join();
+
+    if (options.count_only)
+        std::printf("%zu\n", found);
+    std::fflush(stdout);
+    return found > 0 ? 0 : 1; // Как grep: 1, если ничего не найдено
+}
@@ -0,0 +1,69 @@
+#include "block_codec.h"
+#include "mapped_file.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+// Вывод правил использования
+void print_rules()
+{
+    std::cerr << "Использование: logunpack [--skip=BYTES] <in> [out]" << std::endl;
+    std::cerr << "Распаковка журнала, сжатого FileLogger/SocketLogger::enable_compression" << std::endl;
+    std::cerr << "  --skip=BYTES - начать с первого блока после смещения BYTES" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t pos = 0;
+    int arg = 1;
+    if (arg < argc && std::strncmp(argv[arg], "--skip=", 7) == 0)
+        pos = std::strtoull(argv[arg++] + 7, nullptr, 10);
+
+    if (arg >= argc)
+    {
+        print_rules();
+        return 1;
+    }
+
+    MappedFile in;
+    if (!in.open(argv[arg]))
+    {
+        std::cerr << "Ошибка: не удалось открыть " << argv[arg] << std::endl;
+        return 1;
+    }
+
+    FILE* out = stdout;
+    if (arg + 1 < argc && !(out = std::fopen(argv[arg + 1], "wb")))
+    {
+        std::cerr << "Ошибка: не удалось открыть " << argv[arg + 1] << std::endl;
+        return 1;
+    }
+
+    // Блоки независимы: при повреждении переходим к следующей сигнатуре
+    std::string block;
+    size_t blocks = 0, damaged = 0, raw = 0;
+    pos = find_block(in.data(), in.size(), std::min(pos, in.size()));
+    while (pos < in.size())
+    {
+        block.clear();
+        if (!decompress_block(in.data(), in.size(), pos, block))
+        {
+            damaged++;
+            pos = find_block(in.data(), in.size(), pos + 1);
+            continue;
+        }
+        std::fwrite(block.data(), 1, block.size(), out);
+        raw += block.size();
+        blocks++;
+    }
+
+    if (out != stdout)
+        std::fclose(out);
+    else
+        std::fflush(out);
+
+    std::cerr << "Блоков: " << blocks << ", поврежденных: " << damaged
+              << ", байт: " << in.size() << " -> " << raw << std::endl;
+    return damaged == 0 ? 0 : 1;
+}